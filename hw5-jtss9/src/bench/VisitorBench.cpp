@@ -0,0 +1,222 @@
+// Times a full traversal of a large generated AST through the virtual
+// `accept()` of `AstNodeVisitor` against the switch of `StaticVisitor`.
+//
+// Usage: ./visitor-bench [number of statements] [number of traversals]
+
+#include "AST/TypeContext.hpp"
+#include "util/StringInterner.hpp"
+#include "visitor/AstNodeInclude.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/StaticVisitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+/// @brief Builds programs out of a rotation of assignments, `print`s, `if`s
+/// and `while`s over arithmetic on scalars and array elements.
+class AstGenerator {
+  private:
+    const Location m_location{0};
+    const PType *m_integer_type =
+        TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType);
+    IdentifierId m_names[4] = {StringInterner::identifiers().intern("a"),
+                               StringInterner::identifiers().intern("b"),
+                               StringInterner::identifiers().intern("c"),
+                               StringInterner::identifiers().intern("d")};
+
+    ExpressionNode *makeConstant(const int64_t p_value) {
+        Constant::ConstantValue value;
+        value.integer = p_value;
+        return new ConstantValueNode(m_location,
+                                     new Constant(m_integer_type, value));
+    }
+
+    VariableReferenceNode *makeReference(const size_t p_index) {
+        return new VariableReferenceNode(m_location, m_names[p_index % 4]);
+    }
+
+    /// @return `(a + 1) * -b - c[d]`, rotated over the names.
+    ExpressionNode *makeExpression(const size_t p_index) {
+        VariableReferenceNode::ExprNodes indices;
+        indices.emplace_back(makeReference(p_index + 3));
+        auto *sum = new BinaryOperatorNode(m_location, Operator::kPlusOp,
+                                           makeReference(p_index),
+                                           makeConstant(1));
+        auto *product = new BinaryOperatorNode(
+            m_location, Operator::kMultiplyOp, sum,
+            new UnaryOperatorNode(m_location, Operator::kNegOp,
+                                  makeReference(p_index + 1)));
+        return new BinaryOperatorNode(
+            m_location, Operator::kMinusOp, product,
+            new VariableReferenceNode(m_location, m_names[(p_index + 2) % 4],
+                                      indices));
+    }
+
+    AstNode *makeAssignment(const size_t p_index) {
+        return new AssignmentNode(m_location, makeReference(p_index),
+                                  makeExpression(p_index));
+    }
+
+    CompoundStatementNode *makeBlock(const size_t p_index) {
+        CompoundStatementNode::DeclNodes decls;
+        CompoundStatementNode::StmtNodes statements;
+        statements.emplace_back(makeAssignment(p_index));
+        return new CompoundStatementNode(m_location, decls, statements);
+    }
+
+    AstNode *makeStatement(const size_t p_index) {
+        switch (p_index % 4) {
+        case 0:
+            return makeAssignment(p_index);
+        case 1:
+            return new PrintNode(m_location, makeExpression(p_index));
+        case 2:
+            return new IfNode(
+                m_location,
+                new BinaryOperatorNode(m_location, Operator::kLessOp,
+                                       makeReference(p_index),
+                                       makeConstant(10)),
+                makeBlock(p_index), makeBlock(p_index + 1));
+        default:
+            return new WhileNode(
+                m_location,
+                new BinaryOperatorNode(m_location, Operator::kGreaterOp,
+                                       makeExpression(p_index),
+                                       makeConstant(0)),
+                makeBlock(p_index));
+        }
+    }
+
+  public:
+    /// @return A program whose body has `p_num_statements` statements.
+    ProgramNode *generate(const size_t p_num_statements) {
+        CompoundStatementNode::DeclNodes decls;
+        CompoundStatementNode::StmtNodes statements;
+        statements.reserve(p_num_statements);
+        for (size_t i = 0; i < p_num_statements; ++i) {
+            statements.emplace_back(makeStatement(i));
+        }
+        ProgramNode::DeclNodes program_decls;
+        ProgramNode::FuncNodes functions;
+        return new ProgramNode(
+            m_location, StringInterner::identifiers().intern("bench"),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kVoidType),
+            program_decls, functions,
+            new CompoundStatementNode(m_location, decls, statements));
+    }
+};
+
+/// @brief Counts the nodes through `accept()` and `visitChildNodes()`.
+class VirtualCounter final : public AstNodeVisitor {
+  private:
+    size_t m_num_nodes = 0;
+
+    template <typename Node> void count(Node &p_node) {
+        ++m_num_nodes;
+        p_node.visitChildNodes(*this);
+    }
+
+  public:
+    size_t getNumNodes() const { return m_num_nodes; }
+
+    void visit(ProgramNode &p_program) override { count(p_program); }
+    void visit(DeclNode &p_decl) override { count(p_decl); }
+    void visit(VariableNode &p_variable) override { count(p_variable); }
+    void visit(ConstantValueNode &p_constant_value) override {
+        count(p_constant_value);
+    }
+    void visit(FunctionNode &p_function) override { count(p_function); }
+    void visit(CompoundStatementNode &p_compound_statement) override {
+        count(p_compound_statement);
+    }
+    void visit(PrintNode &p_print) override { count(p_print); }
+    void visit(BinaryOperatorNode &p_bin_op) override { count(p_bin_op); }
+    void visit(UnaryOperatorNode &p_un_op) override { count(p_un_op); }
+    void visit(FunctionInvocationNode &p_func_invocation) override {
+        count(p_func_invocation);
+    }
+    void visit(VariableReferenceNode &p_variable_ref) override {
+        count(p_variable_ref);
+    }
+    void visit(AssignmentNode &p_assignment) override {
+        count(p_assignment);
+    }
+    void visit(ReadNode &p_read) override { count(p_read); }
+    void visit(IfNode &p_if) override { count(p_if); }
+    void visit(WhileNode &p_while) override { count(p_while); }
+    void visit(ForNode &p_for) override { count(p_for); }
+    void visit(ReturnNode &p_return) override { count(p_return); }
+};
+
+/// @brief Counts the nodes through `dispatch()` and `visitChildren()`.
+class StaticCounter final : public StaticVisitor<StaticCounter> {
+  private:
+    size_t m_num_nodes = 0;
+
+  public:
+    size_t getNumNodes() const { return m_num_nodes; }
+
+    template <typename Node> void visit(Node &p_node) {
+        ++m_num_nodes;
+        visitChildren(p_node);
+    }
+};
+
+/// @return The fastest of `p_num_runs` runs of `p_traverse`, in nanoseconds.
+template <typename Fn>
+double timeTraversal(const int p_num_runs, Fn &&p_traverse) {
+    double best = 0.0;
+    for (int run = 0; run < p_num_runs; ++run) {
+        const BenchClock::time_point start = BenchClock::now();
+        p_traverse();
+        const double elapsed =
+            std::chrono::duration<double, std::nano>(BenchClock::now() - start)
+                .count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+    const size_t num_statements =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const int num_runs = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    AstGenerator generator;
+    ProgramNode *program = generator.generate(num_statements);
+
+    size_t num_nodes = 0;
+    const double virtual_ns = timeTraversal(num_runs, [&] {
+        VirtualCounter counter;
+        program->accept(counter);
+        num_nodes = counter.getNumNodes();
+    });
+    size_t num_static_nodes = 0;
+    const double static_ns = timeTraversal(num_runs, [&] {
+        StaticCounter counter;
+        counter.dispatch(*program);
+        num_static_nodes = counter.getNumNodes();
+    });
+    if (num_nodes != num_static_nodes) {
+        std::fprintf(stderr, "The traversals visited %zu and %zu nodes\n",
+                     num_nodes, num_static_nodes);
+        return 1;
+    }
+
+    std::printf("%zu nodes, best of %d runs\n", num_nodes, num_runs);
+    std::printf("accept():   %8.3f ms  %6.2f ns/node\n", virtual_ns / 1e6,
+                virtual_ns / num_nodes);
+    std::printf("dispatch(): %8.3f ms  %6.2f ns/node\n", static_ns / 1e6,
+                static_ns / num_nodes);
+    std::printf("speedup:    %8.2fx\n", virtual_ns / static_ns);
+    return 0;
+}
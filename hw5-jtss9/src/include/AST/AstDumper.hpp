@@ -2,11 +2,11 @@
 #define AST_AST_DUMPER_H
 
 #include "util/Indenter.hpp"
-#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/StaticVisitor.hpp"
 
 #include <cstdint>
 
-class AstDumper final : public AstNodeVisitor {
+class AstDumper final : public StaticVisitor<AstDumper> {
   private:
     Indenter m_indenter{' ', 2};
 
@@ -14,23 +14,23 @@ class AstDumper final : public AstNodeVisitor {
     ~AstDumper() = default;
     AstDumper() = default;
 
-    void visit(ProgramNode &p_program) override;
-    void visit(DeclNode &p_decl) override;
-    void visit(VariableNode &p_variable) override;
-    void visit(ConstantValueNode &p_constant_value) override;
-    void visit(FunctionNode &p_function) override;
-    void visit(CompoundStatementNode &p_compound_statement) override;
-    void visit(PrintNode &p_print) override;
-    void visit(BinaryOperatorNode &p_bin_op) override;
-    void visit(UnaryOperatorNode &p_un_op) override;
-    void visit(FunctionInvocationNode &p_func_invocation) override;
-    void visit(VariableReferenceNode &p_variable_ref) override;
-    void visit(AssignmentNode &p_assignment) override;
-    void visit(ReadNode &p_read) override;
-    void visit(IfNode &p_if) override;
-    void visit(WhileNode &p_while) override;
-    void visit(ForNode &p_for) override;
-    void visit(ReturnNode &p_return) override;
+    void visit(ProgramNode &p_program);
+    void visit(DeclNode &p_decl);
+    void visit(VariableNode &p_variable);
+    void visit(ConstantValueNode &p_constant_value);
+    void visit(FunctionNode &p_function);
+    void visit(CompoundStatementNode &p_compound_statement);
+    void visit(PrintNode &p_print);
+    void visit(BinaryOperatorNode &p_bin_op);
+    void visit(UnaryOperatorNode &p_un_op);
+    void visit(FunctionInvocationNode &p_func_invocation);
+    void visit(VariableReferenceNode &p_variable_ref);
+    void visit(AssignmentNode &p_assignment);
+    void visit(ReadNode &p_read);
+    void visit(IfNode &p_if);
+    void visit(WhileNode &p_while);
+    void visit(ForNode &p_for);
+    void visit(ReturnNode &p_return);
 
   private:
     void printIndent() const;
@@ -15,10 +15,11 @@ class BinaryOperatorNode final : public ExpressionNode {
 
   public:
     ~BinaryOperatorNode() = default;
-    BinaryOperatorNode(const uint32_t line, const uint32_t col, Operator op,
+    BinaryOperatorNode(const Location &p_location, Operator op,
                        ExpressionNode *p_left_operand,
                        ExpressionNode *p_right_operand)
-        : ExpressionNode{line, col}, m_op(op), m_left_operand(p_left_operand),
+        : ExpressionNode{NodeKind::kBinaryOperator, p_location},
+          m_op(op), m_left_operand(p_left_operand),
           m_right_operand(p_right_operand) {}
 
     Operator getOp() const { return m_op; }
@@ -32,6 +33,10 @@ class BinaryOperatorNode final : public ExpressionNode {
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_left_operand);
+        p_fn(*m_right_operand);
+    }
 };
 
 #endif
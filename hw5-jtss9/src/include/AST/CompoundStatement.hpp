@@ -9,8 +9,8 @@
 
 class CompoundStatementNode final : public AstNode {
   public:
-    using DeclNodes = std::vector<std::unique_ptr<DeclNode>>;
-    using StmtNodes = std::vector<std::unique_ptr<AstNode>>;
+    using DeclNodes = AstVector<std::unique_ptr<DeclNode>>;
+    using StmtNodes = AstVector<std::unique_ptr<AstNode>>;
 
   private:
     DeclNodes m_decl_nodes;
@@ -18,18 +18,28 @@ class CompoundStatementNode final : public AstNode {
 
   public:
     ~CompoundStatementNode() = default;
-    CompoundStatementNode(const uint32_t line, const uint32_t col,
+    CompoundStatementNode(const Location &p_location,
                           DeclNodes &p_decl_nodes, StmtNodes &p_stmt_nodes)
-        : AstNode{line, col}, m_decl_nodes(std::move(p_decl_nodes)),
+        : AstNode{NodeKind::kCompoundStatement, p_location},
+          m_decl_nodes(std::move(p_decl_nodes)),
           m_stmt_nodes(std::move(p_stmt_nodes)){}
 
     void accept(AstNodeVisitor &p_visitor) override {
         p_visitor.visit(*this);
     }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        for (auto &decl_node : m_decl_nodes) {
+            p_fn(*decl_node);
+        }
+        for (auto &stmt_node : m_stmt_nodes) {
+            p_fn(*stmt_node);
+        }
+    }
     StmtNodes &getStatements() {
         return m_stmt_nodes;
     }
+    const DeclNodes &getDeclNodes() const { return m_decl_nodes; }
 };
 
 #endif
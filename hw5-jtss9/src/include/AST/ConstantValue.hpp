@@ -14,14 +14,12 @@ class ConstantValueNode final : public ExpressionNode {
 
   public:
     ~ConstantValueNode() = default;
-    ConstantValueNode(const uint32_t line, const uint32_t col,
+    ConstantValueNode(const Location &p_location,
                       Constant *const p_constant)
-        : ExpressionNode{line, col}, m_constant_ptr(p_constant) {}
+        : ExpressionNode{NodeKind::kConstantValue, p_location},
+          m_constant_ptr(p_constant) {}
 
     const PType *getTypePtr() const { return m_constant_ptr->getTypePtr(); }
-    const PTypeSharedPtr &getTypeSharedPtr() const {
-        return m_constant_ptr->getTypeSharedPtr();
-    }
 
     const char *getConstantValueCString() const {
         return m_constant_ptr->getConstantValueCString();
@@ -30,6 +28,7 @@ class ConstantValueNode final : public ExpressionNode {
     const Constant *getConstantPtr() const { return m_constant_ptr.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
+    template <typename Fn> void forEachChild(Fn &&p_fn) {}
 };
 
 #endif
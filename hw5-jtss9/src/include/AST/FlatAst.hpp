@@ -0,0 +1,60 @@
+#ifndef AST_FLAT_AST_H
+#define AST_FLAT_AST_H
+
+#include "AST/ast.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+/// @brief A dense index of a node in a `FlatAst`.
+using NodeId = uint32_t;
+
+/// @brief A summary of an AST in arrays indexed by `NodeId`: the kind of each
+/// node and where its subtree ends. An analysis that only asks what a subtree
+/// contains scans the kinds instead of dispatching through the nodes.
+///
+/// The nodes are numbered in pre-order, so the subtree of a node is a range
+/// of IDs. The tree itself stays the owner of the structure; this doesn't
+/// record the children of a node.
+class FlatAst {
+  private:
+    std::vector<NodeKind> m_kinds;
+    std::vector<AstNode *> m_nodes;
+    /// @brief One past the last node of the subtree of each node.
+    std::vector<NodeId> m_subtree_ends;
+    std::unordered_map<const AstNode *, NodeId> m_ids;
+
+    friend class FlatAstBuilder;
+
+  public:
+    FlatAst() = default;
+    explicit FlatAst(AstNode &p_root) { build(p_root); }
+
+    /// @brief Lays out the tree rooted at `p_root`, which gets ID 0.
+    void build(AstNode &p_root);
+
+    NodeId size() const { return static_cast<NodeId>(m_kinds.size()); }
+
+    /// @pre `p_node` is in the tree.
+    NodeId getId(const AstNode &p_node) const { return m_ids.at(&p_node); }
+
+    NodeKind getKind(const NodeId p_id) const { return m_kinds[p_id]; }
+
+    /// @pre `T` is the class of the kind of `p_id`.
+    template <typename T> T &getNode(const NodeId p_id) const {
+        return static_cast<T &>(*m_nodes[p_id]);
+    }
+
+    NodeId getSubtreeEnd(const NodeId p_id) const {
+        return m_subtree_ends[p_id];
+    }
+
+    /// @return Whether the subtree of `p_id`, `p_id` included, has a node of
+    /// one of `p_kinds`.
+    bool subtreeContains(NodeId p_id,
+                         std::initializer_list<NodeKind> p_kinds) const;
+};
+
+#endif
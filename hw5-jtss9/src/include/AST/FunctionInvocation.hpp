@@ -2,33 +2,51 @@
 #define AST_FUNCTION_INVOCATION_NODE_H
 
 #include "AST/expression.hpp"
+#include "util/StringInterner.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
 #include <memory>
 #include <string>
 #include <vector>
 
+class SymbolEntry;
+
 class FunctionInvocationNode final : public ExpressionNode {
   public:
-    using ExprNodes = std::vector<std::unique_ptr<ExpressionNode>>;
+    using ExprNodes = AstVector<std::unique_ptr<ExpressionNode>>;
 
   private:
-    std::string m_name;
+    IdentifierId m_name;
     ExprNodes m_args;
+    SymbolEntry *m_symbol_entry = nullptr;
 
   public:
     ~FunctionInvocationNode() = default;
-    FunctionInvocationNode(const uint32_t line, const uint32_t col,
-                           const char *const p_name, ExprNodes &p_args)
-        : ExpressionNode{line, col}, m_name(p_name), m_args(std::move(p_args)){}
-
-    const std::string &getName() const { return m_name; }
-    const char *getNameCString() const { return m_name.c_str(); }
+    FunctionInvocationNode(const Location &p_location,
+                           const IdentifierId p_name, ExprNodes &p_args)
+        : ExpressionNode{NodeKind::kFunctionInvocation, p_location},
+          m_name(p_name), m_args(std::move(p_args)){}
+
+    IdentifierId getNameId() const { return m_name; }
+    const std::string &getName() const {
+        return StringInterner::identifiers().getName(m_name);
+    }
+    const char *getNameCString() const { return getName().c_str(); }
+
+    /// @return The entry the name is bound to by the semantic analysis;
+    /// `nullptr` if it's undeclared.
+    SymbolEntry *getSymbolEntry() const { return m_symbol_entry; }
+    void setSymbolEntry(SymbolEntry *const p_entry) { m_symbol_entry = p_entry; }
 
     const ExprNodes &getArguments() const { return m_args; }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        for (auto &arg : m_args) {
+            p_fn(*arg);
+        }
+    }
 };
 
 #endif
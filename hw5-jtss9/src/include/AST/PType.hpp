@@ -2,15 +2,12 @@
 #define AST_P_TYPE_H
 
 #include <cstdint>
-#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
-class PType;
-
-using PTypeSharedPtr = std::shared_ptr<PType>;
-
+/// @brief A type of the language. Types are interned by the `TypeContext`,
+/// so two types are the same iff they are at the same address.
 class PType {
   public:
     enum class PrimitiveTypeEnum : uint8_t {
@@ -26,23 +23,28 @@ class PType {
   private:
     PrimitiveTypeEnum m_type;
     std::vector<uint64_t> m_dimensions;
-    mutable std::string m_type_string;
-    mutable bool m_type_string_is_valid = false;
+    /// @brief Filled in once the type is interned.
+    std::string m_type_string;
+
+    friend class TypeContext;
+
+    PType(const PrimitiveTypeEnum type, std::vector<uint64_t> p_dims)
+        : m_type(type), m_dimensions(std::move(p_dims)) {}
 
   public:
     ~PType() = default;
-    PType(const PrimitiveTypeEnum type) : m_type(type) {}
-
-    void setDimensions(std::vector<uint64_t> &p_dims) {
-        m_dimensions = std::move(p_dims);
-    }
+    PType(const PType &) = delete;
+    PType &operator=(const PType &) = delete;
+    PType(PType &&) = default;
 
     PrimitiveTypeEnum getPrimitiveType() const { return m_type; }
-    const char *getPTypeCString() const;
+    const char *getPTypeCString() const { return m_type_string.c_str(); }
 
     const std::vector<uint64_t> &getDimensions() const { return m_dimensions; }
 
-    PType *getStructElementType(const std::size_t nth) const;
+    /// @return The type with the first `nth` dimensions removed; `nullptr` if
+    /// there are fewer than `nth` dimensions.
+    const PType *getStructElementType(const std::size_t nth) const;
 
     bool isPrimitiveInteger() const {
         return m_type == PrimitiveTypeEnum::kIntegerType;
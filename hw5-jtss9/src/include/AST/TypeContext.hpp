@@ -0,0 +1,59 @@
+#ifndef AST_TYPE_CONTEXT_H
+#define AST_TYPE_CONTEXT_H
+
+#include "AST/PType.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+/// @brief Owns one `PType` per distinct (primitive type, dimensions), so that
+/// types compare by address and an expression doesn't own its type.
+class TypeContext {
+  private:
+    /// @brief Hashes and compares the types through the pointers kept as keys.
+    struct TypeHash {
+        std::size_t operator()(const PType *p_type) const;
+    };
+    struct TypeEqual {
+        bool operator()(const PType *p_lhs, const PType *p_rhs) const {
+            return p_lhs->m_type == p_rhs->m_type &&
+                   p_lhs->m_dimensions == p_rhs->m_dimensions;
+        }
+    };
+
+    static constexpr std::size_t kNumPrimitiveTypes =
+        static_cast<std::size_t>(PType::PrimitiveTypeEnum::kErrorType) + 1;
+
+    /// @brief A deque doesn't move the types as it grows.
+    std::deque<PType> m_types;
+    std::unordered_set<const PType *, TypeHash, TypeEqual> m_interned_types;
+    /// @brief The scalar types, which most expressions have, skip the hashing.
+    std::array<const PType *, kNumPrimitiveTypes> m_scalar_types;
+
+  public:
+    TypeContext();
+    TypeContext(const TypeContext &) = delete;
+    TypeContext &operator=(const TypeContext &) = delete;
+
+    /// @return The context the parser and the semantic analysis build the
+    /// types in.
+    static TypeContext &types();
+
+    const PType *getType(const PType::PrimitiveTypeEnum p_primitive) const {
+        return m_scalar_types[static_cast<std::size_t>(p_primitive)];
+    }
+    const PType *getType(PType::PrimitiveTypeEnum p_primitive,
+                         std::vector<uint64_t> p_dims);
+
+    /// @return The number of distinct types.
+    std::size_t size() const { return m_types.size(); }
+
+  private:
+    const PType *intern(PType &&p_type);
+};
+
+#endif
@@ -14,9 +14,10 @@ class UnaryOperatorNode final : public ExpressionNode {
 
   public:
     ~UnaryOperatorNode() = default;
-    UnaryOperatorNode(const uint32_t line, const uint32_t col, Operator op,
+    UnaryOperatorNode(const Location &p_location, Operator op,
                       ExpressionNode *p_operand)
-        : ExpressionNode{line, col}, m_op(op), m_operand(p_operand) {}
+        : ExpressionNode{NodeKind::kUnaryOperator, p_location},
+          m_op(op), m_operand(p_operand) {}
 
     Operator getOp() const { return m_op; }
 
@@ -28,6 +29,9 @@ class UnaryOperatorNode final : public ExpressionNode {
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_operand);
+    }
 };
 
 #endif
@@ -14,15 +14,20 @@ class AssignmentNode final : public AstNode {
 
   public:
     ~AssignmentNode() = default;
-    AssignmentNode(const uint32_t line, const uint32_t col,
+    AssignmentNode(const Location &p_location,
                    VariableReferenceNode *p_var_ref, ExpressionNode *p_expr)
-        : AstNode{line, col}, m_lvalue(p_var_ref), m_expr(p_expr){}
+        : AstNode{NodeKind::kAssignment, p_location},
+          m_lvalue(p_var_ref), m_expr(p_expr){}
 
     VariableReferenceNode &getLvalue() const { return *m_lvalue.get(); }
     ExpressionNode &getExpr() const { return *m_expr.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_lvalue);
+        p_fn(*m_expr);
+    }
 };
 
 #endif
@@ -1,32 +1,77 @@
 #ifndef AST_AST_NODE_H
 #define AST_AST_NODE_H
 
+#include "util/Arena.hpp"
+
+#include <cstddef>
 #include <cstdint>
 
 class AstNodeVisitor;
 
-struct Location {
-    uint32_t line;
-    uint32_t col;
+/// @brief The class of a node, which the static visitors switch on instead of
+/// dispatching through `accept()`.
+enum class NodeKind : uint8_t {
+    kProgram,
+    kDecl,
+    kVariable,
+    kConstantValue,
+    kFunction,
+    kCompoundStatement,
+    kPrint,
+    kBinaryOperator,
+    kUnaryOperator,
+    kFunctionInvocation,
+    kVariableReference,
+    kAssignment,
+    kRead,
+    kIf,
+    kWhile,
+    kFor,
+    kReturn
+};
+
+/// @brief A position in the source, kept as the offset of its first byte.
+///
+/// The line and the column are only needed by diagnostics and dumps, so they
+/// are looked up in the `LineIndex` of the source when asked for.
+class Location {
+  private:
+    uint32_t m_offset;
 
-    ~Location() = default;
-    Location(const uint32_t line, const uint32_t col) : line(line), col(col) {}
+  public:
+    Location() = default;
+    explicit Location(const uint32_t p_offset) : m_offset(p_offset) {}
+
+    uint32_t getOffset() const { return m_offset; }
+    /// @note one-based
+    uint32_t getLine() const;
+    /// @note one-based
+    uint32_t getCol() const;
 };
 
 class AstNode {
   protected:
     Location location;
+    NodeKind m_kind;
 
   public:
     virtual ~AstNode() = 0;
-    AstNode(const uint32_t line, const uint32_t col);
+    AstNode(const NodeKind p_kind, const Location &p_location);
 
     AstNode(const AstNode &) = delete;
     AstNode(AstNode &&) = delete;
     AstNode &operator=(const AstNode &) = delete;
     AstNode &operator=(AstNode &&) = delete;
 
+    /// @brief The nodes live in the arena of the compilation unit and go away
+    /// with it.
+    static void *operator new(const std::size_t p_size) {
+        return Arena::ast().allocate(p_size);
+    }
+    static void operator delete(void *) {}
+
     const Location &getLocation() const;
+    NodeKind getKind() const { return m_kind; }
 
     virtual void accept(AstNodeVisitor &p_visitor) = 0;
     virtual void visitChildNodes(AstNodeVisitor &p_visitor){};
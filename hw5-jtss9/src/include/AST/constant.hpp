@@ -2,9 +2,10 @@
 #define AST_CONSTANT_H
 
 #include "AST/PType.hpp"
+#include "util/Arena.hpp"
 
+#include <cstddef>
 #include <cstdint>
-#include <cstdlib>
 
 class Constant {
   public:
@@ -16,26 +17,29 @@ class Constant {
     };
 
   private:
-    PTypeSharedPtr m_type;
+    const PType *m_type;
     ConstantValue m_value;
-    mutable std::string m_constant_value_string;
-    mutable bool m_constant_value_string_is_valid = false;
+    /// @brief In the arena of the AST; `nullptr` until it's asked for.
+    mutable const char *m_constant_value_string = nullptr;
 
   public:
-    ~Constant() {
-        if (m_type->getPrimitiveType() ==
-            PType::PrimitiveTypeEnum::kStringType) {
-            free(m_value.string);
-        }
-    }
-    Constant(const PTypeSharedPtr &p_type, const ConstantValue value)
+    /// @note A string is in the arena of the AST as well.
+    ~Constant() = default;
+    Constant(const PType *p_type, const ConstantValue value)
         : m_type(p_type), m_value(value) {}
 
-    const PType *getTypePtr() const { return m_type.get(); }
-    const PTypeSharedPtr &getTypeSharedPtr() const { return m_type; }
+    static void *operator new(const std::size_t p_size) {
+        return Arena::ast().allocate(p_size);
+    }
+    static void operator delete(void *) {}
+
+    const PType *getTypePtr() const { return m_type; }
     const char *getConstantValueCString() const;
 
     decltype(m_value.integer) integer() const { return m_value.integer; }
+    decltype(m_value.real) real() const { return m_value.real; }
+    const char *string() const { return m_value.string; }
+    decltype(m_value.boolean) boolean() const { return m_value.boolean; }
 };
 
 #endif
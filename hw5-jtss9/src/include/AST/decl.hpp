@@ -11,38 +11,43 @@
 
 class DeclNode final : public AstNode {
   public:
-    using VarNodes = std::vector<std::unique_ptr<VariableNode>>;
+    using VarNodes = AstVector<std::unique_ptr<VariableNode>>;
 
   private:
     VarNodes m_var_nodes;
 
   private:
     void init(const std::vector<IdInfo> *const p_ids,
-              const PTypeSharedPtr &p_type,
+              const PType *p_type,
               ConstantValueNode *const p_constant);
 
   public:
     ~DeclNode() = default;
 
     // variable declaration
-    DeclNode(const uint32_t line, const uint32_t col,
-             const std::vector<IdInfo> *const p_ids, PType *p_type)
-        : AstNode{line, col} {
-        init(p_ids, PTypeSharedPtr{p_type}, nullptr);
+    DeclNode(const Location &p_location,
+             const std::vector<IdInfo> *const p_ids, const PType *p_type)
+        : AstNode{NodeKind::kDecl, p_location} {
+        init(p_ids, p_type, nullptr);
     }
 
     // constant variable declaration
-    DeclNode(const uint32_t line, const uint32_t col,
+    DeclNode(const Location &p_location,
              const std::vector<IdInfo> *const p_ids,
              ConstantValueNode *const p_constant)
-        : AstNode{line, col} {
-        init(p_ids, p_constant->getTypeSharedPtr(), p_constant);
+        : AstNode{NodeKind::kDecl, p_location} {
+        init(p_ids, p_constant->getTypePtr(), p_constant);
     }
 
     const VarNodes &getVariables() { return m_var_nodes; }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        for (auto &var_node : m_var_nodes) {
+            p_fn(*var_node);
+        }
+    }
 };
 
 #endif
@@ -16,10 +16,10 @@ class ForNode final : public AstNode {
 
   
     ~ForNode() = default;
-    ForNode(const uint32_t line, const uint32_t col,
+    ForNode(const Location &p_location,
             DeclNode *p_loop_var_decl, AssignmentNode *p_init_stmt,
             ExpressionNode *p_end_condition, CompoundStatementNode *p_body)
-        : AstNode{line, col}, m_loop_var_decl(p_loop_var_decl),
+        : AstNode{NodeKind::kFor, p_location}, m_loop_var_decl(p_loop_var_decl),
           m_init_stmt(p_init_stmt), m_end_condition(p_end_condition),
           m_body(p_body) {}
 
@@ -28,6 +28,12 @@ class ForNode final : public AstNode {
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_loop_var_decl);
+        p_fn(*m_init_stmt);
+        p_fn(*m_end_condition);
+        p_fn(*m_body);
+    }
 };
 
 #endif
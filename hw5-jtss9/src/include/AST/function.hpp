@@ -3,47 +3,69 @@
 
 #include "AST/CompoundStatement.hpp"
 #include "AST/ast.hpp"
+#include "util/StringInterner.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
 #include <memory>
 #include <string>
 #include <vector>
 
+class SymbolEntry;
+
 class FunctionNode final : public AstNode {
   public:
-    using DeclNodes = std::vector<std::unique_ptr<DeclNode>>;
+    using DeclNodes = AstVector<std::unique_ptr<DeclNode>>;
 
   private:
-    std::string m_name;
+    IdentifierId m_name;
     DeclNodes m_parameters;
-    std::unique_ptr<PType> m_ret_type;
+    const PType *m_ret_type;
     std::unique_ptr<CompoundStatementNode> m_body;
+    SymbolEntry *m_symbol_entry = nullptr;
 
-    mutable std::string m_prototype_string;
-    mutable bool m_prototype_string_is_valid = false;
+    /// @brief In the arena of the AST; `nullptr` until it's asked for.
+    mutable const char *m_prototype_string = nullptr;
 
   public:
     ~FunctionNode() = default;
-    FunctionNode(const uint32_t line, const uint32_t col,
-                 const char *const p_name, DeclNodes &p_decl_nodes,
-                 PType *const p_ret_type, CompoundStatementNode *const p_body)
-        : AstNode{line, col}, m_name(p_name),
+    FunctionNode(const Location &p_location,
+                 const IdentifierId p_name, DeclNodes &p_decl_nodes,
+                 const PType *const p_ret_type, CompoundStatementNode *const p_body)
+        : AstNode{NodeKind::kFunction, p_location}, m_name(p_name),
           m_parameters(std::move(p_decl_nodes)), m_ret_type(p_ret_type),
           m_body(p_body) {}
 
     static std::string getParametersTypeString(const DeclNodes &p_parameters);
     static DeclNodes::size_type getParametersNum(const DeclNodes &p_parameters);
 
-    const std::string &getName() const { return m_name; }
-    const char *getNameCString() const { return m_name.c_str(); }
+    IdentifierId getNameId() const { return m_name; }
+    const std::string &getName() const {
+        return StringInterner::identifiers().getName(m_name);
+    }
+    const char *getNameCString() const { return getName().c_str(); }
+
+    /// @return The entry declared by the semantic analysis; `nullptr` if the
+    /// name is redeclared.
+    SymbolEntry *getSymbolEntry() const { return m_symbol_entry; }
+    void setSymbolEntry(SymbolEntry *const p_entry) { m_symbol_entry = p_entry; }
     const char *getPrototypeCString() const;
 
     const DeclNodes &getParameters() const { return m_parameters; }
 
-    const PType *getTypePtr() const { return m_ret_type.get(); }
+    const PType *getTypePtr() const { return m_ret_type; }
+    /// @return `nullptr` if it's only a declaration.
+    const CompoundStatementNode *getBody() const { return m_body.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        for (auto &parameter : m_parameters) {
+            p_fn(*parameter);
+        }
+        if (m_body) {
+            p_fn(*m_body);
+        }
+    }
 
     void visitBodyChildNodes(AstNodeVisitor &p_visitor);
 };
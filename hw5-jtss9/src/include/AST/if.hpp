@@ -15,16 +15,24 @@ class IfNode final : public AstNode {
 
   
     ~IfNode() = default;
-    IfNode(const uint32_t line, const uint32_t col,
+    IfNode(const Location &p_location,
            ExpressionNode *p_condition, CompoundStatementNode *p_body,
            CompoundStatementNode *p_else_body)
-        : AstNode{line, col}, m_condition(p_condition), m_body(p_body),
+        : AstNode{NodeKind::kIf, p_location},
+          m_condition(p_condition), m_body(p_body),
           m_else_body(p_else_body){}
 
     const ExpressionNode &getCondition() const { return *m_condition.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_condition);
+        p_fn(*m_body);
+        if (m_else_body) {
+            p_fn(*m_else_body);
+        }
+    }
 };
 
 #endif
@@ -13,14 +13,17 @@ class PrintNode final : public AstNode {
 
   public:
     ~PrintNode() = default;
-    PrintNode(const uint32_t line, const uint32_t col,
+    PrintNode(const Location &p_location,
               ExpressionNode *p_target)
-        : AstNode{line, col}, m_target(p_target){}
+        : AstNode{NodeKind::kPrint, p_location}, m_target(p_target){}
 
     ExpressionNode &getTarget() const { return *m_target.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_target);
+    }
 };
 
 #endif
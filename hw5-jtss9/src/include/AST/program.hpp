@@ -4,6 +4,7 @@
 #include "AST/ast.hpp"
 #include "AST/decl.hpp"
 #include "AST/function.hpp"
+#include "util/StringInterner.hpp"
 
 #include <memory>
 #include <string>
@@ -11,30 +12,34 @@
 
 class ProgramNode final : public AstNode {
   public:
-    using DeclNodes = std::vector<std::unique_ptr<DeclNode>>;
-    using FuncNodes = std::vector<std::unique_ptr<FunctionNode>>;
+    using DeclNodes = AstVector<std::unique_ptr<DeclNode>>;
+    using FuncNodes = AstVector<std::unique_ptr<FunctionNode>>;
 
   private:
-    std::string m_name;
-    std::unique_ptr<PType> m_ret_type;
+    IdentifierId m_name;
+    const PType *m_ret_type;
     DeclNodes m_decl_nodes;
     FuncNodes m_func_nodes;
     std::unique_ptr<CompoundStatementNode> m_body;
 
   public:
     ~ProgramNode() = default;
-    ProgramNode(const uint32_t line, const uint32_t col,
-                const char *const p_name, PType *const p_ret_type,
+    ProgramNode(const Location &p_location,
+                const IdentifierId p_name, const PType *const p_ret_type,
                 DeclNodes &p_decl_nodes, FuncNodes &p_func_nodes,
                 CompoundStatementNode *const p_body)
-        : AstNode{line, col}, m_name(p_name), m_ret_type(p_ret_type),
+        : AstNode{NodeKind::kProgram, p_location},
+          m_name(p_name), m_ret_type(p_ret_type),
           m_decl_nodes(std::move(p_decl_nodes)),
           m_func_nodes(std::move(p_func_nodes)), m_body(p_body) {}
 
-    const char *getNameCString() const { return m_name.c_str(); }
-    const std::string &getName() const { return m_name; }
+    IdentifierId getNameId() const { return m_name; }
+    const char *getNameCString() const { return getName().c_str(); }
+    const std::string &getName() const {
+        return StringInterner::identifiers().getName(m_name);
+    }
 
-    const PType *getTypePtr() const { return m_ret_type.get(); }
+    const PType *getTypePtr() const { return m_ret_type; }
 
     const DeclNodes &getDeclNodes() const { return m_decl_nodes; }
     const FuncNodes &getFuncNodes() const { return m_func_nodes; }
@@ -42,6 +47,15 @@ class ProgramNode final : public AstNode {
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        for (auto &decl_node : m_decl_nodes) {
+            p_fn(*decl_node);
+        }
+        for (auto &func_node : m_func_nodes) {
+            p_fn(*func_node);
+        }
+        p_fn(*m_body);
+    }
 };
 
 #endif
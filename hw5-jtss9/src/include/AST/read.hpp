@@ -12,14 +12,17 @@ class ReadNode final : public AstNode {
 
   public:
     ~ReadNode() = default;
-    ReadNode(const uint32_t line, const uint32_t col,
+    ReadNode(const Location &p_location,
              VariableReferenceNode *p_target)
-        : AstNode{line, col}, m_target(p_target){}
+        : AstNode{NodeKind::kRead, p_location}, m_target(p_target){}
 
     const VariableReferenceNode &getTarget() const { return *m_target.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_target);
+    }
 };
 
 #endif
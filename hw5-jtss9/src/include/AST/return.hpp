@@ -13,14 +13,17 @@ class ReturnNode final : public AstNode {
 
   public:
     ~ReturnNode() = default;
-    ReturnNode(const uint32_t line, const uint32_t col,
+    ReturnNode(const Location &p_location,
                ExpressionNode *p_ret_val)
-        : AstNode{line, col}, m_ret_val(p_ret_val){}
+        : AstNode{NodeKind::kReturn, p_location}, m_ret_val(p_ret_val){}
 
     const ExpressionNode &getReturnValue() const { return *m_ret_val.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_ret_val);
+    }
 };
 
 #endif
@@ -2,17 +2,17 @@
 #define AST_UTILS_H
 
 #include "AST/ast.hpp"
+#include "util/StringInterner.hpp"
 
 #include <cstdint>
-#include <string>
 
 // for carrying identifier info through IdList
 struct IdInfo {
     Location location;
-    std::string id;
+    IdentifierId id;
 
-    IdInfo(const uint32_t line, const uint32_t col, const char * const p_id)
-        : location(line, col), id(p_id) {}
+    IdInfo(const Location &p_location, const IdentifierId p_id)
+        : location(p_location), id(p_id) {}
 };
 
 #endif
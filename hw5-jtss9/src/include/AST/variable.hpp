@@ -4,30 +4,44 @@
 #include "AST/PType.hpp"
 #include "AST/ast.hpp"
 #include "AST/ConstantValue.hpp"
+#include "util/StringInterner.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
 #include <memory>
 #include <string>
 
+class SymbolEntry;
+
 class VariableNode final : public AstNode {
   private:
-    std::string m_name;
-    PTypeSharedPtr m_type;
-    std::shared_ptr<ConstantValueNode> m_constant_value_node_ptr;
+    IdentifierId m_name;
+    const PType *m_type;
+    /// @brief Shared by the variables declared together.
+    ConstantValueNode *m_constant_value_node_ptr;
+    SymbolEntry *m_symbol_entry = nullptr;
 
   public:
     ~VariableNode() = default;
-    VariableNode(const uint32_t line, const uint32_t col,
-                 const std::string &p_name, const PTypeSharedPtr &p_type,
-                 const std::shared_ptr<ConstantValueNode> &p_constant_value_node)
-        : AstNode{line, col}, m_name(p_name), m_type(p_type),
+    VariableNode(const Location &p_location,
+                 const IdentifierId p_name, const PType *p_type,
+                 ConstantValueNode *const p_constant_value_node)
+        : AstNode{NodeKind::kVariable, p_location},
+          m_name(p_name), m_type(p_type),
           m_constant_value_node_ptr(p_constant_value_node) {}
 
-    const std::string &getName() const { return m_name; }
-    const char *getNameCString() const { return m_name.c_str(); }
+    IdentifierId getNameId() const { return m_name; }
+    const std::string &getName() const {
+        return StringInterner::identifiers().getName(m_name);
+    }
+    const char *getNameCString() const { return getName().c_str(); }
     const char *getTypeCString() const { return m_type->getPTypeCString(); }
 
-    const PType *getTypePtr() const { return m_type.get(); }
+    /// @return The entry declared by the semantic analysis; `nullptr` if the
+    /// name is redeclared.
+    SymbolEntry *getSymbolEntry() const { return m_symbol_entry; }
+    void setSymbolEntry(SymbolEntry *const p_entry) { m_symbol_entry = p_entry; }
+
+    const PType *getTypePtr() const { return m_type; }
 
     const Constant *getConstantPtr() const {
         if (!m_constant_value_node_ptr) {
@@ -40,6 +54,11 @@ class VariableNode final : public AstNode {
         p_visitor.visit(*this);
     }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        if (m_constant_value_node_ptr) {
+            p_fn(*m_constant_value_node_ptr);
+        }
+    }
 };
 
 #endif
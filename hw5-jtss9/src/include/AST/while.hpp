@@ -14,14 +14,19 @@ class WhileNode final : public AstNode {
 
   
     ~WhileNode() = default;
-    WhileNode(const uint32_t line, const uint32_t col,
+    WhileNode(const Location &p_location,
               ExpressionNode *p_condition, CompoundStatementNode *p_body)
-        : AstNode{line, col}, m_condition(p_condition), m_body(p_body){}
+        : AstNode{NodeKind::kWhile, p_location},
+          m_condition(p_condition), m_body(p_body){}
 
     const ExpressionNode &getCondition() const { return *m_condition.get(); }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
+    template <typename Fn> void forEachChild(Fn &&p_fn) {
+        p_fn(*m_condition);
+        p_fn(*m_body);
+    }
 };
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef CODEGEN_C_SOURCE_GENERATOR_H
+#define CODEGEN_C_SOURCE_GENERATOR_H
+
+#include "sema/SemanticAnalyzer.hpp"
+#include "sema/SymbolTable.hpp"
+#include "util/Indenter.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/// @brief Translates a P program into standalone C99 (`.c`) that calls the
+/// runtime functions of `test/io.c`, so that it can be built by any host C
+/// compiler.
+///
+/// P identifiers are prefixed with `p_` so that they never clash with C
+/// keywords or the C library. Integer division and remainder follow RISC-V
+/// (no trap on zero) so that the output can be compared against `--run`;
+/// compile with `-fwrapv` to also match it on signed overflow.
+class CSourceGenerator final : public AstNodeVisitor {
+  private:
+    std::string m_source_file_path;
+    std::string m_output_file_path;
+    /// @brief Owns the symbol entries the AST nodes are bound to.
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        m_symbol_table_of_scoping_nodes;
+    /// NOTE: `FILE` cannot be simply deleted by `delete`, so we need a custom deleter.
+    std::unique_ptr<FILE, decltype(&fclose)> m_output_file{nullptr, &fclose};
+
+    Indenter m_indenter{' ', 4};
+    /// @brief The C expression of the last visited expression.
+    std::string m_expr;
+    /// @brief The nesting depth of `translate()`; a function invocation out of
+    /// any expression is a statement.
+    int m_expression_depth = 0;
+    const PType *m_return_type = nullptr;
+
+  public:
+    ~CSourceGenerator() = default;
+    CSourceGenerator(const std::string &source_file_name,
+                     const std::string &save_path,
+                     std::unordered_map<SemanticAnalyzer::AstNodeAddr,
+                                        SymbolManager::Table>
+                         &&p_symbol_table_of_scoping_nodes);
+
+    /// @return The path of the generated `.c` file.
+    const std::string &getOutputFilePath() const { return m_output_file_path; }
+
+    void visit(ProgramNode &p_program) override;
+    void visit(DeclNode &p_decl) override;
+    void visit(VariableNode &p_variable) override;
+    void visit(ConstantValueNode &p_constant_value) override;
+    void visit(FunctionNode &p_function) override;
+    void visit(CompoundStatementNode &p_compound_statement) override;
+    void visit(PrintNode &p_print) override;
+    void visit(BinaryOperatorNode &p_bin_op) override;
+    void visit(UnaryOperatorNode &p_un_op) override;
+    void visit(FunctionInvocationNode &p_func_invocation) override;
+    void visit(VariableReferenceNode &p_variable_ref) override;
+    void visit(AssignmentNode &p_assignment) override;
+    void visit(ReadNode &p_read) override;
+    void visit(IfNode &p_if) override;
+    void visit(WhileNode &p_while) override;
+    void visit(ForNode &p_for) override;
+    void visit(ReturnNode &p_return) override;
+
+  private:
+    /// @brief Writes an indented line.
+    void emitLine(const char *format, ...);
+    /// @return The C expression of `p_expr` converted to `p_type`.
+    std::string translate(ExpressionNode &p_expr, const PType &p_type);
+    /// @brief Visits the children of a compound statement in a C block.
+    void emitBlock(CompoundStatementNode &p_compound_statement);
+};
+
+#endif
@@ -1,24 +1,98 @@
 #ifndef CODEGEN_CODE_GENERATOR_H
 #define CODEGEN_CODE_GENERATOR_H
 
+#include "AST/CompoundStatement.hpp"
+#include "AST/FlatAst.hpp"
+#include "codegen/Profile.hpp"
 #include "sema/SemanticAnalyzer.hpp"
 #include "sema/SymbolTable.hpp"
-#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/StaticVisitor.hpp"
 
 #include <cstdio>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
-class CodeGenerator final : public AstNodeVisitor {
+class CodeGenerator final : public StaticVisitor<CodeGenerator> {
   private:
-    SymbolManager m_symbol_manager;
     std::string m_source_file_path;
+    std::string m_output_file_path;
+    /// @brief Owns the symbol entries the AST nodes are bound to.
     std::unordered_map<SemanticAnalyzer::AstNodeAddr,
                              SymbolManager::Table>
         m_symbol_table_of_scoping_nodes;
     /// NOTE: `FILE` cannot be simply deleted by `delete`, so we need a custom deleter.
     std::unique_ptr<FILE, decltype(&fclose)> m_output_file{nullptr, &fclose};
+    /// @brief Blocks moved out of line, appended to the current function.
+    std::unique_ptr<FILE, decltype(&fclose)> m_cold_file{nullptr, &fclose};
+    /// @brief Either `m_output_file` or `m_cold_file`.
+    FILE *m_out = nullptr;
+
+    const ProfileLayout *m_profile_layout = nullptr;
+    /// @brief Where the instrumented program dumps its counters; empty if
+    /// it's not instrumented.
+    std::string m_profile_path;
+    const ProfileData *m_profile = nullptr;
+    /// @brief Whether to report the loop transformations.
+    bool m_has_remarks = false;
+    /// @brief The size of the data cache in bytes, which loop tiling fits
+    /// the tiles in.
+    uint32_t m_cache_size = 32768;
+    /// @brief Optional extensions the generated code may use.
+    bool m_has_zicond = false;
+    bool m_has_zbb = false;
+    /// @brief The entry count of the function being generated.
+    uint32_t m_function_count = 0;
+    /// @brief The number of loops enclosing the code being generated.
+    int m_loop_depth = 0;
+    /// @brief Loop variables of counted loops and the registers holding them.
+    std::unordered_map<const SymbolEntry *, const char *> m_register_variables;
+    /// @brief The registers taken by the enclosing counted loops.
+    size_t m_num_loop_registers = 0;
+    /// @brief The program laid out flat for the analyses that walk whole
+    /// subtrees.
+    FlatAst m_flat_ast;
+    /// @brief The `if`s whose invariant condition has been tested before
+    /// the enclosing loop, and the value assumed by the version being
+    /// generated.
+    std::unordered_map<const IfNode *, bool> m_unswitched_conditions;
+    /// @brief How many versions of the code being generated unswitching has
+    /// made.
+    size_t m_num_loop_copies = 1;
+
+    /// @brief How the two sides of an `if` are laid out.
+    enum class IfLayout {
+        kThenFirst,
+        kElseFirst,
+        /// The `then` body is moved out of line.
+        kThenOutOfLine,
+        /// The `else` body is moved out of line.
+        kElseOutOfLine
+    };
+
+    /// @brief A `for` loop (or fused loops) between `beginForLoop()` and
+    /// `endForLoop()`.
+    struct ForLoop {
+        std::vector<ForNode *> loops;
+        int labels[2];
+        std::vector<SymbolEntry *> symbols;
+        /// Both null if the loop variable lives in memory.
+        const char *counter_register = nullptr;
+        const char *variable_register = nullptr;
+        bool is_cold_body = false;
+    };
+
+    /// @brief A case of an `if` chain lowered by `trySwitchLowering()`.
+    struct SwitchCase {
+        int32_t value;
+        int label;
+        CompoundStatementNode *body;
+    };
+    /// @brief The jump tables of the program with the labels of their
+    /// entries, emitted to `.rodata` after the code.
+    std::vector<std::pair<int, std::vector<int>>> m_jump_tables;
 
   public:
     ~CodeGenerator() = default;
@@ -28,23 +102,116 @@ class CodeGenerator final : public AstNodeVisitor {
                                            SymbolManager::Table>
                       &&p_symbol_table_of_scoping_nodes);
 
-    void visit(ProgramNode &p_program) override;
-    void visit(DeclNode &p_decl) override;
-    void visit(VariableNode &p_variable) override;
-    void visit(ConstantValueNode &p_constant_value) override;
-    void visit(FunctionNode &p_function) override;
-    void visit(CompoundStatementNode &p_compound_statement) override;
-    void visit(PrintNode &p_print) override;
-    void visit(BinaryOperatorNode &p_bin_op) override;
-    void visit(UnaryOperatorNode &p_un_op) override;
-    void visit(FunctionInvocationNode &p_func_invocation) override;
-    void visit(VariableReferenceNode &p_variable_ref) override;
-    void visit(AssignmentNode &p_assignment) override;
-    void visit(ReadNode &p_read) override;
-    void visit(IfNode &p_if) override;
-    void visit(WhileNode &p_while) override;
-    void visit(ForNode &p_for) override;
-    void visit(ReturnNode &p_return) override;
+    /// @return The path of the generated `.S` file.
+    const std::string &getOutputFilePath() const { return m_output_file_path; }
+
+    /// @brief Instruments the program to count the executions of the points
+    /// of `p_layout` and to dump the counts to `p_profile_path` at exit.
+    void instrumentProfile(const ProfileLayout &p_layout,
+                           const std::string &p_profile_path);
+    /// @brief Orders the functions and lays out the branches by the counts
+    /// of `p_profile`; blocks never executed are moved out of line.
+    void useProfile(const ProfileLayout &p_layout,
+                    const ProfileData &p_profile);
+    /// @brief Allows the conditional zero (Zicond) and the `min`/`max`
+    /// (Zbb) instructions.
+    void setExtensions(bool p_has_zicond, bool p_has_zbb) {
+        m_has_zicond = p_has_zicond;
+        m_has_zbb = p_has_zbb;
+    }
+
+    /// @brief Reports the loop transformations to `stderr`.
+    void setRemarks(bool p_has_remarks) { m_has_remarks = p_has_remarks; }
+    void setCacheSize(uint32_t p_cache_size) { m_cache_size = p_cache_size; }
+
+    void visit(ProgramNode &p_program);
+    void visit(DeclNode &p_decl);
+    void visit(VariableNode &p_variable);
+    void visit(ConstantValueNode &p_constant_value);
+    void visit(FunctionNode &p_function);
+    void visit(CompoundStatementNode &p_compound_statement);
+    void visit(PrintNode &p_print);
+    void visit(BinaryOperatorNode &p_bin_op);
+    void visit(UnaryOperatorNode &p_un_op);
+    void visit(FunctionInvocationNode &p_func_invocation);
+    void visit(VariableReferenceNode &p_variable_ref);
+    void visit(AssignmentNode &p_assignment);
+    void visit(ReadNode &p_read);
+    void visit(IfNode &p_if);
+    void visit(WhileNode &p_while);
+    void visit(ForNode &p_for);
+    void visit(ReturnNode &p_return);
+
+  private:
+    /// @brief Lets the likely side of `p_if` fall through, by the profile if
+    /// there's one and by static heuristics otherwise.
+    IfLayout chooseIfLayout(IfNode &p_if) const;
+    /// @brief Replaces an `if` that assigns one of two values to a variable
+    /// with a branchless selection.
+    /// @return Whether `p_if` has been generated.
+    bool tryIfConversion(IfNode &p_if);
+    /// @brief Replaces a chain of `if`s that compare one integer variable
+    /// with distinct constants by a jump table if the constants are dense and
+    /// by a binary search otherwise.
+    /// @return Whether `p_if` has been generated.
+    bool trySwitchLowering(IfNode &p_if);
+    /// @brief Branches on `t0` to the case of `p_cases[p_begin, p_end)`,
+    /// which are sorted by value, or to `p_default_label`.
+    void emitCaseSearch(const std::vector<SwitchCase> &p_cases, size_t p_begin,
+                        size_t p_end, int p_default_label);
+    /// @brief Tests an `if` condition that doesn't change in `p_loop` once
+    /// before it, and generates a version of the loop for either value.
+    /// @return Whether `p_loop` has been generated.
+    bool tryUnswitching(AstNode &p_loop);
+    /// @brief Swaps `p_outer` with the loop nested in it if that makes the
+    /// inner loop walk rows of arrays rather than columns.
+    /// @return Whether `p_outer` has been generated.
+    bool tryInterchange(ForNode &p_outer);
+    /// @brief Tiles the two innermost loops of a perfect nest of up to three
+    /// loops when the arrays it walks don't fit in the cache, so that it
+    /// works on blocks that do.
+    /// @return Whether `p_outermost` has been generated.
+    bool tryTiling(ForNode &p_outermost);
+    /// @brief Generates the header of `p_loops` up to their bodies; the
+    /// header is aligned unless `p_body` contains a loop.
+    ForLoop beginForLoop(const std::vector<ForNode *> &p_loops,
+                         AstNode &p_body);
+    void endForLoop(const ForLoop &p_for_loop);
+    /// @brief Allocates the loop variable of `p_for`.
+    SymbolEntry *declareLoopVariable(ForNode &p_for);
+    void emitRemark(const AstNode &p_node, const char *p_format, ...);
+    /// @brief Generates the declarations and the statements of
+    /// `p_compound_statement`, fusing adjacent loops where legal.
+    void generateChildNodes(CompoundStatementNode &p_compound_statement);
+    /// @brief Generates the loops of `p_loops`, which have the same bounds,
+    /// as one loop running their bodies in turn.
+    void generateForLoops(const std::vector<ForNode *> &p_loops);
+    /// @return The `for` loops starting at `p_statements[p_begin]` that can
+    /// be fused; at most one if fusion isn't legal.
+    std::vector<ForNode *>
+    findFusibleLoops(CompoundStatementNode::StmtNodes &p_statements,
+                     size_t p_begin);
+    /// @brief Leaves the address of the element (or subarray) of an array
+    /// referenced by `p_variable_ref` in `t0`.
+    void emitElementAddress(VariableReferenceNode &p_variable_ref,
+                            const SymbolEntry &p_symbol);
+    /// @brief Aligns the header of an innermost loop with `p_body`.
+    void alignLoopHeader(AstNode &p_body);
+
+    void emitCounterIncrement(const AstNode &p_node, uint32_t p_offset = 0);
+    /// @return The count of the `p_offset`-th counter of `p_node`.
+    uint32_t getCount(const AstNode &p_node, uint32_t p_offset = 0) const;
+    /// @return Whether a block executed `p_count` times should be moved out
+    /// of line.
+    bool isCold(uint32_t p_count) const;
+    /// @return Whether the code being generated is not already out of line.
+    bool canMoveOutOfLine() const;
+    /// @brief Sends the following code out of line until `endColdBlock()`.
+    void beginColdBlock();
+    void endColdBlock();
+    void flushColdBlocks();
+
+  public:
 
     int m_offset = 0; // Offset for the current function's local variables
     bool m_lhs = false; // Flag to indicate if the current expression is a left-hand side expression
@@ -0,0 +1,100 @@
+#ifndef CODEGEN_LLVM_IR_GENERATOR_H
+#define CODEGEN_LLVM_IR_GENERATOR_H
+
+#include "sema/SemanticAnalyzer.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Emits the textual LLVM IR (`.ll`) of a P program, so that it can be
+/// optimized and compiled by `opt`/`llc`/`clang` and linked with `test/io.c`.
+///
+/// Every variable lives in an `alloca` of the entry block (or a global) and
+/// is accessed by `load`/`store`; `mem2reg` promotes them to SSA values.
+/// `boolean`s are `i32`s of 0 or 1 so that all scalars but `string`s (`ptr`)
+/// and `real`s (`float`) share the same type. As in C, integer division by
+/// zero is undefined.
+class LlvmIrGenerator final : public AstNodeVisitor {
+  private:
+    std::string m_source_file_path;
+    std::string m_output_file_path;
+    /// @brief Owns the symbol entries the AST nodes are bound to.
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        m_symbol_table_of_scoping_nodes;
+    /// NOTE: `FILE` cannot be simply deleted by `delete`, so we need a custom deleter.
+    std::unique_ptr<FILE, decltype(&fclose)> m_output_file{nullptr, &fclose};
+
+    /// @brief The `ptr` operand of the storage of each variable.
+    std::unordered_map<const SymbolEntry *, std::string> m_addresses;
+    /// @brief The `alloca`s of the current function, hoisted to its entry.
+    std::string m_allocas;
+    /// @brief The body of the current function.
+    std::string m_body;
+    /// @brief The private globals of string literals.
+    std::string m_string_literals;
+    const PType *m_return_type = nullptr;
+    /// @brief The operand holding the value of the last visited expression.
+    std::string m_value;
+    bool m_is_block_terminated = false;
+    bool m_uses_concat = false;
+    int m_temp_num = 0;
+    int m_label_num = 0;
+    int m_string_num = 0;
+
+  public:
+    ~LlvmIrGenerator() = default;
+    LlvmIrGenerator(const std::string &source_file_name,
+                    const std::string &save_path,
+                    std::unordered_map<SemanticAnalyzer::AstNodeAddr,
+                                       SymbolManager::Table>
+                        &&p_symbol_table_of_scoping_nodes);
+
+    /// @return The path of the generated `.ll` file.
+    const std::string &getOutputFilePath() const { return m_output_file_path; }
+
+    void visit(ProgramNode &p_program) override;
+    void visit(DeclNode &p_decl) override;
+    void visit(VariableNode &p_variable) override;
+    void visit(ConstantValueNode &p_constant_value) override;
+    void visit(FunctionNode &p_function) override;
+    void visit(CompoundStatementNode &p_compound_statement) override;
+    void visit(PrintNode &p_print) override;
+    void visit(BinaryOperatorNode &p_bin_op) override;
+    void visit(UnaryOperatorNode &p_un_op) override;
+    void visit(FunctionInvocationNode &p_func_invocation) override;
+    void visit(VariableReferenceNode &p_variable_ref) override;
+    void visit(AssignmentNode &p_assignment) override;
+    void visit(ReadNode &p_read) override;
+    void visit(IfNode &p_if) override;
+    void visit(WhileNode &p_while) override;
+    void visit(ForNode &p_for) override;
+    void visit(ReturnNode &p_return) override;
+
+  private:
+    /// @brief Appends an instruction to the body of the current function.
+    void emit(const char *format, ...);
+    std::string newTemp();
+    std::string newLabel();
+    /// @brief Terminates the current block by falling through if needed.
+    void startBlock(const std::string &p_label);
+    void emitTerminator(const std::string &p_instruction);
+
+    void beginFunction();
+    /// @brief Writes the current function out with its `alloca`s hoisted.
+    void endFunction(const std::string &p_header);
+
+    /// @return The operand of the address the reference designates.
+    std::string emitAddress(VariableReferenceNode &p_variable_ref);
+    /// @brief Converts `m_value` from `p_from` to `p_to`.
+    void emitCoercion(const PType &p_from, const PType &p_to);
+    /// @return An `i1` operand that holds whether `p_condition` is true.
+    std::string emitCondition(ExpressionNode &p_condition);
+    std::string addStringLiteral(const char *p_string);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef CODEGEN_PROFILE_H
+#define CODEGEN_PROFILE_H
+
+#include "visitor/AstNodeVisitor.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AstNode;
+
+/// @brief Numbers the execution counters of a program.
+///
+/// Every function (including `main`) gets a counter for its entry, every
+/// `if` one for its entry and one for its `then` body, every loop one for its
+/// body and every call site one for the call edge. The counters are numbered
+/// in source order, independently of how the code is laid out, so that an
+/// instrumented build and a build using its profile agree on them.
+class ProfileLayout final : public AstNodeVisitor {
+  public:
+    enum class CounterKind : uint8_t {
+        kFunctionEntry,
+        kIfEntry,
+        kIfThen,
+        kLoopBody,
+        kCallEdge
+    };
+
+    static constexpr uint32_t kNoCounter = UINT32_MAX;
+
+  private:
+    struct Counter {
+        CounterKind kind;
+        uint32_t line;
+        uint32_t col;
+    };
+
+    std::vector<Counter> m_counters;
+    /// @brief The first counter of each node; an `if` owns two in a row.
+    std::unordered_map<const AstNode *, uint32_t> m_first_counters;
+
+  public:
+    ~ProfileLayout() = default;
+    ProfileLayout() = default;
+
+    uint32_t getNumCounters() const {
+        return static_cast<uint32_t>(m_counters.size());
+    }
+    /// @return The first counter of `p_node`, or `kNoCounter`.
+    uint32_t getCounter(const AstNode &p_node) const;
+    /// @brief Identifies the layout so that a stale profile can be rejected.
+    uint32_t getChecksum() const;
+
+    void visit(ProgramNode &p_program) override;
+    void visit(FunctionNode &p_function) override;
+    void visit(CompoundStatementNode &p_compound_statement) override;
+    void visit(PrintNode &p_print) override;
+    void visit(BinaryOperatorNode &p_bin_op) override;
+    void visit(UnaryOperatorNode &p_un_op) override;
+    void visit(FunctionInvocationNode &p_func_invocation) override;
+    void visit(VariableReferenceNode &p_variable_ref) override;
+    void visit(AssignmentNode &p_assignment) override;
+    void visit(ReadNode &p_read) override;
+    void visit(IfNode &p_if) override;
+    void visit(WhileNode &p_while) override;
+    void visit(ForNode &p_for) override;
+    void visit(ReturnNode &p_return) override;
+
+  private:
+    void addCounters(const AstNode &p_node, CounterKind p_kind,
+                     uint32_t p_count = 1);
+};
+
+/// @brief The counters dumped by an instrumented program at exit.
+///
+/// The file is plain text: a `P profile 1` header, a `checksum` and a
+/// `counters` line, then one count per line.
+class ProfileData {
+  private:
+    std::vector<uint32_t> m_counts;
+
+  public:
+    ~ProfileData() = default;
+    ProfileData() = default;
+
+    /// @return `false` if the file can't be read or was dumped by a build
+    /// with another layout; see `p_error`.
+    bool load(const std::string &p_path, const ProfileLayout &p_layout,
+              std::string &p_error);
+
+    bool empty() const { return m_counts.empty(); }
+    /// @return The count of `p_counter`, or 0 if there's no such counter.
+    uint32_t getCount(uint32_t p_counter) const {
+        return p_counter < m_counts.size() ? m_counts[p_counter] : 0;
+    }
+};
+
+#endif
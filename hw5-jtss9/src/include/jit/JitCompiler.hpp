@@ -0,0 +1,123 @@
+#ifndef JIT_JIT_COMPILER_H
+#define JIT_JIT_COMPILER_H
+
+#include "jit/X86Emitter.hpp"
+#include "sema/SemanticAnalyzer.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief Lowers a semantically valid AST straight to x86-64 machine code and
+/// runs it in-process. Like `CodeGenerator`, the result of every expression is
+/// evaluated on a stack machine, except that the top of the stack is cached in
+/// `rax` (`eax` for `integer`/`boolean`, the bits of a `real`).
+///
+/// The runtime functions of `test/io.c` are bound as native calls.
+class JitCompiler final : public AstNodeVisitor {
+  private:
+    /// @brief Owns the symbol entries the AST nodes are bound to.
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        m_symbol_table_of_scoping_nodes;
+
+    X86Emitter m_emitter;
+    /// @brief Globals and string literals; addressed RIP-relative.
+    std::vector<uint8_t> m_data;
+    /// @brief Pointers in the data area to be relocated at load time; pairs of
+    /// the offset of the pointer and the offset it points to.
+    std::vector<std::pair<uint32_t, uint32_t>> m_data_relocations;
+    /// @brief Strings created at run time by `+`; they live as long as the
+    /// compiler.
+    std::deque<std::string> m_string_pool;
+
+    std::unordered_map<const SymbolEntry *, X86Emitter::Label>
+        m_function_labels;
+    X86Emitter::Label m_main_label = 0;
+    X86Emitter::Label m_return_label = 0;
+    const PType *m_return_type = nullptr;
+    /// @brief The bytes of locals in the current frame.
+    int32_t m_frame_size = 0;
+    /// @brief The number of 8-byte slots pushed onto the native stack by the
+    /// expression being evaluated; keeps calls 16-byte aligned.
+    int32_t m_stack_depth = 0;
+
+    std::string m_error;
+
+  public:
+    ~JitCompiler() = default;
+    JitCompiler(std::unordered_map<SemanticAnalyzer::AstNodeAddr,
+                                   SymbolManager::Table>
+                    &&p_symbol_table_of_scoping_nodes);
+
+    /// @return Whether the program has been compiled; see `getError()`.
+    bool hasError() const { return !m_error.empty(); }
+    const std::string &getError() const { return m_error; }
+    size_t getCodeSize() const { return m_emitter.getCode().size(); }
+
+    /// @brief Loads the compiled program into executable memory and calls
+    /// `main`.
+    /// @return `false` if the program can't be run on this host.
+    bool run();
+
+    void visit(ProgramNode &p_program) override;
+    void visit(DeclNode &p_decl) override;
+    void visit(VariableNode &p_variable) override;
+    void visit(ConstantValueNode &p_constant_value) override;
+    void visit(FunctionNode &p_function) override;
+    void visit(CompoundStatementNode &p_compound_statement) override;
+    void visit(PrintNode &p_print) override;
+    void visit(BinaryOperatorNode &p_bin_op) override;
+    void visit(UnaryOperatorNode &p_un_op) override;
+    void visit(FunctionInvocationNode &p_func_invocation) override;
+    void visit(VariableReferenceNode &p_variable_ref) override;
+    void visit(AssignmentNode &p_assignment) override;
+    void visit(ReadNode &p_read) override;
+    void visit(IfNode &p_if) override;
+    void visit(WhileNode &p_while) override;
+    void visit(ForNode &p_for) override;
+    void visit(ReturnNode &p_return) override;
+
+  private:
+    void fail(const std::string &p_message);
+
+    X86Emitter::Label getFunctionLabel(const SymbolEntry *p_entry);
+    /// @return The position of the frame size to be patched by
+    /// `emitEpilogue()`.
+    size_t emitPrologue();
+    void emitEpilogue(size_t p_frame_size_position);
+
+    void pushRax();
+    void popReg(Reg p_reg);
+    /// @brief Calls a host function with `rsp` aligned as the SysV ABI
+    /// requires.
+    void callHost(const void *p_function);
+
+    /// @brief Allocates `p_size` bytes in the data area.
+    /// @return The offset of the allocation.
+    uint32_t allocateData(size_t p_size);
+    /// @brief Allocates `p_size` bytes in the current frame.
+    /// @return The offset of the allocation from `rbp`.
+    int32_t allocateLocal(size_t p_size);
+
+    /// @brief Leaves the address of the storage of `p_entry` in `p_dst`.
+    void emitBaseAddress(Reg p_dst, const SymbolEntry &p_entry);
+    /// @brief Leaves the address the reference designates in `rax`.
+    void emitAddress(VariableReferenceNode &p_variable_ref,
+                     const SymbolEntry &p_entry);
+    /// @brief Converts `rax` from `p_from` to `p_to`.
+    void emitCoercion(const PType &p_from, const PType &p_to);
+    /// @brief Leaves the value of `p_constant` in `rax`.
+    void emitConstant(const Constant &p_constant);
+    void emitLoad(Reg p_dst, Reg p_base, int32_t p_disp, const PType &p_type);
+    void emitStore(Reg p_base, int32_t p_disp, Reg p_src, const PType &p_type);
+    void emitCondition(ExpressionNode &p_condition,
+                       X86Emitter::Label p_false_label);
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef JIT_X86_EMITTER_H
+#define JIT_X86_EMITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// @brief The general purpose registers that need no REX.R/REX.B prefix.
+enum class Reg : uint8_t { kRax, kRcx, kRdx, kRbx, kRsp, kRbp, kRsi, kRdi };
+
+/// @brief The `tttn` encoding of the x86 condition codes.
+enum class Cond : uint8_t {
+    kBelow = 0x2,
+    kAboveOrEqual = 0x3,
+    kEqual = 0x4,
+    kNotEqual = 0x5,
+    kBelowOrEqual = 0x6,
+    kAbove = 0x7,
+    kLess = 0xc,
+    kGreaterOrEqual = 0xd,
+    kLessOrEqual = 0xe,
+    kGreater = 0xf
+};
+
+/// @brief Encodes the handful of x86-64 instructions used by `JitCompiler`
+/// into a plain byte buffer. Memory operands are always `[base + disp32]` so
+/// that the encoding doesn't depend on the value of the displacement.
+class X86Emitter {
+  public:
+    using Label = size_t;
+
+    /// @brief A `disp32` of a RIP-relative `lea` that refers to the data area,
+    /// whose address is only known when the code is loaded.
+    struct DataFixup {
+        size_t position;
+        uint32_t data_offset;
+    };
+
+  private:
+    /// @brief `SIZE_MAX` until bound.
+    std::vector<size_t> m_label_positions;
+    /// @brief The position of each `rel32` paired with the label it refers to.
+    std::vector<std::pair<size_t, Label>> m_label_fixups;
+    std::vector<DataFixup> m_data_fixups;
+    std::vector<uint8_t> m_code;
+
+  public:
+    ~X86Emitter() = default;
+    X86Emitter() = default;
+
+    const std::vector<uint8_t> &getCode() const { return m_code; }
+    const std::vector<DataFixup> &getDataFixups() const { return m_data_fixups; }
+    size_t getPosition() const { return m_code.size(); }
+
+    Label newLabel();
+    void bind(Label p_label);
+    /// @note Only valid once `p_label` is bound.
+    size_t getLabelPosition(Label p_label) const {
+        return m_label_positions[p_label];
+    }
+    /// @brief Patches every `rel32` that refers to a label.
+    /// @return `false` if any of the labels is never bound.
+    bool resolveLabels();
+
+    void push(Reg p_reg);
+    void pop(Reg p_reg);
+    void leave();
+    void ret();
+
+    void movRegReg32(Reg p_dst, Reg p_src);
+    void movRegReg64(Reg p_dst, Reg p_src);
+    void movRegImm32(Reg p_dst, uint32_t p_imm);
+    void movRegImm64(Reg p_dst, uint64_t p_imm);
+    void load32(Reg p_dst, Reg p_base, int32_t p_disp);
+    void load64(Reg p_dst, Reg p_base, int32_t p_disp);
+    void store32(Reg p_base, int32_t p_disp, Reg p_src);
+    void store64(Reg p_base, int32_t p_disp, Reg p_src);
+    void lea(Reg p_dst, Reg p_base, int32_t p_disp);
+    /// @brief `lea p_dst, [p_base + p_index * p_scale]`
+    void leaIndexed(Reg p_dst, Reg p_base, Reg p_index, uint8_t p_scale);
+    /// @brief `lea p_dst, [rip + disp32]` referring to `p_data_offset` of the
+    /// data area.
+    void leaData(Reg p_dst, uint32_t p_data_offset);
+    void movsxd(Reg p_dst, Reg p_src);
+
+    void add32(Reg p_dst, Reg p_src);
+    void sub32(Reg p_dst, Reg p_src);
+    void imul32(Reg p_dst, Reg p_src);
+    void imul32(Reg p_dst, Reg p_src, int32_t p_imm);
+    void and32(Reg p_dst, Reg p_src);
+    void or32(Reg p_dst, Reg p_src);
+    void xor32(Reg p_dst, int32_t p_imm);
+    void cmp32(Reg p_lhs, Reg p_rhs);
+    void cmp32(Reg p_lhs, int32_t p_imm);
+    void test32(Reg p_lhs, Reg p_rhs);
+    void neg32(Reg p_reg);
+    void addMem32(Reg p_base, int32_t p_disp, int32_t p_imm);
+    void addRsp(int32_t p_imm);
+    /// @return The position of the `imm32`, so that it can be patched once the
+    /// frame size is known.
+    size_t subRsp(int32_t p_imm);
+    void patch32(size_t p_position, uint32_t p_value);
+    /// @brief `cdq; idiv p_divisor`
+    void idiv32(Reg p_divisor);
+    /// @brief `setcc al; movzx eax, al`
+    void setcc(Cond p_cond);
+
+    void jmp(Label p_label);
+    void jcc(Cond p_cond, Label p_label);
+    void call(Label p_label);
+    void callReg(Reg p_reg);
+    /// @brief `mov rsi, p_src; mov rdi, p_dst; mov ecx, p_size; rep movsb`
+    void copyBytes(Reg p_dst, Reg p_src, uint32_t p_size);
+
+    // SSE: the bits of a `real` travel in the low 32 bits of a GPR.
+    void movdToXmm(uint8_t p_xmm, Reg p_src);
+    void movdFromXmm(Reg p_dst, uint8_t p_xmm);
+    /// @brief `addss`, `subss`, `mulss` or `divss` by the second opcode byte.
+    void scalarSingle(uint8_t p_opcode, uint8_t p_dst, uint8_t p_src);
+    void ucomiss(uint8_t p_lhs, uint8_t p_rhs);
+    void cvtsi2ss(uint8_t p_dst, Reg p_src);
+
+    static constexpr uint8_t kAddss = 0x58;
+    static constexpr uint8_t kMulss = 0x59;
+    static constexpr uint8_t kSubss = 0x5c;
+    static constexpr uint8_t kDivss = 0x5e;
+
+  private:
+    void emit8(uint8_t p_byte) { m_code.push_back(p_byte); }
+    void emit32(uint32_t p_value);
+    void emitRexW() { emit8(0x48); }
+    void emitModRm(uint8_t p_mod, uint8_t p_reg, uint8_t p_rm);
+    /// @brief ModRM (and SIB for `rsp`) of `[p_base + disp32]`.
+    void emitMemory(uint8_t p_reg, Reg p_base, int32_t p_disp);
+    void emitRel32(Label p_label);
+};
+
+#endif
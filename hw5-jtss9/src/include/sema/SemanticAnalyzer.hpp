@@ -4,7 +4,7 @@
 #include "sema/ErrorPrinter.hpp"
 #include "sema/SymbolTable.hpp"
 #include "visitor/AstNodeInclude.hpp"
-#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/StaticVisitor.hpp"
 
 #include <cstdint>
 #include <cstdio>
@@ -12,7 +12,7 @@
 #include <stack>
 #include <unordered_map>
 
-class SemanticAnalyzer final : public AstNodeVisitor {
+class SemanticAnalyzer final : public StaticVisitor<SemanticAnalyzer> {
   public:
     using AstNodeAddr = const AstNode *;
 
@@ -55,23 +55,23 @@ class SemanticAnalyzer final : public AstNodeVisitor {
     SemanticAnalyzer(const bool p_opt_dmp, std::FILE *p_error_stream = stderr)
         : m_symbol_manager(p_opt_dmp), m_error_printer(p_error_stream) {}
 
-    void visit(ProgramNode &p_program) override;
-    void visit(DeclNode &p_decl) override;
-    void visit(VariableNode &p_variable) override;
-    void visit(ConstantValueNode &p_constant_value) override;
-    void visit(FunctionNode &p_function) override;
-    void visit(CompoundStatementNode &p_compound_statement) override;
-    void visit(PrintNode &p_print) override;
-    void visit(BinaryOperatorNode &p_bin_op) override;
-    void visit(UnaryOperatorNode &p_un_op) override;
-    void visit(FunctionInvocationNode &p_func_invocation) override;
-    void visit(VariableReferenceNode &p_variable_ref) override;
-    void visit(AssignmentNode &p_assignment) override;
-    void visit(ReadNode &p_read) override;
-    void visit(IfNode &p_if) override;
-    void visit(WhileNode &p_while) override;
-    void visit(ForNode &p_for) override;
-    void visit(ReturnNode &p_return) override;
+    void visit(ProgramNode &p_program);
+    void visit(DeclNode &p_decl);
+    void visit(VariableNode &p_variable);
+    void visit(ConstantValueNode &p_constant_value);
+    void visit(FunctionNode &p_function);
+    void visit(CompoundStatementNode &p_compound_statement);
+    void visit(PrintNode &p_print);
+    void visit(BinaryOperatorNode &p_bin_op);
+    void visit(UnaryOperatorNode &p_un_op);
+    void visit(FunctionInvocationNode &p_func_invocation);
+    void visit(VariableReferenceNode &p_variable_ref);
+    void visit(AssignmentNode &p_assignment);
+    void visit(ReadNode &p_read);
+    void visit(IfNode &p_if);
+    void visit(WhileNode &p_while);
+    void visit(ForNode &p_for);
+    void visit(ReturnNode &p_return);
 
     bool hasError() const { return m_has_error; }
 
@@ -88,8 +88,8 @@ class SemanticAnalyzer final : public AstNodeVisitor {
     SymbolEntry::KindEnum determineVarKind(
         const VariableNode &p_var_node) const;
 
-    bool isShadowingLoopVar(const std::string& p_name) const;
-    bool isRedeclaringSymbol(const std::string& p_name) const;
+    bool isShadowingLoopVar(IdentifierId p_name) const;
+    bool isRedeclaringSymbol(IdentifierId p_name) const;
 
     /// @note Since reporting errors on arguments requires information specific
     /// to such arguments, we report errors inside this function.
@@ -98,8 +98,7 @@ class SemanticAnalyzer final : public AstNodeVisitor {
         const FunctionInvocationNode::ExprNodes &p_arguments);
     /// @note Since there are multiple kinds of errors that can be reported on
     /// the lvalue, we report errors inside this function.
-    bool analyzeAssignmentLvalue(const AssignmentNode &p_assignment,
-                                  const SymbolManager &p_symbol_manager);
+    bool analyzeAssignmentLvalue(const AssignmentNode &p_assignment);
     /// @note Since there are multiple kinds of errors that can be reported on
     /// the expression, we report errors inside this function.
     bool analyzeAssignmentExpr(const AssignmentNode &p_assignment);
@@ -4,6 +4,7 @@
 #include "AST/constant.hpp"
 #include "AST/PType.hpp"
 #include "AST/function.hpp"
+#include "util/StringInterner.hpp"
 
 #include <cstdint>
 #include <cstddef>
@@ -50,30 +51,38 @@ class SymbolEntry {
     };
 
   private:
-    const std::string &m_name;
+    IdentifierId m_name;
     KindEnum m_kind;
     size_t m_level;
     const PType *m_p_type;
     Attribute m_attribute;
     int m_offset = 0; // Offset for the symbol in the current scope
+    /// @brief The entry of the same name this one hides while its scope is
+    /// pushed; maintained by `SymbolManager`.
+    SymbolEntry *m_shadowed = nullptr;
+
+    friend class SymbolManager;
 
   public:
     ~SymbolEntry() = default;
 
-    SymbolEntry(const std::string &p_name, const KindEnum p_kind,
+    SymbolEntry(const IdentifierId p_name, const KindEnum p_kind,
                 const size_t p_level, const PType *const p_p_type,
                 const Constant *const p_constant)
         : m_name(p_name), m_kind(p_kind), m_level(p_level), m_p_type(p_p_type),
           m_attribute(p_constant) {}
 
-    SymbolEntry(const std::string &p_name, const KindEnum p_kind,
+    SymbolEntry(const IdentifierId p_name, const KindEnum p_kind,
                 const size_t p_level, const PType *const p_p_type,
                 const FunctionNode::DeclNodes *const p_parameters)
         : m_name(p_name), m_kind(p_kind), m_level(p_level), m_p_type(p_p_type),
           m_attribute(p_parameters) {}
 
-    const std::string &getName() const { return m_name; }
-    const char *getNameCString() const { return m_name.c_str(); }
+    IdentifierId getNameId() const { return m_name; }
+    const std::string &getName() const {
+        return StringInterner::identifiers().getName(m_name);
+    }
+    const char *getNameCString() const { return getName().c_str(); }
 
     const KindEnum getKind() const { return m_kind; }
 
@@ -95,14 +104,16 @@ class SymbolTable {
     ~SymbolTable() = default;
     SymbolTable() = default;
 
-    /// @return `nullptr` if not found.
-    SymbolEntry *lookup(const std::string &p_name) const;
+    /// @return The entries in the order they were added.
+    const std::vector<std::unique_ptr<SymbolEntry>> &getEntries() const {
+        return m_entries;
+    }
 
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const IdentifierId p_name,
                            const SymbolEntry::KindEnum p_kind, const size_t p_level,
                            const PType *const p_p_type,
                            const Constant *const p_constant);
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const IdentifierId p_name,
                            const SymbolEntry::KindEnum p_kind, const size_t p_level,
                            const PType *const p_p_type,
                            const FunctionNode::DeclNodes *const p_parameters);
@@ -115,6 +126,9 @@ class SymbolManager {
 
   private:
     std::vector<Table> m_tables;
+    /// @brief The innermost visible entry of each name, indexed by its ID;
+    /// the entries it shadows are chained through `SymbolEntry::m_shadowed`.
+    std::vector<SymbolEntry *> m_bindings;
 
     const bool m_opt_dmp;
 
@@ -134,7 +148,7 @@ class SymbolManager {
     /// @note Knows nothing about special shadowing rules, such as the shadowing
     /// of loop variables. The caller should handle them.
     template <typename AttributeType>
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const IdentifierId p_name,
                            const SymbolEntry::KindEnum p_kind,
                            const PType *const p_p_type,
                            const AttributeType *const p_attribute);
@@ -142,13 +156,20 @@ class SymbolManager {
     /// @brief Looks up the symbol from the current table to the global table.
     /// @param p_name
     /// @return `nullptr` if not found.
-    SymbolEntry *lookup(const std::string &p_name) const;
+    SymbolEntry *lookup(IdentifierId p_name) const;
+    /// @return The symbol declared in the current scope; `nullptr` if not
+    /// found.
+    SymbolEntry *lookupCurrentScope(IdentifierId p_name) const;
 
     /// @return `nullptr` if no scope is pushed.
     const SymbolTable *getCurrentTable() const;
 
     /// @note Overflows if no scope is pushed.
     size_t getCurrentLevel() const;
+
+  private:
+    void bind(SymbolEntry &p_entry);
+    void unbind(SymbolEntry &p_entry);
 };
 
 #endif
@@ -0,0 +1,82 @@
+#ifndef SIM_ASSEMBLER_H
+#define SIM_ASSEMBLER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief The RV32IMF operations understood by the simulator, plus `min`/`max`
+/// of Zbb and Zicond. Pseudo instructions are expanded by the assembler and
+/// never appear here.
+enum class Opcode : uint8_t {
+    // RV32I
+    kLui, kAuipc, kJal, kJalr,
+    kBeq, kBne, kBlt, kBge, kBltu, kBgeu,
+    kLb, kLh, kLw, kLbu, kLhu, kSb, kSh, kSw,
+    kAddi, kSlti, kSltiu, kXori, kOri, kAndi, kSlli, kSrli, kSrai,
+    kAdd, kSub, kSll, kSlt, kSltu, kXor, kSrl, kSra, kOr, kAnd,
+    // RV32M
+    kMul, kMulh, kMulhsu, kMulhu, kDiv, kDivu, kRem, kRemu,
+    // Zbb (min/max only) and Zicond
+    kMin, kMax, kMinu, kMaxu,
+    kCzeroEqz, kCzeroNez,
+    // RV32F
+    kFlw, kFsw,
+    kFaddS, kFsubS, kFmulS, kFdivS, kFsqrtS, kFminS, kFmaxS,
+    kFsgnjS, kFsgnjnS, kFsgnjxS,
+    kFcvtWS, kFcvtWuS, kFcvtSW, kFcvtSWu, kFmvXW, kFmvWX,
+    kFeqS, kFltS, kFleS,
+    // Must be the last one.
+    kNumOpcodes
+};
+
+struct Instruction {
+    Opcode op;
+    uint8_t rd = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+    int32_t imm = 0;
+    /// @brief The line in the assembly file this instruction comes from.
+    uint32_t line = 0;
+};
+
+/// @brief A fully linked memory image produced by the `Assembler`.
+struct Program {
+    static constexpr uint32_t kTextBase = 0x00010000;
+    /// @brief Calls into this region are served by the host (see
+    /// `Simulator::kRuntimeFunctions`).
+    static constexpr uint32_t kHostCallBase = 0xfffff000;
+
+    std::vector<Instruction> text;
+    uint32_t data_base = 0;
+    std::vector<uint8_t> data;
+    std::unordered_map<std::string, uint32_t> symbols;
+    /// @brief Undefined symbols that are called; resolved to host functions.
+    std::vector<std::string> host_calls;
+};
+
+/// @brief Assembles the subset of GNU RISC-V assembly emitted by
+/// `CodeGenerator` (and hand-written code of the same flavor) into a
+/// `Program`.
+class Assembler {
+  private:
+    struct Statement;
+
+    std::string m_file_name;
+    std::string m_error;
+
+  public:
+    ~Assembler() = default;
+    explicit Assembler(const std::string &p_file_name)
+        : m_file_name(p_file_name) {}
+
+    /// @return `false` on error; see `getError()`.
+    bool assemble(const std::string &p_source, Program &p_program);
+    const std::string &getError() const { return m_error; }
+
+  private:
+    bool fail(uint32_t p_line, const std::string &p_message);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SIM_SIMULATOR_H
+#define SIM_SIMULATOR_H
+
+#include "sim/Assembler.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// @brief Interprets a `Program` on an RV32IMF hart. The runtime functions of
+/// `test/io.c` (`printInt`, `printReal`, `printString`, `readInt`,
+/// `readReal` and `dumpProfile`) are served by the host, so no RISC-V
+/// toolchain is needed.
+class Simulator {
+  public:
+    struct Statistics {
+        uint64_t retired_instructions = 0;
+        uint64_t loads = 0;
+        uint64_t stores = 0;
+        uint64_t taken_branches = 0;
+        uint64_t host_calls = 0;
+    };
+
+    static constexpr uint32_t kMemorySize = 64 * 1024 * 1024;
+
+  private:
+    const Program &m_program;
+    std::vector<uint8_t> m_memory;
+    int32_t m_x[32] = {0};
+    float m_f[32] = {0};
+    uint32_t m_pc = 0;
+    Statistics m_statistics;
+    std::string m_error;
+
+    std::FILE *m_in;
+    std::FILE *m_out;
+
+  public:
+    ~Simulator() = default;
+    /// @param p_in The stream the `read*` runtime functions read from.
+    /// @param p_out The stream the `print*` runtime functions write to.
+    Simulator(const Program &p_program, std::FILE *p_in = stdin,
+              std::FILE *p_out = stdout);
+
+    /// @brief Runs `main` until it returns.
+    /// @return `false` on a runtime fault; see `getError()`.
+    bool run();
+
+    const Statistics &getStatistics() const { return m_statistics; }
+    const std::string &getError() const { return m_error; }
+    /// @return The value `main` returned in `a0`.
+    int32_t getExitCode() const { return m_x[10]; }
+
+    /// @brief Prints the statistics in a human readable form.
+    void dumpStatistics(std::FILE *p_file) const;
+
+  private:
+    bool fault(const std::string &p_message);
+    bool checkAddress(uint32_t p_address, uint32_t p_size);
+    bool callHost(uint32_t p_address);
+};
+
+#endif
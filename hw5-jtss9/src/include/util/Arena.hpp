@@ -0,0 +1,94 @@
+#ifndef UTIL_ARENA_HPP
+#define UTIL_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief A bump-pointer allocator. The memory is only given back all at once
+/// when the arena is released, so freeing a single object is a no-op.
+class Arena {
+ public:
+  struct Stats {
+    std::size_t num_allocations = 0;
+    std::size_t num_allocated_bytes = 0;
+    std::size_t num_blocks = 0;
+    std::size_t num_reserved_bytes = 0;
+  };
+
+  static constexpr std::size_t kBlockSize = 64 * 1024;
+
+  Arena() = default;
+  ~Arena() { release(); }
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /// @return The arena the AST of the compilation unit is allocated in.
+  static Arena &ast();
+
+  /// @param p_align Must be a power of 2.
+  void *allocate(std::size_t p_size,
+                 std::size_t p_align = alignof(std::max_align_t)) {
+    ++m_stats.num_allocations;
+    m_stats.num_allocated_bytes += p_size;
+    const auto current = reinterpret_cast<std::uintptr_t>(m_current);
+    const auto aligned = (current + p_align - 1) & ~(p_align - 1);
+    if (m_current &&
+        aligned + p_size <= reinterpret_cast<std::uintptr_t>(m_end)) {
+      m_current = reinterpret_cast<char *>(aligned + p_size);
+      return reinterpret_cast<void *>(aligned);
+    }
+    return allocateInNewBlock(p_size, p_align);
+  }
+
+  /// @return A NUL-terminated copy of the first `p_length` characters of
+  /// `p_text`.
+  char *copy(const char *p_text, std::size_t p_length);
+
+  /// @brief Frees all the blocks; the objects in them aren't destroyed.
+  void release();
+
+  const Stats &getStats() const { return m_stats; }
+
+ private:
+  std::vector<char *> m_blocks;
+  char *m_current = nullptr;
+  char *m_end = nullptr;
+  Stats m_stats;
+
+  void *allocateInNewBlock(std::size_t p_size, std::size_t p_align);
+};
+
+/// @brief Allocates the elements of a standard container in the arena of the
+/// AST, so that the container needn't be destroyed to give them back. The
+/// buffers a container outgrows stay in the arena until it's released.
+template <typename T>
+class AstAllocator {
+ public:
+  using value_type = T;
+
+  AstAllocator() = default;
+  template <typename U>
+  AstAllocator(const AstAllocator<U> &) {}
+
+  T *allocate(const std::size_t p_count) {
+    return static_cast<T *>(
+        Arena::ast().allocate(p_count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, std::size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const AstAllocator<T> &, const AstAllocator<U> &) {
+  return true;
+}
+template <typename T, typename U>
+bool operator!=(const AstAllocator<T> &, const AstAllocator<U> &) {
+  return false;
+}
+
+/// @brief A list owned by a node of the AST.
+template <typename T>
+using AstVector = std::vector<T, AstAllocator<T>>;
+
+#endif  // UTIL_ARENA_HPP
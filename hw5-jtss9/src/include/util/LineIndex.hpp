@@ -0,0 +1,39 @@
+#ifndef UTIL_LINE_INDEX_HPP
+#define UTIL_LINE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief The offsets where the lines of a source start, which map an offset
+/// in the source back to its line and column.
+class LineIndex {
+ public:
+  LineIndex() = default;
+  LineIndex(const LineIndex &) = delete;
+  LineIndex &operator=(const LineIndex &) = delete;
+
+  /// @return The index of the source being compiled.
+  static LineIndex &source();
+
+  /// @brief Records the lines starting in `p_text`, which continues the
+  /// source from where the previous call left off.
+  void scan(const char *p_text, std::size_t p_length);
+
+  /// @note one-based
+  uint32_t getLine(uint32_t p_offset) const;
+  /// @note one-based
+  uint32_t getCol(uint32_t p_offset) const {
+    return p_offset - getLineStart(getLine(p_offset)) + 1;
+  }
+  /// @param p_line One-based; must be a line that has been scanned.
+  uint32_t getLineStart(uint32_t p_line) const {
+    return m_line_starts[p_line - 1];
+  }
+
+ private:
+  std::vector<uint32_t> m_line_starts{0};
+  uint32_t m_scanned_length = 0;
+};
+
+#endif  // UTIL_LINE_INDEX_HPP
@@ -0,0 +1,13 @@
+#ifndef UTIL_OUTPUT_PATH_HPP
+#define UTIL_OUTPUT_PATH_HPP
+
+#include <string>
+
+/// @return The path in `p_save_path` (the current directory if empty) of the
+/// file named after `p_source_path` with its extension, if any, replaced by
+/// `p_extension`; e.g. `out/test.S` for `../test.p`, `out` and `.S`.
+std::string getOutputPath(const std::string &p_source_path,
+                          const std::string &p_save_path,
+                          const char *p_extension);
+
+#endif  // UTIL_OUTPUT_PATH_HPP
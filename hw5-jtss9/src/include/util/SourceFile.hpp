@@ -0,0 +1,41 @@
+#ifndef UTIL_SOURCE_FILE_HPP
+#define UTIL_SOURCE_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/// @brief A source file mapped into memory.
+///
+/// flex scans a buffer in place and needs two NUL bytes after its last
+/// character, so the mapping is private and writable, and is followed by
+/// zeroed memory for those bytes.
+class SourceFile {
+ public:
+  static constexpr std::size_t kNumSentinels = 2;
+
+  SourceFile() = default;
+  ~SourceFile() { close(); }
+  SourceFile(const SourceFile &) = delete;
+  SourceFile &operator=(const SourceFile &) = delete;
+
+  /// @return The source being compiled.
+  static SourceFile &current();
+
+  /// @return Whether the file could be mapped; `p_error` says why not.
+  bool open(const char *p_path, std::string &p_error);
+  void close();
+
+  /// @brief The text followed by the sentinels, for `yy_scan_buffer()`.
+  char *getBuffer() { return m_data; }
+  std::size_t getBufferSize() const { return m_length + kNumSentinels; }
+
+  const char *getText() const { return m_data; }
+  std::size_t getLength() const { return m_length; }
+
+ private:
+  char *m_data = nullptr;
+  std::size_t m_length = 0;
+  std::size_t m_mapped_length = 0;
+};
+
+#endif  // UTIL_SOURCE_FILE_HPP
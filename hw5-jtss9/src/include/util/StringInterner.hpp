@@ -0,0 +1,55 @@
+#ifndef UTIL_STRING_INTERNER_HPP
+#define UTIL_STRING_INTERNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+/// @brief A dense number identifying a distinct identifier.
+using IdentifierId = uint32_t;
+
+/// @brief Stores each distinct identifier once and numbers them from 0 in
+/// the order they are first seen, so that names compare as integers.
+class StringInterner {
+ public:
+  static constexpr IdentifierId kNoId = UINT32_MAX;
+
+  /// @return The interner fed by the scanner.
+  static StringInterner &identifiers();
+
+  /// @return The ID of the first `p_length` characters of `p_text`.
+  IdentifierId intern(const char *p_text, std::size_t p_length);
+  IdentifierId intern(const std::string &p_name) {
+    return intern(p_name.data(), p_name.size());
+  }
+
+  /// @return `kNoId` if `p_name` has never been interned.
+  IdentifierId find(const std::string &p_name) const;
+
+  /// @note The reference stays valid as long as the interner.
+  const std::string &getName(IdentifierId p_id) const { return m_names[p_id]; }
+
+  std::size_t size() const { return m_names.size(); }
+
+ private:
+  /// @brief Hashes the names through the pointers kept as keys.
+  struct NameHash {
+    std::size_t operator()(const std::string *p_name) const {
+      return std::hash<std::string>()(*p_name);
+    }
+  };
+  struct NameEqual {
+    bool operator()(const std::string *p_lhs, const std::string *p_rhs) const {
+      return *p_lhs == *p_rhs;
+    }
+  };
+
+  /// @brief Indexed by ID; a deque doesn't move the names as it grows.
+  std::deque<std::string> m_names;
+  std::unordered_map<const std::string *, IdentifierId, NameHash, NameEqual>
+      m_ids;
+};
+
+#endif  // UTIL_STRING_INTERNER_HPP
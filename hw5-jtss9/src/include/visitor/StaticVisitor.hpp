@@ -0,0 +1,142 @@
+#ifndef VISITOR_STATIC_VISITOR_H
+#define VISITOR_STATIC_VISITOR_H
+
+#include "visitor/AstNodeInclude.hpp"
+
+#include <type_traits>
+
+/// @brief A visitor whose calls are resolved at compile time, so that the
+/// traversal can be inlined into the `visit()`s of `Derived`.
+///
+/// `Derived` derives from `StaticVisitor<Derived>` and defines `visit()` for
+/// the classes of nodes it handles; the others do nothing. A node whose class
+/// is known statically is visited directly, and one only known as an
+/// `AstNode` (or an `ExpressionNode`) goes through a switch on its kind
+/// instead of `accept()`. The children are enumerated by the `forEachChild()`
+/// of each node class, in the same order as `visitChildNodes()`.
+template <typename Derived> class StaticVisitor {
+  private:
+    /// @brief Calls `p_fn` with `p_node` cast to its class.
+    template <typename Fn> static void castToKind(AstNode &p_node, Fn &&p_fn) {
+        switch (p_node.getKind()) {
+        case NodeKind::kProgram:
+            return p_fn(static_cast<ProgramNode &>(p_node));
+        case NodeKind::kDecl:
+            return p_fn(static_cast<DeclNode &>(p_node));
+        case NodeKind::kVariable:
+            return p_fn(static_cast<VariableNode &>(p_node));
+        case NodeKind::kConstantValue:
+            return p_fn(static_cast<ConstantValueNode &>(p_node));
+        case NodeKind::kFunction:
+            return p_fn(static_cast<FunctionNode &>(p_node));
+        case NodeKind::kCompoundStatement:
+            return p_fn(static_cast<CompoundStatementNode &>(p_node));
+        case NodeKind::kPrint:
+            return p_fn(static_cast<PrintNode &>(p_node));
+        case NodeKind::kBinaryOperator:
+            return p_fn(static_cast<BinaryOperatorNode &>(p_node));
+        case NodeKind::kUnaryOperator:
+            return p_fn(static_cast<UnaryOperatorNode &>(p_node));
+        case NodeKind::kFunctionInvocation:
+            return p_fn(static_cast<FunctionInvocationNode &>(p_node));
+        case NodeKind::kVariableReference:
+            return p_fn(static_cast<VariableReferenceNode &>(p_node));
+        case NodeKind::kAssignment:
+            return p_fn(static_cast<AssignmentNode &>(p_node));
+        case NodeKind::kRead:
+            return p_fn(static_cast<ReadNode &>(p_node));
+        case NodeKind::kIf:
+            return p_fn(static_cast<IfNode &>(p_node));
+        case NodeKind::kWhile:
+            return p_fn(static_cast<WhileNode &>(p_node));
+        case NodeKind::kFor:
+            return p_fn(static_cast<ForNode &>(p_node));
+        case NodeKind::kReturn:
+            return p_fn(static_cast<ReturnNode &>(p_node));
+        }
+    }
+
+    template <typename Node>
+    using IfFinal = std::enable_if_t<std::is_final<Node>::value>;
+
+  public:
+    /// @brief Calls the `visit()` of `Derived` for the class of `p_node`.
+    ///
+    /// The switch is spelled out rather than going through `castToKind()`:
+    /// this is the function the traversal recurses through, and a lambda in
+    /// between kept it out of line, reaching `this` through memory and saving
+    /// every callee-saved register even for a leaf.
+    void dispatch(AstNode &p_node) {
+        Derived &derived = static_cast<Derived &>(*this);
+        switch (p_node.getKind()) {
+        case NodeKind::kProgram:
+            return derived.visit(static_cast<ProgramNode &>(p_node));
+        case NodeKind::kDecl:
+            return derived.visit(static_cast<DeclNode &>(p_node));
+        case NodeKind::kVariable:
+            return derived.visit(static_cast<VariableNode &>(p_node));
+        case NodeKind::kConstantValue:
+            return derived.visit(static_cast<ConstantValueNode &>(p_node));
+        case NodeKind::kFunction:
+            return derived.visit(static_cast<FunctionNode &>(p_node));
+        case NodeKind::kCompoundStatement:
+            return derived.visit(static_cast<CompoundStatementNode &>(p_node));
+        case NodeKind::kPrint:
+            return derived.visit(static_cast<PrintNode &>(p_node));
+        case NodeKind::kBinaryOperator:
+            return derived.visit(static_cast<BinaryOperatorNode &>(p_node));
+        case NodeKind::kUnaryOperator:
+            return derived.visit(static_cast<UnaryOperatorNode &>(p_node));
+        case NodeKind::kFunctionInvocation:
+            return derived.visit(static_cast<FunctionInvocationNode &>(p_node));
+        case NodeKind::kVariableReference:
+            return derived.visit(static_cast<VariableReferenceNode &>(p_node));
+        case NodeKind::kAssignment:
+            return derived.visit(static_cast<AssignmentNode &>(p_node));
+        case NodeKind::kRead:
+            return derived.visit(static_cast<ReadNode &>(p_node));
+        case NodeKind::kIf:
+            return derived.visit(static_cast<IfNode &>(p_node));
+        case NodeKind::kWhile:
+            return derived.visit(static_cast<WhileNode &>(p_node));
+        case NodeKind::kFor:
+            return derived.visit(static_cast<ForNode &>(p_node));
+        case NodeKind::kReturn:
+            return derived.visit(static_cast<ReturnNode &>(p_node));
+        }
+    }
+    template <typename Node, typename = IfFinal<Node>>
+    void dispatch(Node &p_node) {
+        static_cast<Derived *>(this)->visit(p_node);
+    }
+
+    /// @brief Dispatches each child of `p_node` in order.
+    void visitChildren(AstNode &p_node) {
+        castToKind(p_node,
+                   [this](auto &p_typed_node) { visitChildren(p_typed_node); });
+    }
+    template <typename Node, typename = IfFinal<Node>>
+    void visitChildren(Node &p_node) {
+        p_node.forEachChild([this](auto &p_child) { dispatch(p_child); });
+    }
+
+    void visit(ProgramNode &p_program) {}
+    void visit(DeclNode &p_decl) {}
+    void visit(VariableNode &p_variable) {}
+    void visit(ConstantValueNode &p_constant_value) {}
+    void visit(FunctionNode &p_function) {}
+    void visit(CompoundStatementNode &p_compound_statement) {}
+    void visit(PrintNode &p_print) {}
+    void visit(BinaryOperatorNode &p_bin_op) {}
+    void visit(UnaryOperatorNode &p_un_op) {}
+    void visit(FunctionInvocationNode &p_func_invocation) {}
+    void visit(VariableReferenceNode &p_variable_ref) {}
+    void visit(AssignmentNode &p_assignment) {}
+    void visit(ReadNode &p_read) {}
+    void visit(IfNode &p_if) {}
+    void visit(WhileNode &p_while) {}
+    void visit(ForNode &p_for) {}
+    void visit(ReturnNode &p_return) {}
+};
+
+#endif
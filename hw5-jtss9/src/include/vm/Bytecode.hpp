@@ -0,0 +1,201 @@
+#ifndef VM_BYTECODE_H
+#define VM_BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief How the operands `a`, `b` and `c` of an instruction are used.
+/// `bx` is `b | c << 16`; offsets of jumps are relative to the next
+/// instruction.
+enum class OperandFormat : uint8_t {
+    kNone,
+    kA,                  ///< R[a]
+    kAB,                 ///< R[a], R[b]
+    kABC,                ///< R[a], R[b], R[c]
+    kABImm,              ///< R[a], R[b], signed c
+    kAImm,               ///< R[a], signed bx
+    kAConst,             ///< R[a], K[bx]
+    kAGlobal,            ///< R[a], G[bx]
+    kImmGlobal,          ///< signed a, G[bx]
+    kLocalIndexed,       ///< R[a], R[b + R[c]]
+    kGlobalIndexed,      ///< R[a], G[b + R[c]]
+    kCopy,               ///< R[a..a+c), R[b..b+c)
+    kGlobalCopy,         ///< R[a..a+c), G[b..b+c)
+    kCopyIndexed,        ///< R[a..a+n), R[b+R[c]..), n in the next kExtra
+    kGlobalCopyIndexed,  ///< R[a..a+n), G[b+R[c]..), n in the next kExtra
+    kExtra,              ///< bx
+    kJump,               ///< signed bx
+    kAJump,              ///< R[a], signed bx
+    kABJump,             ///< R[a], R[b], signed c
+    kAImmJump,           ///< R[a], signed b, signed c
+    kCall,               ///< R[a] (the first argument), F[b]
+};
+
+// clang-format off
+/// The instructions after `kReadReal` are superinstructions, which are only
+/// formed from the others by `BytecodeCompiler`.
+#define BYTECODE_OPCODES(X)                                                    \
+    X(kMove, kAB)                                                              \
+    X(kLoadInt, kAImm)                                                         \
+    X(kLoadConst, kAConst)                                                     \
+    X(kLoadGlobal, kAGlobal)                                                   \
+    X(kStoreGlobal, kAGlobal)                                                  \
+    X(kLoadIndexed, kLocalIndexed)                                             \
+    X(kStoreIndexed, kLocalIndexed)                                            \
+    X(kLoadGlobalIndexed, kGlobalIndexed)                                      \
+    X(kStoreGlobalIndexed, kGlobalIndexed)                                     \
+    X(kCopy, kCopy)                                                            \
+    X(kCopyGlobal, kGlobalCopy)                                                \
+    X(kCopyIndexed, kCopyIndexed)                                              \
+    X(kCopyGlobalIndexed, kGlobalCopyIndexed)                                  \
+    X(kExtra, kExtra)                                                          \
+    X(kAddInt, kABC)                                                           \
+    X(kSubInt, kABC)                                                           \
+    X(kMulInt, kABC)                                                           \
+    X(kDivInt, kABC)                                                           \
+    X(kModInt, kABC)                                                           \
+    X(kNegInt, kAB)                                                            \
+    X(kAddReal, kABC)                                                          \
+    X(kSubReal, kABC)                                                          \
+    X(kMulReal, kABC)                                                          \
+    X(kDivReal, kABC)                                                          \
+    X(kNegReal, kAB)                                                           \
+    X(kIntToReal, kAB)                                                         \
+    X(kLessInt, kABC)                                                          \
+    X(kLessEqualInt, kABC)                                                     \
+    X(kEqualInt, kABC)                                                         \
+    X(kNotEqualInt, kABC)                                                      \
+    X(kLessReal, kABC)                                                         \
+    X(kLessEqualReal, kABC)                                                    \
+    X(kEqualReal, kABC)                                                        \
+    X(kNotEqualReal, kABC)                                                     \
+    X(kAnd, kABC)                                                              \
+    X(kOr, kABC)                                                               \
+    X(kNot, kAB)                                                               \
+    X(kConcat, kABC)                                                           \
+    X(kJump, kJump)                                                            \
+    X(kJumpIfFalse, kAJump)                                                    \
+    X(kCall, kCall)                                                            \
+    X(kReturn, kA)                                                             \
+    X(kReturnVoid, kNone)                                                      \
+    X(kPrintInt, kA)                                                           \
+    X(kPrintReal, kA)                                                          \
+    X(kPrintString, kA)                                                        \
+    X(kReadInt, kA)                                                            \
+    X(kReadReal, kA)                                                           \
+    X(kAddIntImm, kABImm)                                                      \
+    X(kMulIntImm, kABImm)                                                      \
+    X(kLessIntImm, kABImm)                                                     \
+    X(kLessEqualIntImm, kABImm)                                                \
+    X(kGreaterIntImm, kABImm)                                                  \
+    X(kGreaterEqualIntImm, kABImm)                                             \
+    X(kEqualIntImm, kABImm)                                                    \
+    X(kNotEqualIntImm, kABImm)                                                 \
+    X(kJumpIfNotLess, kABJump)                                                 \
+    X(kJumpIfNotLessEqual, kABJump)                                            \
+    X(kJumpIfNotEqual, kABJump)                                                \
+    X(kJumpIfEqual, kABJump)                                                   \
+    X(kJumpIfNotLessImm, kAImmJump)                                            \
+    X(kJumpIfNotLessEqualImm, kAImmJump)                                       \
+    X(kJumpIfNotGreaterImm, kAImmJump)                                         \
+    X(kJumpIfNotGreaterEqualImm, kAImmJump)                                    \
+    X(kJumpIfNotEqualImm, kAImmJump)                                           \
+    X(kJumpIfEqualImm, kAImmJump)                                              \
+    X(kIncGlobal, kImmGlobal)
+// clang-format on
+
+enum class BytecodeOp : uint16_t {
+#define BYTECODE_OPCODE_ENUM(name, format) name,
+    BYTECODE_OPCODES(BYTECODE_OPCODE_ENUM)
+#undef BYTECODE_OPCODE_ENUM
+};
+
+constexpr size_t kNumBytecodeOps = 0
+#define BYTECODE_OPCODE_COUNT(name, format) +1
+    BYTECODE_OPCODES(BYTECODE_OPCODE_COUNT)
+#undef BYTECODE_OPCODE_COUNT
+    ;
+
+OperandFormat getOperandFormat(BytecodeOp p_op);
+const char *getOpcodeName(BytecodeOp p_op);
+
+/// @brief A fixed-width instruction of the register machine. The registers
+/// `R` of a function are numbered from its first parameter.
+struct BytecodeInstruction {
+    BytecodeOp op;
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+
+    static BytecodeInstruction make(const BytecodeOp p_op, const uint16_t p_a = 0,
+                            const uint16_t p_b = 0, const uint16_t p_c = 0) {
+        return BytecodeInstruction{p_op, p_a, p_b, p_c};
+    }
+    static BytecodeInstruction makeBx(const BytecodeOp p_op, const uint16_t p_a,
+                              const uint32_t p_bx) {
+        return BytecodeInstruction{p_op, p_a, static_cast<uint16_t>(p_bx),
+                           static_cast<uint16_t>(p_bx >> 16)};
+    }
+
+    uint32_t bx() const { return b | static_cast<uint32_t>(c) << 16; }
+    int32_t sbx() const { return static_cast<int32_t>(bx()); }
+    int16_t sa() const { return static_cast<int16_t>(a); }
+    int16_t sb() const { return static_cast<int16_t>(b); }
+    int16_t sc() const { return static_cast<int16_t>(c); }
+};
+
+/// @brief A compiled P program: the unit that is serialized to a `.pbc` file
+/// and run by `Interpreter`.
+struct BytecodeModule {
+    struct Constant {
+        enum class Kind : uint8_t { kInteger, kReal, kString };
+
+        Kind kind = Kind::kInteger;
+        int32_t integer = 0;
+        float real = 0;
+        std::string string;
+    };
+
+    struct Function {
+        std::string name;
+        /// @brief The number of registers taken by the parameters.
+        uint16_t num_parameters = 0;
+        uint16_t frame_size = 0;
+        /// @brief The range of the function in `code`.
+        uint32_t entry = 0;
+        uint32_t length = 0;
+    };
+
+    /// @brief `line` applies from `pc` to the `pc` of the next entry.
+    struct LineEntry {
+        uint32_t pc;
+        uint32_t line;
+    };
+
+    std::vector<Constant> constants;
+    std::vector<Function> functions;
+    std::vector<BytecodeInstruction> code;
+    std::vector<LineEntry> lines;
+    uint32_t num_globals = 0;
+    uint32_t main_function = 0;
+
+    /// @return The source line of the instruction at `p_pc`, or 0.
+    uint32_t getLine(uint32_t p_pc) const;
+
+    /// @brief Checks that every operand is in range, so that the interpreter
+    /// only has to check what depends on the values at run time.
+    bool verify(std::string &p_error) const;
+
+    /// @brief Encodes the module compactly: the operands are LEB128-encoded.
+    void serialize(std::vector<uint8_t> &p_bytes) const;
+    /// @return Whether `p_bytes` holds a valid module; see `p_error` if not.
+    static bool deserialize(const std::vector<uint8_t> &p_bytes,
+                            BytecodeModule &p_module, std::string &p_error);
+
+    bool save(const std::string &p_path) const;
+    static bool load(const std::string &p_path, BytecodeModule &p_module,
+                     std::string &p_error);
+};
+
+#endif
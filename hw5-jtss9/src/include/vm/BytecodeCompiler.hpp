@@ -0,0 +1,147 @@
+#ifndef VM_BYTECODE_COMPILER_H
+#define VM_BYTECODE_COMPILER_H
+
+#include "sema/SemanticAnalyzer.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+#include "vm/Bytecode.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Compiles a semantically valid AST into a `BytecodeModule` for
+/// `Interpreter`.
+///
+/// Every local scalar lives in a register of its own and every local array
+/// in a run of registers, so most operands are read in place. An expression
+/// is evaluated into the register it's assigned to when possible, otherwise
+/// into a temporary above the locals. Each temporary is read exactly once,
+/// which lets common sequences (e.g., load-add-store of `x := x + 1`, or a
+/// comparison followed by a conditional jump) be fused into
+/// superinstructions once a function has been compiled.
+class BytecodeCompiler final : public AstNodeVisitor {
+  public:
+    using Label = uint32_t;
+
+  private:
+    static constexpr int32_t kAnyRegister = -1;
+
+    /// @brief Where a variable lives: a global or a register of the frame.
+    struct Location {
+        bool is_global;
+        uint32_t index;
+    };
+
+    /// @brief Owns the symbol entries the AST nodes are bound to.
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        m_symbol_table_of_scoping_nodes;
+
+    BytecodeModule m_module;
+    std::unordered_map<const SymbolEntry *, Location> m_locations;
+    std::unordered_map<const SymbolEntry *, uint32_t> m_function_indices;
+    std::unordered_map<std::string, uint32_t> m_constant_indices;
+    /// @brief Global constants, which are stored at the start of `main`.
+    std::vector<const VariableNode *> m_global_constants;
+
+    // The function being compiled.
+    std::vector<BytecodeInstruction> m_code;
+    /// @brief Whether each instruction of `m_code` writes a temporary to
+    /// `R[a]`.
+    std::vector<bool> m_writes_temp;
+    std::vector<uint32_t> m_label_positions;
+    std::vector<BytecodeModule::LineEntry> m_lines;
+    const PType *m_return_type = nullptr;
+    /// @brief The registers below are taken by the variables in scope.
+    uint32_t m_num_locals = 0;
+    uint32_t m_next_register = 0;
+    uint32_t m_frame_size = 0;
+
+    /// @brief The register the expression being visited should be evaluated
+    /// into, or `kAnyRegister`.
+    int32_t m_dst = kAnyRegister;
+    /// @brief The register holding the value of the last visited expression.
+    uint16_t m_result = 0;
+
+    std::string m_error;
+
+  public:
+    ~BytecodeCompiler() = default;
+    BytecodeCompiler(std::unordered_map<SemanticAnalyzer::AstNodeAddr,
+                                        SymbolManager::Table>
+                         &&p_symbol_table_of_scoping_nodes);
+
+    /// @return Whether the program has been compiled; see `getError()`.
+    bool hasError() const { return !m_error.empty(); }
+    const std::string &getError() const { return m_error; }
+    const BytecodeModule &getModule() const { return m_module; }
+
+    void visit(ProgramNode &p_program) override;
+    void visit(DeclNode &p_decl) override;
+    void visit(VariableNode &p_variable) override;
+    void visit(ConstantValueNode &p_constant_value) override;
+    void visit(FunctionNode &p_function) override;
+    void visit(CompoundStatementNode &p_compound_statement) override;
+    void visit(PrintNode &p_print) override;
+    void visit(BinaryOperatorNode &p_bin_op) override;
+    void visit(UnaryOperatorNode &p_un_op) override;
+    void visit(FunctionInvocationNode &p_func_invocation) override;
+    void visit(VariableReferenceNode &p_variable_ref) override;
+    void visit(AssignmentNode &p_assignment) override;
+    void visit(ReadNode &p_read) override;
+    void visit(IfNode &p_if) override;
+    void visit(WhileNode &p_while) override;
+    void visit(ForNode &p_for) override;
+    void visit(ReturnNode &p_return) override;
+
+  private:
+    void fail(const std::string &p_message);
+
+    void emit(const BytecodeInstruction &p_instruction);
+    Label newLabel();
+    void bind(Label p_label);
+    /// @brief Emits a jump to `p_label`, which is resolved by `endFunction()`.
+    void emitJump(BytecodeOp p_op, Label p_label, uint16_t p_a = 0);
+    void markLine(const AstNode &p_node);
+
+    void beginFunction();
+    /// @brief Forms the superinstructions, resolves the jumps and appends the
+    /// function to the module.
+    void endFunction(const std::string &p_name, uint32_t p_num_parameters);
+    void fuseSuperinstructions();
+
+    uint16_t allocateRegisters(uint32_t p_count);
+    /// @return `m_dst` if it's requested, otherwise a new temporary.
+    uint16_t getResultRegister();
+    uint32_t addConstant(const BytecodeModule::Constant &p_constant);
+    void emitConstant(uint16_t p_dst, const Constant &p_constant);
+
+    /// @return The register holding the value of `p_expr`; it's `p_dst` if
+    /// that's not `kAnyRegister`.
+    uint16_t compileExpression(ExpressionNode &p_expr,
+                               int32_t p_dst = kAnyRegister);
+    /// @brief Like `compileExpression()`, but the value is converted to
+    /// `p_type` first.
+    uint16_t compileCoerced(ExpressionNode &p_expr, const PType &p_type,
+                            int32_t p_dst = kAnyRegister);
+    /// @return Whether all indices are in-range constants; if so,
+    /// `p_offset` is the offset of the designated element.
+    bool getConstantOffset(const VariableReferenceNode &p_variable_ref,
+                           const PType &p_type, uint32_t &p_offset) const;
+    /// @return The register holding the offset of the designated element.
+    uint16_t compileElementOffset(VariableReferenceNode &p_variable_ref,
+                                  const PType &p_type);
+    /// @brief Stores to the variable the reference designates the value
+    /// compiled by `p_compile_value`, which is given the register to evaluate
+    /// into (or `kAnyRegister`) and returns the register holding the value.
+    void compileStore(
+        VariableReferenceNode &p_variable_ref,
+        const std::function<uint16_t(int32_t)> &p_compile_value);
+    /// @brief Copies the (sub-)array the reference designates to `R[p_dst]`.
+    void emitArrayCopy(VariableReferenceNode &p_variable_ref, uint16_t p_dst,
+                       uint32_t p_count);
+};
+
+#endif
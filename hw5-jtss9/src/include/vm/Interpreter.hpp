@@ -0,0 +1,56 @@
+#ifndef VM_INTERPRETER_H
+#define VM_INTERPRETER_H
+
+#include "vm/Bytecode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+/// @brief Runs a verified `BytecodeModule`. Instructions are dispatched by
+/// computed `goto` (one indirect jump per handler) where the host compiler
+/// supports labels as values, and by a `switch` otherwise.
+///
+/// Integer division by zero and overflow follow RISC-V as `--run` does.
+class Interpreter {
+  public:
+    union Value {
+        int32_t integer;
+        float real;
+        const char *string;
+    };
+
+  private:
+    struct Frame {
+        const BytecodeInstruction *return_pc;
+        Value *base;
+        const BytecodeModule::Function *function;
+    };
+
+    /// @brief The registers of all frames; 8 MiB.
+    static constexpr size_t kStackSize = size_t{1} << 20;
+
+    const BytecodeModule &m_module;
+    std::vector<Value> m_constants;
+    std::vector<Value> m_globals;
+    std::vector<Value> m_stack;
+    /// @brief Strings created at run time by `+`.
+    std::deque<std::string> m_string_pool;
+    std::string m_error;
+
+  public:
+    ~Interpreter() = default;
+    explicit Interpreter(const BytecodeModule &p_module);
+
+    /// @return Whether the program ran to the end; see `getError()`.
+    bool run();
+
+    const std::string &getError() const { return m_error; }
+
+  private:
+    bool fail(const BytecodeInstruction *p_pc, const char *p_message);
+};
+
+#endif
@@ -11,22 +11,24 @@ void AstDumper::visit(ProgramNode &p_program) {
     printIndent();
 
     std::printf("program <line: %u, col: %u> %s %s\n",
-                p_program.getLocation().line, p_program.getLocation().col,
+                p_program.getLocation().getLine(),
+                p_program.getLocation().getCol(),
                 p_program.getNameCString(), "void");
 
     m_indenter.increaseLevel();
-    p_program.visitChildNodes(*this);
+    visitChildren(p_program);
     m_indenter.decreaseLevel();
 }
 
 void AstDumper::visit(DeclNode &p_decl) {
     printIndent();
 
-    std::printf("declaration <line: %u, col: %u>\n", p_decl.getLocation().line,
-                p_decl.getLocation().col);
+    std::printf("declaration <line: %u, col: %u>\n",
+                p_decl.getLocation().getLine(),
+                p_decl.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_decl.visitChildNodes(*this);
+    visitChildren(p_decl);
     m_indenter.decreaseLevel();
 }
 
@@ -34,11 +36,12 @@ void AstDumper::visit(VariableNode &p_variable) {
     printIndent();
 
     std::printf("variable <line: %u, col: %u> %s %s\n",
-                p_variable.getLocation().line, p_variable.getLocation().col,
+                p_variable.getLocation().getLine(),
+                p_variable.getLocation().getCol(),
                 p_variable.getNameCString(), p_variable.getTypeCString());
 
     m_indenter.increaseLevel();
-    p_variable.visitChildNodes(*this);
+    visitChildren(p_variable);
     m_indenter.decreaseLevel();
 }
 
@@ -46,8 +49,8 @@ void AstDumper::visit(ConstantValueNode &p_constant_value) {
     printIndent();
 
     std::printf("constant <line: %u, col: %u> %s\n",
-                p_constant_value.getLocation().line,
-                p_constant_value.getLocation().col,
+                p_constant_value.getLocation().getLine(),
+                p_constant_value.getLocation().getCol(),
                 p_constant_value.getConstantValueCString());
 }
 
@@ -55,11 +58,12 @@ void AstDumper::visit(FunctionNode &p_function) {
     printIndent();
 
     std::printf("function declaration <line: %u, col: %u> %s %s\n",
-                p_function.getLocation().line, p_function.getLocation().col,
+                p_function.getLocation().getLine(),
+                p_function.getLocation().getCol(),
                 p_function.getNameCString(), p_function.getPrototypeCString());
 
     m_indenter.increaseLevel();
-    p_function.visitChildNodes(*this);
+    visitChildren(p_function);
     m_indenter.decreaseLevel();
 }
 
@@ -67,11 +71,11 @@ void AstDumper::visit(CompoundStatementNode &p_compound_statement) {
     printIndent();
 
     std::printf("compound statement <line: %u, col: %u>\n",
-                p_compound_statement.getLocation().line,
-                p_compound_statement.getLocation().col);
+                p_compound_statement.getLocation().getLine(),
+                p_compound_statement.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_compound_statement.visitChildNodes(*this);
+    visitChildren(p_compound_statement);
     m_indenter.decreaseLevel();
 }
 
@@ -79,10 +83,11 @@ void AstDumper::visit(PrintNode &p_print) {
     printIndent();
 
     std::printf("print statement <line: %u, col: %u>\n",
-                p_print.getLocation().line, p_print.getLocation().col);
+                p_print.getLocation().getLine(),
+                p_print.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_print.visitChildNodes(*this);
+    visitChildren(p_print);
     m_indenter.decreaseLevel();
 }
 
@@ -90,11 +95,12 @@ void AstDumper::visit(BinaryOperatorNode &p_bin_op) {
     printIndent();
 
     std::printf("binary operator <line: %u, col: %u> %s\n",
-                p_bin_op.getLocation().line, p_bin_op.getLocation().col,
+                p_bin_op.getLocation().getLine(),
+                p_bin_op.getLocation().getCol(),
                 p_bin_op.getOpCString());
 
     m_indenter.increaseLevel();
-    p_bin_op.visitChildNodes(*this);
+    visitChildren(p_bin_op);
     m_indenter.decreaseLevel();
 }
 
@@ -102,11 +108,11 @@ void AstDumper::visit(UnaryOperatorNode &p_un_op) {
     printIndent();
 
     std::printf("unary operator <line: %u, col: %u> %s\n",
-                p_un_op.getLocation().line, p_un_op.getLocation().col,
+                p_un_op.getLocation().getLine(), p_un_op.getLocation().getCol(),
                 p_un_op.getOpCString());
 
     m_indenter.increaseLevel();
-    p_un_op.visitChildNodes(*this);
+    visitChildren(p_un_op);
     m_indenter.decreaseLevel();
 }
 
@@ -114,12 +120,12 @@ void AstDumper::visit(FunctionInvocationNode &p_func_invocation) {
     printIndent();
 
     std::printf("function invocation <line: %u, col: %u> %s\n",
-                p_func_invocation.getLocation().line,
-                p_func_invocation.getLocation().col,
+                p_func_invocation.getLocation().getLine(),
+                p_func_invocation.getLocation().getCol(),
                 p_func_invocation.getNameCString());
 
     m_indenter.increaseLevel();
-    p_func_invocation.visitChildNodes(*this);
+    visitChildren(p_func_invocation);
     m_indenter.decreaseLevel();
 }
 
@@ -127,12 +133,12 @@ void AstDumper::visit(VariableReferenceNode &p_variable_ref) {
     printIndent();
 
     std::printf("variable reference <line: %u, col: %u> %s\n",
-                p_variable_ref.getLocation().line,
-                p_variable_ref.getLocation().col,
+                p_variable_ref.getLocation().getLine(),
+                p_variable_ref.getLocation().getCol(),
                 p_variable_ref.getNameCString());
 
     m_indenter.increaseLevel();
-    p_variable_ref.visitChildNodes(*this);
+    visitChildren(p_variable_ref);
     m_indenter.decreaseLevel();
 }
 
@@ -140,11 +146,11 @@ void AstDumper::visit(AssignmentNode &p_assignment) {
     printIndent();
 
     std::printf("assignment statement <line: %u, col: %u>\n",
-                p_assignment.getLocation().line,
-                p_assignment.getLocation().col);
+                p_assignment.getLocation().getLine(),
+                p_assignment.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_assignment.visitChildNodes(*this);
+    visitChildren(p_assignment);
     m_indenter.decreaseLevel();
 }
 
@@ -152,21 +158,22 @@ void AstDumper::visit(ReadNode &p_read) {
     printIndent();
 
     std::printf("read statement <line: %u, col: %u>\n",
-                p_read.getLocation().line, p_read.getLocation().col);
+                p_read.getLocation().getLine(), p_read.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_read.visitChildNodes(*this);
+    visitChildren(p_read);
     m_indenter.decreaseLevel();
 }
 
 void AstDumper::visit(IfNode &p_if) {
     printIndent();
 
-    std::printf("if statement <line: %u, col: %u>\n", p_if.getLocation().line,
-                p_if.getLocation().col);
+    std::printf("if statement <line: %u, col: %u>\n",
+                p_if.getLocation().getLine(),
+                p_if.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_if.visitChildNodes(*this);
+    visitChildren(p_if);
     m_indenter.decreaseLevel();
 }
 
@@ -174,21 +181,23 @@ void AstDumper::visit(WhileNode &p_while) {
     printIndent();
 
     std::printf("while statement <line: %u, col: %u>\n",
-                p_while.getLocation().line, p_while.getLocation().col);
+                p_while.getLocation().getLine(),
+                p_while.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_while.visitChildNodes(*this);
+    visitChildren(p_while);
     m_indenter.decreaseLevel();
 }
 
 void AstDumper::visit(ForNode &p_for) {
     printIndent();
 
-    std::printf("for statement <line: %u, col: %u>\n", p_for.getLocation().line,
-                p_for.getLocation().col);
+    std::printf("for statement <line: %u, col: %u>\n",
+                p_for.getLocation().getLine(),
+                p_for.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_for.visitChildNodes(*this);
+    visitChildren(p_for);
     m_indenter.decreaseLevel();
 }
 
@@ -196,9 +205,10 @@ void AstDumper::visit(ReturnNode &p_return) {
     printIndent();
 
     std::printf("return statement <line: %u, col: %u>\n",
-                p_return.getLocation().line, p_return.getLocation().col);
+                p_return.getLocation().getLine(),
+                p_return.getLocation().getCol());
 
     m_indenter.increaseLevel();
-    p_return.visitChildNodes(*this);
+    visitChildren(p_return);
     m_indenter.decreaseLevel();
 }
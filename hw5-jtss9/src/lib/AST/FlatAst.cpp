@@ -0,0 +1,45 @@
+#include "AST/FlatAst.hpp"
+#include "visitor/StaticVisitor.hpp"
+
+#include <algorithm>
+
+/// @brief Appends each node it visits to a `FlatAst`, then its children.
+class FlatAstBuilder final : public StaticVisitor<FlatAstBuilder> {
+  private:
+    FlatAst &m_ast;
+
+  public:
+    explicit FlatAstBuilder(FlatAst &p_ast) : m_ast(p_ast) {}
+
+    /// @brief Every class of node is laid out the same way.
+    template <typename Node> void visit(Node &p_node) {
+        const NodeId id = m_ast.size();
+        m_ast.m_kinds.push_back(p_node.getKind());
+        m_ast.m_nodes.push_back(&p_node);
+        m_ast.m_subtree_ends.push_back(0);
+        m_ast.m_ids.emplace(&p_node, id);
+
+        visitChildren(p_node);
+        m_ast.m_subtree_ends[id] = m_ast.size();
+    }
+};
+
+void FlatAst::build(AstNode &p_root) {
+    m_kinds.clear();
+    m_nodes.clear();
+    m_subtree_ends.clear();
+    m_ids.clear();
+
+    FlatAstBuilder builder(*this);
+    builder.dispatch(p_root);
+}
+
+bool FlatAst::subtreeContains(const NodeId p_id,
+                              std::initializer_list<NodeKind> p_kinds) const {
+    return std::any_of(m_kinds.begin() + p_id,
+                       m_kinds.begin() + m_subtree_ends[p_id],
+                       [&](const NodeKind p_kind) {
+                           return std::find(p_kinds.begin(), p_kinds.end(),
+                                            p_kind) != p_kinds.end();
+                       });
+}
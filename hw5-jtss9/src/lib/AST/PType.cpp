@@ -1,59 +1,25 @@
 #include "AST/PType.hpp"
+#include "AST/TypeContext.hpp"
 
 #include <cstddef>
 
-const char *kTypeString[] = {"void", "integer", "real", "boolean", "string"};
-
-// logical constness
-const char *PType::getPTypeCString() const {
-    if (!m_type_string_is_valid) {
-        m_type_string += kTypeString[static_cast<size_t>(m_type)];
-
-        if (m_dimensions.size() != 0) {
-            m_type_string += " ";
-
-            for (const auto &dim : m_dimensions) {
-                m_type_string += "[" + std::to_string(dim) + "]";
-            }
-        }
-        m_type_string_is_valid = true;
-    }
-
-    return m_type_string.c_str();
-}
-
-PType *PType::getStructElementType(const std::size_t nth) const {
+const PType *PType::getStructElementType(const std::size_t nth) const {
     if (nth > m_dimensions.size()) {
         return nullptr;
     }
-
-    auto *type_ptr = new PType(m_type);
-
-    std::vector<uint64_t> dims;
-    for (std::size_t i = nth; i < m_dimensions.size(); ++i) {
-        dims.emplace_back(m_dimensions[i]);
+    if (nth == 0) {
+        return this;
     }
-    type_ptr->setDimensions(dims);
 
-    return type_ptr;
+    std::vector<uint64_t> dims(m_dimensions.begin() + nth, m_dimensions.end());
+    return TypeContext::types().getType(m_type, std::move(dims));
 }
 
 bool PType::canCoerceTo(const PType *p_type) const {
-    // For scalars, integer can be coerced to real.
-    if (isScalar() && p_type->isScalar()) {
-        return m_type == p_type->m_type || (isInteger() && p_type->isReal());
-    }
-    // For arrays, the primitive type must be the same, as well as the dimensions.
-    if (m_type != p_type->m_type) {
-        return false;
+    // Types are interned, so equal types are the same object.
+    if (this == p_type) {
+        return true;
     }
-    if (m_dimensions.size() != p_type->m_dimensions.size()) {
-        return false;
-    }
-    for (decltype(m_dimensions.size()) i = 0; i < m_dimensions.size(); ++i) {
-        if (m_dimensions.at(i) != p_type->m_dimensions.at(i)) {
-            return false;
-        }
-    }
-    return true;
+    // For scalars, integer can be coerced to real.
+    return isInteger() && p_type->isReal();
 }
@@ -0,0 +1,62 @@
+#include "AST/TypeContext.hpp"
+
+#include <functional>
+#include <string>
+
+namespace {
+
+const char *kTypeString[] = {"void", "integer", "real", "boolean", "string"};
+
+} // namespace
+
+std::size_t TypeContext::TypeHash::operator()(const PType *p_type) const {
+    std::size_t hash = static_cast<std::size_t>(p_type->m_type);
+    for (const auto dim : p_type->m_dimensions) {
+        hash = hash * 31 + std::hash<uint64_t>()(dim);
+    }
+    return hash;
+}
+
+TypeContext::TypeContext() {
+    for (std::size_t i = 0; i < kNumPrimitiveTypes; ++i) {
+        m_scalar_types[i] =
+            intern(PType(static_cast<PType::PrimitiveTypeEnum>(i), {}));
+    }
+}
+
+TypeContext &TypeContext::types() {
+    static TypeContext context;
+    return context;
+}
+
+const PType *TypeContext::getType(const PType::PrimitiveTypeEnum p_primitive,
+                                  std::vector<uint64_t> p_dims) {
+    if (p_dims.empty()) {
+        return getType(p_primitive);
+    }
+    PType type(p_primitive, std::move(p_dims));
+    auto it = m_interned_types.find(&type);
+    if (it != m_interned_types.end()) {
+        return *it;
+    }
+    return intern(std::move(type));
+}
+
+const PType *TypeContext::intern(PType &&p_type) {
+    m_types.push_back(std::move(p_type));
+    PType &type = m_types.back();
+
+    // The error type has no name.
+    if (!type.isError()) {
+        type.m_type_string = kTypeString[static_cast<std::size_t>(type.m_type)];
+    }
+    if (!type.m_dimensions.empty()) {
+        type.m_type_string += " ";
+        for (const auto &dim : type.m_dimensions) {
+            type.m_type_string += "[" + std::to_string(dim) + "]";
+        }
+    }
+
+    m_interned_types.insert(&type);
+    return &type;
+}
@@ -1,6 +1,5 @@
 #include "AST/assignment.hpp"
 
 void AssignmentNode::visitChildNodes(AstNodeVisitor &p_visitor) {
-    m_lvalue->accept(p_visitor);
-    m_expr->accept(p_visitor);
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
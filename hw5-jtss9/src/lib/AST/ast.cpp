@@ -1,9 +1,19 @@
 #include <AST/ast.hpp>
 
+#include "util/LineIndex.hpp"
+
+uint32_t Location::getLine() const {
+    return LineIndex::source().getLine(m_offset);
+}
+
+uint32_t Location::getCol() const {
+    return LineIndex::source().getCol(m_offset);
+}
+
 // prevent the linker from complaining
 AstNode::~AstNode() {}
 
-AstNode::AstNode(const uint32_t line, const uint32_t col)
-    : location(line, col) {}
+AstNode::AstNode(const NodeKind p_kind, const Location &p_location)
+    : location(p_location), m_kind(p_kind) {}
 
 const Location &AstNode::getLocation() const { return location; }
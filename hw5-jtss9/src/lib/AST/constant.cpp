@@ -1,28 +1,33 @@
 #include "AST/constant.hpp"
 
+#include <string>
+
 static const char *kTFString[] = {"false", "true"};
 
 // logical constness
 const char *Constant::getConstantValueCString() const {
-    if (!m_constant_value_string_is_valid) {
+    if (!m_constant_value_string) {
+        std::string value_string;
         switch (m_type->getPrimitiveType()) {
         case PType::PrimitiveTypeEnum::kIntegerType:
-            m_constant_value_string = std::to_string(m_value.integer);
+            value_string = std::to_string(m_value.integer);
             break;
         case PType::PrimitiveTypeEnum::kRealType:
-            m_constant_value_string = std::to_string(m_value.real);
+            value_string = std::to_string(m_value.real);
             break;
         case PType::PrimitiveTypeEnum::kBoolType:
-            m_constant_value_string = kTFString[m_value.boolean];
+            value_string = kTFString[m_value.boolean];
             break;
         case PType::PrimitiveTypeEnum::kStringType:
+            // Already in the arena.
             m_constant_value_string = m_value.string;
-            break;
+            return m_constant_value_string;
         case PType::PrimitiveTypeEnum::kVoidType:
         default:
             break;
         }
-        m_constant_value_string_is_valid = true;
+        m_constant_value_string =
+            Arena::ast().copy(value_string.data(), value_string.size());
     }
-    return m_constant_value_string.c_str();
+    return m_constant_value_string;
 }
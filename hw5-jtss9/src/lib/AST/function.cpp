@@ -1,8 +1,6 @@
 #include "AST/function.hpp"
 #include "AST/decl.hpp"
 
-#include <algorithm>
-
 FunctionNode::DeclNodes::size_type
 FunctionNode::getParametersNum(const DeclNodes &p_parameters) {
     FunctionNode::DeclNodes::size_type num = 0;
@@ -33,27 +31,22 @@ FunctionNode::getParametersTypeString(const DeclNodes &p_parameters) {
 }
 
 const char *FunctionNode::getPrototypeCString() const {
-    if (!m_prototype_string_is_valid) {
-        m_prototype_string = m_ret_type->getPTypeCString();
+    if (!m_prototype_string) {
+        std::string prototype_string = m_ret_type->getPTypeCString();
 
-        m_prototype_string += " (";
-        m_prototype_string += getParametersTypeString(m_parameters);
-        m_prototype_string += ")";
+        prototype_string += " (";
+        prototype_string += getParametersTypeString(m_parameters);
+        prototype_string += ")";
 
-        m_prototype_string_is_valid = true;
+        m_prototype_string =
+            Arena::ast().copy(prototype_string.data(), prototype_string.size());
     }
 
-    return m_prototype_string.c_str();
+    return m_prototype_string;
 }
 
 void FunctionNode::visitChildNodes(AstNodeVisitor &p_visitor) {
-    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(p_visitor); };
-
-    for_each(m_parameters.begin(), m_parameters.end(), visit_ast_node);
-
-    if (m_body) {
-        visit_ast_node(m_body);
-    }
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
 
 void FunctionNode::visitBodyChildNodes(AstNodeVisitor &p_visitor) {
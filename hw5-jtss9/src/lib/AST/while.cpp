@@ -1,6 +1,5 @@
 #include "AST/while.hpp"
 
 void WhileNode::visitChildNodes(AstNodeVisitor &p_visitor) {
-    m_condition->accept(p_visitor);
-    m_body->accept(p_visitor);
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
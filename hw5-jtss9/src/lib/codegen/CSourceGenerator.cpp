@@ -0,0 +1,454 @@
+#include "codegen/CSourceGenerator.hpp"
+
+#include "AST/TypeContext.hpp"
+#include "util/OutputPath.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+void dumpInstructions(FILE *p_out_file, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(p_out_file, format, args);
+    va_end(args);
+}
+
+std::string mangle(const std::string &p_name) { return "p_" + p_name; }
+
+const char *getScalarCType(const PType &p_type) {
+    switch (p_type.getPrimitiveType()) {
+    case PType::PrimitiveTypeEnum::kIntegerType:
+    case PType::PrimitiveTypeEnum::kBoolType:
+        return "int";
+    case PType::PrimitiveTypeEnum::kRealType:
+        return "float";
+    case PType::PrimitiveTypeEnum::kStringType:
+        return "char *";
+    case PType::PrimitiveTypeEnum::kVoidType:
+        return "void";
+    default:
+        assert(false && "Unsupported type");
+        return "";
+    }
+}
+
+/// @return `int name[4][3]`, `char *name`, ...
+std::string getDeclarator(const PType &p_type, const std::string &p_name) {
+    std::string declarator = getScalarCType(p_type);
+    if (declarator.back() != '*') {
+        declarator += ' ';
+    }
+    declarator += p_name;
+    for (const auto dim : p_type.getDimensions()) {
+        declarator += "[" + std::to_string(dim) + "]";
+    }
+    return declarator;
+}
+
+std::string formatString(const char *p_string) {
+    std::string literal = "\"";
+    for (const char *c = p_string; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            literal += '\\';
+            literal += *c;
+        } else if (std::isprint(static_cast<unsigned char>(*c))) {
+            literal += *c;
+        } else {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\%03o",
+                     static_cast<unsigned char>(*c));
+            literal += escaped;
+        }
+    }
+    return literal + "\"";
+}
+
+std::string formatConstant(const Constant &p_constant) {
+    const PType &type = *p_constant.getTypePtr();
+    std::string literal;
+    if (type.isPrimitiveInteger()) {
+        literal = std::to_string(static_cast<int32_t>(p_constant.integer()));
+    } else if (type.isPrimitiveReal()) {
+        // 9 significant digits round-trip any `float`.
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.9g",
+                 static_cast<float>(p_constant.real()));
+        literal = buffer;
+        if (literal.find_first_of(".en") == std::string::npos) {
+            literal += ".0";
+        }
+        literal += "f";
+    } else if (type.isPrimitiveBool()) {
+        literal = p_constant.boolean() ? "1" : "0";
+    } else if (type.isPrimitiveString()) {
+        return formatString(p_constant.string());
+    }
+    return literal[0] == '-' ? "(" + literal + ")" : literal;
+}
+
+const char *getCOperator(const Operator p_op) {
+    switch (p_op) {
+    case Operator::kPlusOp:
+        return "+";
+    case Operator::kMinusOp:
+        return "-";
+    case Operator::kMultiplyOp:
+        return "*";
+    case Operator::kDivideOp:
+        return "/";
+    case Operator::kLessOp:
+        return "<";
+    case Operator::kLessOrEqualOp:
+        return "<=";
+    case Operator::kGreaterOp:
+        return ">";
+    case Operator::kGreaterOrEqualOp:
+        return ">=";
+    case Operator::kEqualOp:
+        return "==";
+    case Operator::kNotEqualOp:
+        return "!=";
+    // Both operands are always evaluated in P, so no `&&` and `||`.
+    case Operator::kAndOp:
+        return "&";
+    case Operator::kOrOp:
+        return "|";
+    default:
+        assert(false && "Unsupported binary operator");
+        return "";
+    }
+}
+
+/// @return The type both operands are converted to before the operation.
+const PType &getOperandType(const BinaryOperatorNode &p_bin_op) {
+    const auto *left_type = p_bin_op.getLeftOperand().getInferredType();
+    const auto *right_type = p_bin_op.getRightOperand().getInferredType();
+    if (left_type->isReal() || right_type->isReal()) {
+        return *TypeContext::types().getType(
+            PType::PrimitiveTypeEnum::kRealType);
+    }
+    return *left_type;
+}
+
+// clang-format off
+constexpr const char *const kCSourcePrologue =
+    "/* Generated from %s by the P compiler. */\n"
+    "#include <stdlib.h>\n"
+    "#include <string.h>\n"
+    "\n"
+    "/* The runtime in test/io.c */\n"
+    "void printInt(int value);\n"
+    "int readInt(void);\n"
+    "void printReal(float value);\n"
+    "float readReal(void);\n"
+    "void printString(char *value);\n"
+    "\n"
+    "/* Integer division as on RISC-V, which doesn't trap. */\n"
+    "static inline int rt_div(int lhs, int rhs) {\n"
+    "    if (rhs == 0) return -1;\n"
+    "    if (rhs == -1) return (int)(0u - (unsigned)lhs);\n"
+    "    return lhs / rhs;\n"
+    "}\n"
+    "\n"
+    "static inline int rt_mod(int lhs, int rhs) {\n"
+    "    if (rhs == 0) return lhs;\n"
+    "    if (rhs == -1) return 0;\n"
+    "    return lhs %% rhs;\n"
+    "}\n"
+    "\n"
+    "/* NOTE: The result is never freed. */\n"
+    "static inline char *rt_concat(const char *lhs, const char *rhs) {\n"
+    "    size_t lhs_len = strlen(lhs);\n"
+    "    size_t rhs_size = strlen(rhs) + 1;\n"
+    "    char *result = malloc(lhs_len + rhs_size);\n"
+    "    memcpy(result, lhs, lhs_len);\n"
+    "    memcpy(result + lhs_len, rhs, rhs_size);\n"
+    "    return result;\n"
+    "}\n";
+// clang-format on
+
+} // namespace
+
+CSourceGenerator::CSourceGenerator(
+    const std::string &source_file_name, const std::string &save_path,
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        &&p_symbol_table_of_scoping_nodes)
+    : m_source_file_path(source_file_name),
+      m_symbol_table_of_scoping_nodes(
+          std::move(p_symbol_table_of_scoping_nodes)) {
+    m_output_file_path = getOutputPath(source_file_name, save_path, ".c");
+    m_output_file.reset(fopen(m_output_file_path.c_str(), "w"));
+    assert(m_output_file.get() && "Failed to open output file");
+}
+
+void CSourceGenerator::emitLine(const char *format, ...) {
+    fputs(m_indenter.indent().c_str(), m_output_file.get());
+    va_list args;
+    va_start(args, format);
+    vfprintf(m_output_file.get(), format, args);
+    va_end(args);
+    fputc('\n', m_output_file.get());
+}
+
+std::string CSourceGenerator::translate(ExpressionNode &p_expr,
+                                        const PType &p_type) {
+    ++m_expression_depth;
+    p_expr.accept(*this);
+    --m_expression_depth;
+    if (p_expr.getInferredType()->isInteger() && p_type.isReal()) {
+        return "(float)" + m_expr;
+    }
+    return m_expr;
+}
+
+void CSourceGenerator::emitBlock(CompoundStatementNode &p_compound_statement) {
+    m_indenter.increaseLevel();
+    p_compound_statement.visitChildNodes(*this);
+    m_indenter.decreaseLevel();
+}
+
+void CSourceGenerator::visit(ProgramNode &p_program) {
+    dumpInstructions(m_output_file.get(), kCSourcePrologue,
+                     m_source_file_path.c_str());
+
+    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    if (!p_program.getDeclNodes().empty()) {
+        dumpInstructions(m_output_file.get(), "\n");
+    }
+    for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
+             visit_ast_node);
+    for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
+             visit_ast_node);
+
+    m_return_type = p_program.getTypePtr();
+    dumpInstructions(m_output_file.get(), "\nint main(void) {\n");
+    emitBlock(const_cast<CompoundStatementNode &>(p_program.getBody()));
+    dumpInstructions(m_output_file.get(), "    return 0;\n}\n");
+}
+
+void CSourceGenerator::visit(DeclNode &p_decl) {
+    p_decl.visitChildNodes(*this);
+}
+
+void CSourceGenerator::visit(VariableNode &p_variable) {
+    const bool is_global = p_variable.getSymbolEntry()->getLevel() == 0;
+    const PType &type = *p_variable.getTypePtr();
+    const Constant *constant = p_variable.getConstantPtr();
+    const char *storage = is_global ? "static " : "";
+
+    if (!constant) {
+        emitLine("%s%s;", storage,
+                 getDeclarator(type, mangle(p_variable.getName())).c_str());
+    } else if (type.isPrimitiveString()) {
+        emitLine("%schar *const %s = %s;", storage,
+                 mangle(p_variable.getName()).c_str(),
+                 formatConstant(*constant).c_str());
+    } else {
+        emitLine("%sconst %s = %s;", storage,
+                 getDeclarator(type, mangle(p_variable.getName())).c_str(),
+                 formatConstant(*constant).c_str());
+    }
+}
+
+void CSourceGenerator::visit(ConstantValueNode &p_constant_value) {
+    m_expr = formatConstant(*p_constant_value.getConstantPtr());
+}
+
+void CSourceGenerator::visit(FunctionNode &p_function) {
+    // Arrays are passed by reference in C, so the callee copies them from
+    // `arg_*` to have them passed by value as in P.
+    std::string parameters;
+    for (const auto &parameter : p_function.getParameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            if (!parameters.empty()) {
+                parameters += ", ";
+            }
+            const PType &type = *variable->getTypePtr();
+            parameters += getDeclarator(
+                type, type.isScalar() ? mangle(variable->getName())
+                                      : "arg_" + variable->getName());
+        }
+    }
+    const std::string return_type = getScalarCType(*p_function.getTypePtr());
+    const std::string signature =
+        return_type + (return_type.back() == '*' ? "" : " ") +
+        mangle(p_function.getName()) + "(" +
+        (parameters.empty() ? "void" : parameters) + ")";
+
+    if (!p_function.getBody()) {
+        dumpInstructions(m_output_file.get(), "\n%s;\n", signature.c_str());
+        return;
+    }
+
+    dumpInstructions(m_output_file.get(), "\nstatic %s {\n", signature.c_str());
+    m_indenter.increaseLevel();
+    for (const auto &parameter : p_function.getParameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            const PType &type = *variable->getTypePtr();
+            if (!type.isScalar()) {
+                const std::string name = mangle(variable->getName());
+                emitLine("%s;", getDeclarator(type, name).c_str());
+                emitLine("memcpy(%s, arg_%s, sizeof(%s));", name.c_str(),
+                         variable->getNameCString(), name.c_str());
+            }
+        }
+    }
+    m_return_type = p_function.getTypePtr();
+    p_function.visitBodyChildNodes(*this);
+    if (!m_return_type->isVoid()) {
+        // Falling off the end of a function returns 0.
+        emitLine("return 0;");
+    }
+    m_indenter.decreaseLevel();
+    dumpInstructions(m_output_file.get(), "}\n");
+}
+
+void CSourceGenerator::visit(CompoundStatementNode &p_compound_statement) {
+    emitLine("{");
+    emitBlock(p_compound_statement);
+    emitLine("}");
+}
+
+void CSourceGenerator::visit(PrintNode &p_print) {
+    ExpressionNode &target = p_print.getTarget();
+    const PType &type = *target.getInferredType();
+    const std::string value = translate(target, type);
+    if (type.isReal()) {
+        emitLine("printReal(%s);", value.c_str());
+    } else if (type.isString()) {
+        emitLine("printString(%s);", value.c_str());
+    } else {
+        // `boolean`s are printed as 0 or 1.
+        emitLine("printInt(%s);", value.c_str());
+    }
+}
+
+void CSourceGenerator::visit(BinaryOperatorNode &p_bin_op) {
+    auto &left = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+    auto &right = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+    const PType &operand_type = getOperandType(p_bin_op);
+    const std::string lhs = translate(left, operand_type);
+    const std::string rhs = translate(right, operand_type);
+
+    const Operator op = p_bin_op.getOp();
+    if (p_bin_op.getInferredType()->isString()) {
+        m_expr = "rt_concat(" + lhs + ", " + rhs + ")";
+    } else if (op == Operator::kModOp) {
+        m_expr = "rt_mod(" + lhs + ", " + rhs + ")";
+    } else if (op == Operator::kDivideOp && operand_type.isInteger()) {
+        m_expr = "rt_div(" + lhs + ", " + rhs + ")";
+    } else {
+        m_expr = "(" + lhs + " " + getCOperator(op) + " " + rhs + ")";
+    }
+}
+
+void CSourceGenerator::visit(UnaryOperatorNode &p_un_op) {
+    auto &operand = const_cast<ExpressionNode &>(p_un_op.getOperand());
+    const std::string value = translate(operand, *operand.getInferredType());
+    switch (p_un_op.getOp()) {
+    case Operator::kNegOp:
+        m_expr = "(-" + value + ")";
+        break;
+    case Operator::kNotOp:
+        m_expr = "(!" + value + ")";
+        break;
+    default:
+        assert(false && "Unsupported unary operator");
+    }
+}
+
+void CSourceGenerator::visit(FunctionInvocationNode &p_func_invocation) {
+    const SymbolEntry *entry = p_func_invocation.getSymbolEntry();
+    std::vector<const PType *> parameter_types;
+    for (const auto &parameter : *entry->getAttribute().parameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            parameter_types.push_back(variable->getTypePtr());
+        }
+    }
+
+    std::string arguments;
+    const auto &argument_nodes = p_func_invocation.getArguments();
+    for (size_t i = 0; i < argument_nodes.size(); ++i) {
+        if (i != 0) {
+            arguments += ", ";
+        }
+        arguments += translate(*argument_nodes[i], *parameter_types[i]);
+    }
+    m_expr = mangle(p_func_invocation.getName()) + "(" + arguments + ")";
+    if (m_expression_depth == 0) {
+        emitLine("%s;", m_expr.c_str());
+    }
+}
+
+void CSourceGenerator::visit(VariableReferenceNode &p_variable_ref) {
+    std::string reference = mangle(p_variable_ref.getName());
+    for (const auto &index : p_variable_ref.getIndices()) {
+        reference += "[" + translate(*index, *index->getInferredType()) + "]";
+    }
+    m_expr = reference;
+}
+
+void CSourceGenerator::visit(AssignmentNode &p_assignment) {
+    VariableReferenceNode &lvalue = p_assignment.getLvalue();
+    lvalue.accept(*this);
+    const std::string reference = m_expr;
+    const std::string value =
+        translate(p_assignment.getExpr(), *lvalue.getInferredType());
+    emitLine("%s = %s;", reference.c_str(), value.c_str());
+}
+
+void CSourceGenerator::visit(ReadNode &p_read) {
+    auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+    target.accept(*this);
+    emitLine("%s = %s();", m_expr.c_str(),
+             target.getInferredType()->isReal() ? "readReal" : "readInt");
+}
+
+void CSourceGenerator::visit(IfNode &p_if) {
+    const std::string condition =
+        translate(*p_if.m_condition, *p_if.m_condition->getInferredType());
+    emitLine("if (%s) {", condition.c_str());
+    emitBlock(*p_if.m_body);
+    if (p_if.m_else_body) {
+        emitLine("} else {");
+        emitBlock(*p_if.m_else_body);
+    }
+    emitLine("}");
+}
+
+void CSourceGenerator::visit(WhileNode &p_while) {
+    const std::string condition = translate(
+        *p_while.m_condition, *p_while.m_condition->getInferredType());
+    emitLine("while (%s) {", condition.c_str());
+    emitBlock(*p_while.m_body);
+    emitLine("}");
+}
+
+void CSourceGenerator::visit(ForNode &p_for) {
+    const std::string name =
+        mangle(p_for.m_loop_var_decl->getVariables()[0]->getName());
+    emitLine("for (int %s = %s; %s < %s; ++%s) {", name.c_str(),
+             formatConstant(*p_for.getLowerBound().getConstantPtr()).c_str(),
+             name.c_str(),
+             formatConstant(*p_for.getUpperBound().getConstantPtr()).c_str(),
+             name.c_str());
+    emitBlock(*p_for.m_body);
+    emitLine("}");
+}
+
+void CSourceGenerator::visit(ReturnNode &p_return) {
+    auto &value = const_cast<ExpressionNode &>(p_return.getReturnValue());
+    emitLine("return %s;", translate(value, *m_return_type).c_str());
+}
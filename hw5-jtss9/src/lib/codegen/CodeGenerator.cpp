@@ -5,16 +5,20 @@
 #include "codegen/CodeGenerator.hpp"
 #include "sema/SemanticAnalyzer.hpp"
 #include "sema/SymbolTable.hpp"
+#include "util/OutputPath.hpp"
 #include "visitor/AstNodeInclude.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <string>
 #include <cstring>
+#include <cstdlib>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 CodeGenerator::CodeGenerator(const std::string &source_file_name,
@@ -22,25 +26,24 @@ CodeGenerator::CodeGenerator(const std::string &source_file_name,
                              std::unordered_map<SemanticAnalyzer::AstNodeAddr,
                                                       SymbolManager::Table>
                                  &&p_symbol_table_of_scoping_nodes)
-    : m_symbol_manager(false /* no dump */),
-      m_source_file_path(source_file_name),
+    : m_source_file_path(source_file_name),
       m_symbol_table_of_scoping_nodes(std::move(p_symbol_table_of_scoping_nodes)) {
-    // FIXME: assume that the source file is always xxxx.p
-    const auto &real_path =
-        save_path.empty() ? std::string{"."} : save_path;
-    auto slash_pos = source_file_name.rfind('/');
-    auto dot_pos = source_file_name.rfind('.');
-
-    if (slash_pos != std::string::npos) {
-        ++slash_pos;
-    } else {
-        slash_pos = 0;
-    }
-    auto output_file_path{
-        real_path + "/" +
-        source_file_name.substr(slash_pos, dot_pos - slash_pos) + ".S"};
-    m_output_file.reset(fopen(output_file_path.c_str(), "w"));
+    m_output_file_path = getOutputPath(source_file_name, save_path, ".S");
+    m_output_file.reset(fopen(m_output_file_path.c_str(), "w"));
     assert(m_output_file.get() && "Failed to open output file");
+    m_out = m_output_file.get();
+}
+
+void CodeGenerator::instrumentProfile(const ProfileLayout &p_layout,
+                                      const std::string &p_profile_path) {
+    m_profile_layout = &p_layout;
+    m_profile_path = p_profile_path;
+}
+
+void CodeGenerator::useProfile(const ProfileLayout &p_layout,
+                               const ProfileData &p_profile) {
+    m_profile_layout = &p_layout;
+    m_profile = &p_profile;
 }
 
 static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
@@ -50,6 +53,1340 @@ static void dumpInstructions(FILE *p_out_file, const char *format, ...) {
     va_end(args);
 }
 
+namespace {
+/// @return Whether `p_node` is or contains a loop.
+bool containsLoop(const FlatAst &p_ast, const AstNode *p_node) {
+    return p_node && p_ast.subtreeContains(p_ast.getId(*p_node),
+                                           {NodeKind::kWhile, NodeKind::kFor});
+}
+
+/// @return Whether `p_node` calls out, including to the runtime functions of
+/// `print` and `read`.
+bool containsCall(const FlatAst &p_ast, const AstNode &p_node) {
+    return p_ast.subtreeContains(p_ast.getId(p_node),
+                                 {NodeKind::kPrint, NodeKind::kRead,
+                                  NodeKind::kFunctionInvocation});
+}
+
+/// @brief What loop unswitching needs to know about a loop.
+struct LoopSummary {
+    /// @brief The variables assigned, read into or declared in the loop.
+    std::unordered_set<const SymbolEntry *> m_written_symbols;
+    /// @brief The `if`s of the loop in source order.
+    std::vector<IfNode *> m_ifs;
+    size_t m_num_statements = 0;
+    bool m_has_call = false;
+    /// @brief String and real constants are emitted under the name of the
+    /// variable they're assigned to, so such an assignment can't be
+    /// generated twice.
+    bool m_has_named_constant = false;
+};
+
+/// @brief Summarizes the body of the loop `p_loop` in one pass over the
+/// nodes, which are in source order.
+LoopSummary summarizeLoop(const FlatAst &p_ast, const NodeId p_loop) {
+    LoopSummary summary;
+    for (NodeId id = p_loop + 1; id < p_ast.getSubtreeEnd(p_loop); ++id) {
+        switch (p_ast.getKind(id)) {
+        case NodeKind::kVariable:
+            summary.m_written_symbols.insert(
+                p_ast.getNode<VariableNode>(id).getSymbolEntry());
+            break;
+        case NodeKind::kFunctionInvocation:
+            summary.m_has_call = true;
+            break;
+        case NodeKind::kAssignment: {
+            const auto &lvalue = p_ast.getNode<AssignmentNode>(id).getLvalue();
+            ++summary.m_num_statements;
+            summary.m_written_symbols.insert(lvalue.getSymbolEntry());
+            const PType *type = lvalue.getInferredType();
+            if (type &&
+                (type->isPrimitiveString() || type->isPrimitiveReal())) {
+                summary.m_has_named_constant = true;
+            }
+            break;
+        }
+        case NodeKind::kRead:
+            ++summary.m_num_statements;
+            summary.m_written_symbols.insert(
+                p_ast.getNode<ReadNode>(id).getTarget().getSymbolEntry());
+            break;
+        case NodeKind::kIf:
+            ++summary.m_num_statements;
+            summary.m_ifs.push_back(&p_ast.getNode<IfNode>(id));
+            break;
+        case NodeKind::kPrint:
+        case NodeKind::kWhile:
+        case NodeKind::kFor:
+        case NodeKind::kReturn:
+            ++summary.m_num_statements;
+            break;
+        default:
+            break;
+        }
+    }
+    return summary;
+}
+
+/// @return Whether `p_expr` has the same value in every iteration of the
+/// loop summarized by `p_loop`.
+bool isLoopInvariant(const ExpressionNode &p_expr, const LoopSummary &p_loop) {
+    if (dynamic_cast<const ConstantValueNode *>(&p_expr)) {
+        return true;
+    }
+    if (auto un_op = dynamic_cast<const UnaryOperatorNode *>(&p_expr)) {
+        return isLoopInvariant(un_op->getOperand(), p_loop);
+    }
+    if (auto bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_expr)) {
+        return isLoopInvariant(bin_op->getLeftOperand(), p_loop) &&
+               isLoopInvariant(bin_op->getRightOperand(), p_loop);
+    }
+    auto variable = dynamic_cast<const VariableReferenceNode *>(&p_expr);
+    if (!variable || !variable->getIndices().empty() ||
+        !variable->getInferredType() ||
+        !variable->getInferredType()->isScalar() ||
+        variable->getInferredType()->isPrimitiveString()) {
+        return false;
+    }
+    // A global may be written by a called function.
+    const SymbolEntry *symbol = variable->getSymbolEntry();
+    return symbol && !p_loop.m_written_symbols.count(symbol) &&
+           !(symbol->getLevel() == 0 && p_loop.m_has_call);
+}
+
+/// @brief Registers that hold nothing across statements when no call is
+/// made; `a0` is left alone since `return` doesn't leave the function.
+constexpr const char *const kLoopRegisters[] = {"a1", "a2", "a3", "a4", "a5",
+                                                "a6", "a7", "t4", "t5", "t6"};
+constexpr size_t kNumLoopRegisters =
+    sizeof(kLoopRegisters) / sizeof(kLoopRegisters[0]);
+
+/// @return Whether both expressions are the same constant or the same
+/// variable (or element with the same constant indices).
+bool isSameExpression(const ExpressionNode &p_lhs, const ExpressionNode &p_rhs) {
+    if (auto lhs = dynamic_cast<const ConstantValueNode *>(&p_lhs)) {
+        auto rhs = dynamic_cast<const ConstantValueNode *>(&p_rhs);
+        return rhs &&
+               lhs->getTypePtr()->getPrimitiveType() ==
+                   rhs->getTypePtr()->getPrimitiveType() &&
+               strcmp(lhs->getConstantValueCString(),
+                      rhs->getConstantValueCString()) == 0;
+    }
+    if (auto lhs = dynamic_cast<const VariableReferenceNode *>(&p_lhs)) {
+        auto rhs = dynamic_cast<const VariableReferenceNode *>(&p_rhs);
+        if (!rhs || lhs->getName() != rhs->getName() ||
+            lhs->getIndices().size() != rhs->getIndices().size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs->getIndices().size(); ++i) {
+            if (!isSameExpression(*lhs->getIndices()[i],
+                                  *rhs->getIndices()[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/// @return The assignment `p_body` consists of, or `nullptr`.
+AssignmentNode *getSingleAssignment(CompoundStatementNode &p_body) {
+    if (!p_body.getDeclNodes().empty() || p_body.getStatements().size() != 1) {
+        return nullptr;
+    }
+    return dynamic_cast<AssignmentNode *>(p_body.getStatements()[0].get());
+}
+
+/// @brief Chains shorter than this are left as compares.
+constexpr size_t kMinSwitchCases = 4;
+/// @brief Loops are unswitched while all their versions together have at
+/// most this many statements.
+constexpr size_t kMaxUnswitchedStatements = 64;
+/// @brief A jump table is used while at least one in this many of its
+/// entries is a case.
+constexpr int64_t kMaxJumpTableSpread = 3;
+
+/// @return Whether `p_expr` is an integer literal, possibly negated; its
+/// value is stored in `p_value`.
+bool getIntegerConstant(const ExpressionNode &p_expr, int64_t &p_value) {
+    if (auto un_op = dynamic_cast<const UnaryOperatorNode *>(&p_expr)) {
+        if (un_op->getOp() != Operator::kNegOp ||
+            !getIntegerConstant(un_op->getOperand(), p_value)) {
+            return false;
+        }
+        p_value = -p_value;
+        return true;
+    }
+    auto constant = dynamic_cast<const ConstantValueNode *>(&p_expr);
+    if (!constant || !constant->getTypePtr()->isPrimitiveInteger()) {
+        return false;
+    }
+    p_value = std::strtoll(constant->getConstantValueCString(), nullptr, 10);
+    return true;
+}
+
+/// @return Whether `p_expr` can be evaluated where the source doesn't
+/// evaluate it: a constant, a scalar variable or an element whose indices
+/// are constants within the bounds of its array.
+bool isSpeculatable(const ExpressionNode &p_expr) {
+    int64_t value = 0;
+    if (dynamic_cast<const ConstantValueNode *>(&p_expr) ||
+        getIntegerConstant(p_expr, value)) {
+        return true;
+    }
+    auto variable = dynamic_cast<const VariableReferenceNode *>(&p_expr);
+    const SymbolEntry *symbol = variable ? variable->getSymbolEntry() : nullptr;
+    if (!symbol) {
+        return false;
+    }
+    const auto &dims = symbol->getTypePtr()->getDimensions();
+    const auto &indices = variable->getIndices();
+    if (indices.size() > dims.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (!getIntegerConstant(*indices[i], value) || value < 0 ||
+            value >= static_cast<int64_t>(dims[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @return The integer variable compared with a constant by `p_condition`
+/// (`x = c` or `c = x`), or `nullptr`; the constant is stored in `p_value`.
+const VariableReferenceNode *matchCaseCondition(const ExpressionNode &p_condition,
+                                                int64_t &p_value) {
+    auto comparison = dynamic_cast<const BinaryOperatorNode *>(&p_condition);
+    if (!comparison || comparison->getOp() != Operator::kEqualOp) {
+        return nullptr;
+    }
+    const ExpressionNode *operands[] = {&comparison->getLeftOperand(),
+                                        &comparison->getRightOperand()};
+    for (int i = 0; i < 2; ++i) {
+        auto variable = dynamic_cast<const VariableReferenceNode *>(operands[i]);
+        if (variable && variable->getInferredType() &&
+            variable->getInferredType()->isInteger() &&
+            getIntegerConstant(*operands[1 - i], p_value)) {
+            return p_value >= INT32_MIN && p_value <= INT32_MAX ? variable
+                                                                : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+/// @return The `if` that `p_else_body` consists of, or `nullptr`.
+IfNode *getElseIf(CompoundStatementNode *p_else_body) {
+    if (!p_else_body || !p_else_body->getDeclNodes().empty() ||
+        p_else_body->getStatements().size() != 1) {
+        return nullptr;
+    }
+    return dynamic_cast<IfNode *>(p_else_body->getStatements()[0].get());
+}
+
+/// @brief A subscript as a function of a loop variable, if it's one.
+struct Subscript {
+    enum class Kind { kConstant, kLoopVariable, kUnknown };
+    Kind kind;
+    /// @brief The constant, or what's added to the loop variable.
+    int64_t offset;
+    /// @brief The nesting depth of the loop, from the outermost one analyzed.
+    size_t loop = 0;
+};
+
+struct Access {
+    const SymbolEntry *symbol;
+    std::vector<Subscript> subscripts;
+    bool is_write;
+};
+
+/// @brief What loop fusion and interchange need to know about the body of a
+/// loop.
+struct LoopAccesses {
+    std::vector<Access> accesses;
+    bool has_call = false;
+    bool has_io = false;
+    bool has_return = false;
+};
+
+/// @brief Collects the variable accesses of a `for` loop or of a perfect loop
+/// nest.
+class AccessCollector final : public StaticVisitor<AccessCollector> {
+  private:
+    std::vector<const SymbolEntry *> m_loop_variables;
+    LoopAccesses m_accesses;
+
+  public:
+    using StaticVisitor<AccessCollector>::visit;
+
+    void collect(ForNode &p_for) {
+        enterLoop(p_for);
+        dispatch(*p_for.m_body);
+    }
+
+    /// @brief Each loop of `p_nest` is the only statement of the body of the
+    /// previous one.
+    void collect(const std::vector<ForNode *> &p_nest) {
+        for (ForNode *loop : p_nest) {
+            enterLoop(*loop);
+        }
+        dispatch(*p_nest.back()->m_body);
+    }
+
+    const LoopAccesses &getAccesses() const { return m_accesses; }
+
+    void visit(CompoundStatementNode &p_compound_statement) {
+        visitChildren(p_compound_statement);
+    }
+    void visit(PrintNode &p_print) {
+        m_accesses.has_io = true;
+        visitChildren(p_print);
+    }
+    void visit(BinaryOperatorNode &p_bin_op) {
+        visitChildren(p_bin_op);
+    }
+    void visit(UnaryOperatorNode &p_un_op) {
+        visitChildren(p_un_op);
+    }
+    void visit(FunctionInvocationNode &p_func_invocation) {
+        m_accesses.has_call = true;
+        visitChildren(p_func_invocation);
+    }
+    void visit(VariableReferenceNode &p_variable_ref) {
+        addAccess(p_variable_ref, false);
+        visitChildren(p_variable_ref);
+    }
+    void visit(AssignmentNode &p_assignment) {
+        addAccess(p_assignment.getLvalue(), true);
+        visitChildren(p_assignment.getLvalue());
+        dispatch(p_assignment.getExpr());
+    }
+    void visit(ReadNode &p_read) {
+        auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+        m_accesses.has_io = true;
+        addAccess(target, true);
+        visitChildren(target);
+    }
+    void visit(IfNode &p_if) { visitChildren(p_if); }
+    void visit(WhileNode &p_while) { visitChildren(p_while); }
+    void visit(ForNode &p_for) { visitChildren(p_for); }
+    void visit(ReturnNode &p_return) {
+        m_accesses.has_return = true;
+        visitChildren(p_return);
+    }
+
+  private:
+    void enterLoop(ForNode &p_for) {
+        m_loop_variables.push_back(
+            p_for.m_loop_var_decl->getVariables()[0]->getSymbolEntry());
+    }
+
+    void addAccess(const VariableReferenceNode &p_variable_ref,
+                   const bool p_is_write) {
+        Access access{p_variable_ref.getSymbolEntry(), {}, p_is_write};
+        for (const auto &index : p_variable_ref.getIndices()) {
+            access.subscripts.push_back(getSubscript(*index));
+        }
+        m_accesses.accesses.push_back(std::move(access));
+    }
+
+    Subscript getSubscript(const ExpressionNode &p_index) const {
+        int64_t value = 0;
+        if (getIntegerConstant(p_index, value)) {
+            return {Subscript::Kind::kConstant, value};
+        }
+        if (auto variable =
+                dynamic_cast<const VariableReferenceNode *>(&p_index)) {
+            auto loop_variable =
+                std::find(m_loop_variables.begin(), m_loop_variables.end(),
+                          variable->getSymbolEntry());
+            if (variable->getIndices().empty() &&
+                loop_variable != m_loop_variables.end()) {
+                return {Subscript::Kind::kLoopVariable, 0,
+                        static_cast<size_t>(loop_variable -
+                                            m_loop_variables.begin())};
+            }
+        }
+        auto bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_index);
+        if (bin_op && (bin_op->getOp() == Operator::kPlusOp ||
+                       bin_op->getOp() == Operator::kMinusOp)) {
+            const Subscript left = getSubscript(bin_op->getLeftOperand());
+            const Subscript right = getSubscript(bin_op->getRightOperand());
+            if (left.kind == Subscript::Kind::kLoopVariable &&
+                right.kind == Subscript::Kind::kConstant) {
+                return {Subscript::Kind::kLoopVariable,
+                        bin_op->getOp() == Operator::kPlusOp
+                            ? left.offset + right.offset
+                            : left.offset - right.offset,
+                        left.loop};
+            }
+            if (bin_op->getOp() == Operator::kPlusOp &&
+                left.kind == Subscript::Kind::kConstant &&
+                right.kind == Subscript::Kind::kLoopVariable) {
+                return {Subscript::Kind::kLoopVariable,
+                        left.offset + right.offset, right.loop};
+            }
+        }
+        return {Subscript::Kind::kUnknown, 0};
+    }
+};
+
+/// @return Whether `p_second`, made by the second of two loops, may reach
+/// the location of `p_first`, made by the first loop, in an earlier
+/// iteration than `p_first` does; fusion would reverse their order.
+bool mayDependBackwards(const Access &p_first, const Access &p_second) {
+    const size_t num_dims = p_first.symbol->getTypePtr()->getDimensions().size();
+    if (p_first.subscripts.size() != num_dims ||
+        p_second.subscripts.size() != num_dims) {
+        // A scalar or a whole array.
+        return true;
+    }
+    bool has_distance = false;
+    int64_t distance = 0;
+    for (size_t i = 0; i < num_dims; ++i) {
+        const Subscript &first = p_first.subscripts[i];
+        const Subscript &second = p_second.subscripts[i];
+        if (first.kind == Subscript::Kind::kConstant &&
+            second.kind == Subscript::Kind::kConstant) {
+            if (first.offset != second.offset) {
+                return false;
+            }
+        } else if (first.kind == Subscript::Kind::kLoopVariable &&
+                   second.kind == Subscript::Kind::kLoopVariable) {
+            // The first loop reaches the element `distance` iterations after
+            // the second one does.
+            const int64_t element_distance = second.offset - first.offset;
+            if (has_distance && element_distance != distance) {
+                return false;
+            }
+            has_distance = true;
+            distance = element_distance;
+        }
+    }
+    return !has_distance || distance > 0;
+}
+
+/// @return Whether running the body of the second loop right after the body
+/// of the first one in each iteration keeps the meaning of the two loops.
+bool canFuse(const LoopAccesses &p_first, const LoopAccesses &p_second) {
+    if (p_first.has_call || p_second.has_call || p_first.has_return ||
+        p_second.has_return || (p_first.has_io && p_second.has_io)) {
+        return false;
+    }
+    for (const auto &first : p_first.accesses) {
+        for (const auto &second : p_second.accesses) {
+            if (first.symbol == second.symbol &&
+                (first.is_write || second.is_write) &&
+                mayDependBackwards(first, second)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @return Whether `p_lhs` and `p_rhs`, made in a nest of `p_num_loops`
+/// loops, may reach the same element in iterations that one loop of the nest
+/// runs in order and another in reverse order; interchanging the two loops
+/// would reorder them.
+bool mayPreventInterchange(const Access &p_lhs, const Access &p_rhs,
+                           const size_t p_num_loops) {
+    const size_t num_dims = p_lhs.symbol->getTypePtr()->getDimensions().size();
+    if (p_lhs.subscripts.size() != num_dims ||
+        p_rhs.subscripts.size() != num_dims) {
+        // A scalar or a whole array.
+        return true;
+    }
+    // How many iterations of each loop lie between the two accesses, if it's
+    // known.
+    std::vector<bool> has_distance(p_num_loops, false);
+    std::vector<int64_t> distances(p_num_loops, 0);
+    for (size_t i = 0; i < num_dims; ++i) {
+        const Subscript &lhs = p_lhs.subscripts[i];
+        const Subscript &rhs = p_rhs.subscripts[i];
+        if (lhs.kind == Subscript::Kind::kConstant &&
+            rhs.kind == Subscript::Kind::kConstant) {
+            if (lhs.offset != rhs.offset) {
+                return false;
+            }
+        } else if (lhs.kind == Subscript::Kind::kLoopVariable &&
+                   rhs.kind == Subscript::Kind::kLoopVariable &&
+                   lhs.loop == rhs.loop) {
+            const int64_t distance = lhs.offset - rhs.offset;
+            if (has_distance[lhs.loop] && distances[lhs.loop] != distance) {
+                return false;
+            }
+            has_distance[lhs.loop] = true;
+            distances[lhs.loop] = distance;
+        }
+    }
+    auto may_be = [&](const size_t p_loop, const bool p_positive) {
+        return !has_distance[p_loop] ||
+               (p_positive ? distances[p_loop] > 0 : distances[p_loop] < 0);
+    };
+    for (size_t forward = 0; forward < p_num_loops; ++forward) {
+        for (size_t backward = 0; backward < p_num_loops; ++backward) {
+            if (forward != backward && may_be(forward, true) &&
+                may_be(backward, false)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// @return The loop that `p_for` consists of, or `nullptr`.
+ForNode *getPerfectlyNestedLoop(ForNode &p_for) {
+    CompoundStatementNode &body = *p_for.m_body;
+    if (!body.getDeclNodes().empty() || body.getStatements().size() != 1) {
+        return nullptr;
+    }
+    return dynamic_cast<ForNode *>(body.getStatements()[0].get());
+}
+
+/// @return `p_for` and the loops perfectly nested in it, at most
+/// `p_max_depth` of them.
+std::vector<ForNode *> getPerfectNest(ForNode &p_for, const size_t p_max_depth) {
+    std::vector<ForNode *> nest{&p_for};
+    while (nest.size() < p_max_depth) {
+        ForNode *inner = getPerfectlyNestedLoop(*nest.back());
+        if (!inner) {
+            break;
+        }
+        nest.push_back(inner);
+    }
+    return nest;
+}
+
+int getTripCount(ForNode &p_for) {
+    return std::stoi(p_for.getUpperBound().getConstantValueCString()) -
+           std::stoi(p_for.getLowerBound().getConstantValueCString());
+}
+
+/// @brief Tiles smaller than this cost more in loop overhead than they save.
+constexpr int kMinTileSize = 4;
+/// @brief Nests deeper than this aren't tiled.
+constexpr size_t kMaxTiledNestDepth = 3;
+
+bool haveSameBounds(ForNode &p_lhs, ForNode &p_rhs) {
+    return std::stoi(p_lhs.getLowerBound().getConstantValueCString()) ==
+               std::stoi(p_rhs.getLowerBound().getConstantValueCString()) &&
+           std::stoi(p_lhs.getUpperBound().getConstantValueCString()) ==
+               std::stoi(p_rhs.getUpperBound().getConstantValueCString());
+}
+
+enum class Prediction { kUnknown, kTaken, kNotTaken };
+
+bool isIntegerZero(const ExpressionNode &p_expr) {
+    auto constant = dynamic_cast<const ConstantValueNode *>(&p_expr);
+    return constant && constant->getTypePtr()->isPrimitiveInteger() &&
+           strcmp(constant->getConstantValueCString(), "0") == 0;
+}
+
+/// @brief Predicts a condition by the static heuristics of Ball and Larus:
+/// equality rarely holds, and neither do comparisons that hold only for
+/// negative values.
+Prediction predictCondition(const ExpressionNode &p_condition) {
+    if (auto un_op = dynamic_cast<const UnaryOperatorNode *>(&p_condition)) {
+        if (un_op->getOp() != Operator::kNotOp) {
+            return Prediction::kUnknown;
+        }
+        switch (predictCondition(un_op->getOperand())) {
+        case Prediction::kTaken:
+            return Prediction::kNotTaken;
+        case Prediction::kNotTaken:
+            return Prediction::kTaken;
+        default:
+            return Prediction::kUnknown;
+        }
+    }
+    auto bin_op = dynamic_cast<const BinaryOperatorNode *>(&p_condition);
+    if (!bin_op) {
+        return Prediction::kUnknown;
+    }
+    const bool compares_with_zero = isIntegerZero(bin_op->getRightOperand());
+    switch (bin_op->getOp()) {
+    case Operator::kEqualOp:
+        return Prediction::kNotTaken;
+    case Operator::kNotEqualOp:
+        return Prediction::kTaken;
+    case Operator::kLessOp:
+    case Operator::kLessOrEqualOp:
+        return compares_with_zero ? Prediction::kNotTaken
+                                  : Prediction::kUnknown;
+    case Operator::kGreaterOp:
+    case Operator::kGreaterOrEqualOp:
+        return compares_with_zero ? Prediction::kTaken : Prediction::kUnknown;
+    default:
+        return Prediction::kUnknown;
+    }
+}
+} // namespace
+
+bool CodeGenerator::canMoveOutOfLine() const {
+    return m_out == m_output_file.get();
+}
+
+bool CodeGenerator::tryIfConversion(IfNode &p_if) {
+    // The counts of both sides are needed from an instrumented build.
+    if (!p_if.m_else_body || !m_profile_path.empty()) {
+        return false;
+    }
+    AssignmentNode *then_assignment = getSingleAssignment(*p_if.m_body);
+    AssignmentNode *else_assignment = getSingleAssignment(*p_if.m_else_body);
+    if (!then_assignment || !else_assignment) {
+        return false;
+    }
+    VariableReferenceNode &lvalue = then_assignment->getLvalue();
+    const PType *type = lvalue.getInferredType();
+    ExpressionNode &then_expr = then_assignment->getExpr();
+    ExpressionNode &else_expr = else_assignment->getExpr();
+    // Both values are computed whichever side is taken, so neither may call
+    // a function or read an element that may be out of bounds.
+    if (!type || !(type->isInteger() || type->isBool()) ||
+        !isSameExpression(lvalue, else_assignment->getLvalue()) ||
+        !isSpeculatable(then_expr) || !isSpeculatable(else_expr)) {
+        return false;
+    }
+    if (m_profile && m_function_count > 0) {
+        // A branch this biased is predicted well anyway.
+        const uint32_t entry_count = getCount(p_if);
+        const uint32_t then_count = getCount(p_if, 1);
+        if (std::min(then_count, entry_count - then_count) < entry_count / 16) {
+            return false;
+        }
+    }
+
+    // `if a > b then m := a; else m := b;` and alike select the maximum or
+    // the minimum of the compared values.
+    const char *min_max = nullptr;
+    auto comparison = dynamic_cast<BinaryOperatorNode *>(p_if.m_condition.get());
+    if (m_has_zbb && comparison &&
+        comparison->getLeftOperand().getInferredType()->isInteger() &&
+        comparison->getRightOperand().getInferredType()->isInteger()) {
+        const auto &left = comparison->getLeftOperand();
+        const auto &right = comparison->getRightOperand();
+        bool is_greater = false;
+        switch (comparison->getOp()) {
+        case Operator::kGreaterOp:
+        case Operator::kGreaterOrEqualOp:
+            is_greater = true;
+            // fall through
+        case Operator::kLessOp:
+        case Operator::kLessOrEqualOp:
+            if (isSameExpression(then_expr, left) &&
+                isSameExpression(else_expr, right)) {
+                min_max = is_greater ? "max" : "min";
+            } else if (isSameExpression(then_expr, right) &&
+                       isSameExpression(else_expr, left)) {
+                min_max = is_greater ? "min" : "max";
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (min_max) {
+        visitChildren(*comparison);
+        const char *select_instr = "    lw t1, 0(sp)\n"
+                                   "    addi sp, sp, 4\n"
+                                   "    lw t0, 0(sp)\n"
+                                   "    addi sp, sp, 4\n"
+                                   "    %s t0, t0, t1\n";
+        dumpInstructions(m_out, select_instr, min_max);
+    } else {
+        dispatch(*p_if.m_condition);
+        dispatch(then_expr);
+        dispatch(else_expr);
+        const char *pop_instr = "    lw t2, 0(sp)\n"
+                                "    addi sp, sp, 4\n"
+                                "    lw t1, 0(sp)\n"
+                                "    addi sp, sp, 4\n"
+                                "    lw t0, 0(sp)\n"
+                                "    addi sp, sp, 4\n";
+        dumpInstructions(m_out, pop_instr);
+        if (m_has_zicond) {
+            const char *select_instr = "    czero.eqz t1, t1, t0\n"
+                                       "    czero.nez t2, t2, t0\n"
+                                       "    or t0, t1, t2\n";
+            dumpInstructions(m_out, select_instr);
+        } else {
+            // else ^ ((then ^ else) & -cond)
+            const char *select_instr = "    neg t0, t0\n"
+                                       "    xor t1, t1, t2\n"
+                                       "    and t1, t1, t0\n"
+                                       "    xor t0, t1, t2\n";
+            dumpInstructions(m_out, select_instr);
+        }
+    }
+
+    // The address is computed after the condition, as in the branches, so
+    // that a call in the condition is seen by the subscripts of `lvalue`.
+    const char *push_instr = "    addi sp, sp, -4\n"
+                             "    sw t0, 0(sp)\n";
+    dumpInstructions(m_out, push_instr);
+    m_lhs = true;
+    dispatch(lvalue);
+    m_lhs = false;
+    const char *assign_instr = "    lw t1, 0(sp)\n"
+                               "    addi sp, sp, 4\n"
+                               "    lw t0, 0(sp)\n"
+                               "    addi sp, sp, 4\n"
+                               "    sw t0, 0(t1)\n";
+    dumpInstructions(m_out, assign_instr);
+    return true;
+}
+
+bool CodeGenerator::trySwitchLowering(IfNode &p_if) {
+    // Each `if` of the chain has its own counters.
+    if (!m_profile_path.empty()) {
+        return false;
+    }
+    std::vector<SwitchCase> cases;
+    const VariableReferenceNode *scrutinee = nullptr;
+    CompoundStatementNode *default_body = nullptr;
+    for (IfNode *node = &p_if; node; node = getElseIf(default_body)) {
+        int64_t value = 0;
+        auto variable = matchCaseCondition(*node->m_condition, value);
+        if (!variable ||
+            (scrutinee && !isSameExpression(*scrutinee, *variable))) {
+            break;
+        }
+        scrutinee = variable;
+        cases.push_back({static_cast<int32_t>(value), 0, node->m_body.get()});
+        default_body = node->m_else_body.get();
+    }
+    if (cases.size() < kMinSwitchCases) {
+        return false;
+    }
+    std::vector<int32_t> values;
+    for (const auto &switch_case : cases) {
+        values.push_back(switch_case.value);
+    }
+    std::sort(values.begin(), values.end());
+    // A repeated constant is never matched the second time; leave such
+    // chains alone.
+    if (std::adjacent_find(values.begin(), values.end()) != values.end()) {
+        return false;
+    }
+
+    // The variable is read once since none of the conditions has side
+    // effects.
+    dispatch(*const_cast<VariableReferenceNode *>(scrutinee));
+    const char *pop_instr = "    lw t0, 0(sp)\n"
+                            "    addi sp, sp, 4\n";
+    dumpInstructions(m_out, pop_instr);
+
+    const int default_label = m_label_num++;
+    const int end_label = default_body ? m_label_num++ : default_label;
+    for (auto &switch_case : cases) {
+        switch_case.label = m_label_num++;
+    }
+    std::vector<SwitchCase> sorted_cases = cases;
+    std::sort(sorted_cases.begin(), sorted_cases.end(),
+              [](const SwitchCase &p_lhs, const SwitchCase &p_rhs) {
+                  return p_lhs.value < p_rhs.value;
+              });
+
+    const int32_t min_value = sorted_cases.front().value;
+    const int64_t spread =
+        static_cast<int64_t>(sorted_cases.back().value) - min_value + 1;
+    if (spread <= kMaxJumpTableSpread * static_cast<int64_t>(cases.size())) {
+        const int table_label = m_label_num++;
+        std::vector<int> entries(static_cast<size_t>(spread), default_label);
+        for (const auto &switch_case : cases) {
+            entries[static_cast<size_t>(switch_case.value - min_value)] =
+                switch_case.label;
+        }
+        m_jump_tables.emplace_back(table_label, std::move(entries));
+
+        if (min_value != 0) {
+            const char *rebase_instr = "    li t1, %d\n"
+                                       "    sub t0, t0, t1\n";
+            dumpInstructions(m_out, rebase_instr, min_value);
+        }
+        // One unsigned compare also sends the values below the minimum to
+        // the default.
+        const char *jump_instr = "    li t1, %d\n"
+                                 "    bgeu t0, t1, L%d\n"
+                                 "    slli t0, t0, 2\n"
+                                 "    lui t1, %%hi(L%d)\n"
+                                 "    addi t1, t1, %%lo(L%d)\n"
+                                 "    add t0, t0, t1\n"
+                                 "    lw t0, 0(t0)\n"
+                                 "    jr t0\n";
+        dumpInstructions(m_out, jump_instr, static_cast<int>(spread),
+                         default_label, table_label, table_label);
+    } else {
+        emitCaseSearch(sorted_cases, 0, sorted_cases.size(), default_label);
+    }
+
+    for (size_t i = 0; i < cases.size(); ++i) {
+        dumpInstructions(m_out, "L%d:\n", cases[i].label);
+        dispatch(*cases[i].body);
+        if (i + 1 < cases.size() || default_body) {
+            dumpInstructions(m_out, "    j L%d\n", end_label);
+        }
+    }
+    if (default_body) {
+        dumpInstructions(m_out, "L%d:\n", default_label);
+        dispatch(*default_body);
+    }
+    dumpInstructions(m_out, "L%d:\n", end_label);
+    return true;
+}
+
+void CodeGenerator::emitCaseSearch(const std::vector<SwitchCase> &p_cases,
+                                   const size_t p_begin, const size_t p_end,
+                                   const int p_default_label) {
+    // A few compares in a row are cheaper than another level of the tree.
+    if (p_end - p_begin <= 3) {
+        for (size_t i = p_begin; i < p_end; ++i) {
+            const char *case_instr = "    li t1, %d\n"
+                                     "    beq t0, t1, L%d\n";
+            dumpInstructions(m_out, case_instr, p_cases[i].value,
+                             p_cases[i].label);
+        }
+        dumpInstructions(m_out, "    j L%d\n", p_default_label);
+        return;
+    }
+    const size_t mid = p_begin + (p_end - p_begin) / 2;
+    const int left_label = m_label_num++;
+    const char *pivot_instr = "    li t1, %d\n"
+                              "    blt t0, t1, L%d\n"
+                              "    beq t0, t1, L%d\n";
+    dumpInstructions(m_out, pivot_instr, p_cases[mid].value, left_label,
+                     p_cases[mid].label);
+    emitCaseSearch(p_cases, mid + 1, p_end, p_default_label);
+    dumpInstructions(m_out, "L%d:\n", left_label);
+    emitCaseSearch(p_cases, p_begin, mid, p_default_label);
+}
+
+bool CodeGenerator::tryUnswitching(AstNode &p_loop) {
+    const LoopSummary summary =
+        summarizeLoop(m_flat_ast, m_flat_ast.getId(p_loop));
+    if (summary.m_has_named_constant ||
+        summary.m_num_statements * m_num_loop_copies * 2 >
+            kMaxUnswitchedStatements) {
+        return false;
+    }
+    auto invariant_if = std::find_if(
+        summary.m_ifs.begin(), summary.m_ifs.end(), [&](IfNode *p_if) {
+            return !m_unswitched_conditions.count(p_if) &&
+                   isLoopInvariant(*p_if->m_condition, summary);
+        });
+    if (invariant_if == summary.m_ifs.end()) {
+        return false;
+    }
+    IfNode &p_if = **invariant_if;
+    emitRemark(p_loop, "unswitched the loop on the condition at line %u",
+               p_if.getLocation().getLine());
+
+    const int false_label = m_label_num++;
+    const int end_label = m_label_num++;
+    dispatch(*p_if.m_condition);
+    const char *test_instr = "    lw t0, 0(sp)\n"
+                             "    addi sp, sp, 4\n"
+                             "    beq t0, zero, L%d\n";
+    dumpInstructions(m_out, test_instr, false_label);
+
+    // Both versions of the loop share the slots of its locals.
+    const int offset = m_offset;
+    m_num_loop_copies *= 2;
+    m_unswitched_conditions[&p_if] = true;
+    dispatch(p_loop);
+    const int true_offset = m_offset;
+    dumpInstructions(m_out, "    j L%d\n", end_label);
+
+    dumpInstructions(m_out, "L%d:\n", false_label);
+    m_offset = offset;
+    m_unswitched_conditions[&p_if] = false;
+    dispatch(p_loop);
+    dumpInstructions(m_out, "L%d:\n", end_label);
+
+    m_unswitched_conditions.erase(&p_if);
+    m_num_loop_copies /= 2;
+    m_offset = std::min(m_offset, true_offset);
+    return true;
+}
+
+void CodeGenerator::emitElementAddress(VariableReferenceNode &p_variable_ref,
+                                       const SymbolEntry &p_symbol) {
+    // The elements are laid out row by row downwards from the first one, so
+    // that a callee copies an array argument the same way wherever it lives;
+    // a global is thus addressed from its last word.
+    const auto &dims = p_symbol.getTypePtr()->getDimensions();
+    const auto &indices = p_variable_ref.getIndices();
+    int64_t array_size = 4;
+    for (const auto dim : dims) {
+        array_size *= static_cast<int64_t>(dim);
+    }
+    int64_t element_size = 4;
+    for (size_t i = indices.size(); i < dims.size(); ++i) {
+        element_size *= static_cast<int64_t>(dims[i]);
+    }
+    const bool is_global = p_symbol.getLevel() == 0;
+    const int64_t base_offset =
+        is_global ? array_size - 4 : p_symbol.getOffset();
+
+    int64_t constant_index = 0;
+    bool has_constant_indices = true;
+    for (size_t i = 0; i < indices.size() && has_constant_indices; ++i) {
+        int64_t value = 0;
+        has_constant_indices = getIntegerConstant(*indices[i], value);
+        constant_index = constant_index * static_cast<int64_t>(dims[i]) + value;
+    }
+    if (has_constant_indices) {
+        const int64_t offset = base_offset - constant_index * element_size;
+        if (is_global) {
+            dumpInstructions(m_out, "    la t0, %s\n",
+                             p_variable_ref.getNameCString());
+            if (offset != 0) {
+                const char *offset_instr = "    li t1, %lld\n"
+                                           "    add t0, t0, t1\n";
+                dumpInstructions(m_out, offset_instr,
+                                 static_cast<long long>(offset));
+            }
+        } else {
+            dumpInstructions(m_out, "    addi t0, s0, %d\n",
+                             static_cast<int>(offset));
+        }
+        return;
+    }
+
+    // The indices are evaluated as rvalues even on the left-hand side.
+    const bool is_lhs = m_lhs;
+    m_lhs = false;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        dispatch(*indices[i]);
+        if (i > 0) {
+            const char *combine_instr = "    lw t1, 0(sp)\n"
+                                        "    addi sp, sp, 4\n"
+                                        "    lw t0, 0(sp)\n"
+                                        "    li t2, %d\n"
+                                        "    mul t0, t0, t2\n"
+                                        "    add t0, t0, t1\n"
+                                        "    sw t0, 0(sp)\n";
+            dumpInstructions(m_out, combine_instr, static_cast<int>(dims[i]));
+        }
+    }
+    m_lhs = is_lhs;
+    const char *scale_instr = "    lw t0, 0(sp)\n"
+                              "    addi sp, sp, 4\n"
+                              "    li t1, %lld\n"
+                              "    mul t0, t0, t1\n";
+    dumpInstructions(m_out, scale_instr, static_cast<long long>(element_size));
+    if (is_global) {
+        const char *base_instr = "    la t1, %s\n"
+                                 "    li t2, %lld\n"
+                                 "    add t1, t1, t2\n";
+        dumpInstructions(m_out, base_instr, p_variable_ref.getNameCString(),
+                         static_cast<long long>(base_offset));
+    } else {
+        dumpInstructions(m_out, "    addi t1, s0, %d\n",
+                         static_cast<int>(base_offset));
+    }
+    dumpInstructions(m_out, "    sub t0, t1, t0\n");
+}
+
+bool CodeGenerator::tryInterchange(ForNode &p_outer) {
+    // The counters of the two loops would be swapped.
+    if (!m_profile_path.empty()) {
+        return false;
+    }
+    ForNode *inner = getPerfectlyNestedLoop(p_outer);
+    if (!inner) {
+        return false;
+    }
+    AccessCollector collector;
+    collector.collect({&p_outer, inner});
+    const LoopAccesses &accesses = collector.getAccesses();
+    if (accesses.has_call || accesses.has_io || accesses.has_return) {
+        return false;
+    }
+
+    // Rows are consecutive, so the last subscript should follow the inner
+    // loop.
+    int num_column_walks = 0;
+    int num_row_walks = 0;
+    for (const auto &access : accesses.accesses) {
+        const auto &subscripts = access.subscripts;
+        if (subscripts.size() < 2 ||
+            subscripts.back().kind != Subscript::Kind::kLoopVariable) {
+            continue;
+        }
+        const size_t other_loop = 1 - subscripts.back().loop;
+        if (std::any_of(subscripts.begin(), subscripts.end() - 1,
+                        [other_loop](const Subscript &p_subscript) {
+                            return p_subscript.kind ==
+                                       Subscript::Kind::kLoopVariable &&
+                                   p_subscript.loop == other_loop;
+                        })) {
+            ++(other_loop == 1 ? num_column_walks : num_row_walks);
+        }
+    }
+    if (num_column_walks <= num_row_walks) {
+        return false;
+    }
+    for (const auto &lhs : accesses.accesses) {
+        for (const auto &rhs : accesses.accesses) {
+            if (lhs.symbol == rhs.symbol && (lhs.is_write || rhs.is_write) &&
+                mayPreventInterchange(lhs, rhs, 2)) {
+                return false;
+            }
+        }
+    }
+
+    emitRemark(p_outer, "interchanged the loops over `%s` and `%s`",
+               p_outer.m_loop_var_decl->getVariables()[0]->getNameCString(),
+               inner->m_loop_var_decl->getVariables()[0]->getNameCString());
+    const ForLoop outer_loop = beginForLoop({inner}, *p_outer.m_body);
+    const ForLoop inner_loop = beginForLoop({&p_outer}, *inner->m_body);
+    dispatch(*inner->m_body);
+    endForLoop(inner_loop);
+    endForLoop(outer_loop);
+    return true;
+}
+
+bool CodeGenerator::tryTiling(ForNode &p_outermost) {
+    // The counters would count the tiles.
+    if (!m_profile_path.empty() || isCold(getCount(p_outermost))) {
+        return false;
+    }
+    const std::vector<ForNode *> nest =
+        getPerfectNest(p_outermost, kMaxTiledNestDepth);
+    if (nest.size() < 2) {
+        return false;
+    }
+    // The two innermost loops are tiled; the tile loops are hoisted out of
+    // the other ones, so matrix multiplication keeps its rows outermost.
+    const size_t num_outer_loops = nest.size() - 2;
+    ForNode &row_loop = *nest[num_outer_loops];
+    ForNode &column_loop = *nest[num_outer_loops + 1];
+    // Two registers for the tile loops and four for the point loops.
+    if (m_num_loop_registers + 6 + 2 * num_outer_loops > kNumLoopRegisters) {
+        return false;
+    }
+
+    AccessCollector collector;
+    collector.collect(nest);
+    const LoopAccesses &accesses = collector.getAccesses();
+    if (accesses.has_call || accesses.has_io || accesses.has_return) {
+        return false;
+    }
+
+    // Tiling pays off only if some access walks a column in the innermost
+    // loop, so that the next element it reads is a row away, and the arrays
+    // don't fit in the cache anyway.
+    const size_t column_loop_index = num_outer_loops + 1;
+    bool has_column_walk = false;
+    std::vector<const SymbolEntry *> arrays;
+    uint64_t arrays_size = 0;
+    for (const auto &access : accesses.accesses) {
+        const auto &dims = access.symbol->getTypePtr()->getDimensions();
+        if (dims.size() < 2) {
+            continue;
+        }
+        has_column_walk |= std::any_of(
+            access.subscripts.begin(),
+            access.subscripts.begin() +
+                std::min(access.subscripts.size(), dims.size() - 1),
+            [column_loop_index](const Subscript &p_subscript) {
+                return p_subscript.kind == Subscript::Kind::kLoopVariable &&
+                       p_subscript.loop == column_loop_index;
+            });
+        if (std::find(arrays.begin(), arrays.end(), access.symbol) ==
+            arrays.end()) {
+            arrays.push_back(access.symbol);
+            uint64_t size = 4;
+            for (const auto dim : dims) {
+                size *= dim;
+            }
+            arrays_size += size;
+        }
+    }
+    if (!has_column_walk || arrays_size <= m_cache_size) {
+        return false;
+    }
+
+    // A tile of each array should take at most half the cache, leaving the
+    // other half to the rows it's reused with.
+    int tile_size = kMinTileSize;
+    while (arrays.size() * 4 * (2 * tile_size) * (2 * tile_size) <=
+           m_cache_size / 2) {
+        tile_size *= 2;
+    }
+    if (getTripCount(row_loop) <= tile_size ||
+        getTripCount(column_loop) <= tile_size) {
+        return false;
+    }
+
+    // The iterations of a tile are moved before those of later tiles; no
+    // two accesses to the same element, one of them a write, may happen in
+    // order in one loop and in reverse order in another.
+    for (const auto &lhs : accesses.accesses) {
+        for (const auto &rhs : accesses.accesses) {
+            if (lhs.symbol == rhs.symbol && (lhs.is_write || rhs.is_write) &&
+                mayPreventInterchange(lhs, rhs, nest.size())) {
+                return false;
+            }
+        }
+    }
+
+    emitRemark(p_outermost, "tiled the loops over `%s` and `%s` by %d",
+               row_loop.m_loop_var_decl->getVariables()[0]->getNameCString(),
+               column_loop.m_loop_var_decl->getVariables()[0]->getNameCString(),
+               tile_size);
+
+    ForNode *const tiled_loops[] = {&row_loop, &column_loop};
+    const char *tile_registers[2];
+    int tile_labels[2];
+    for (int i = 0; i < 2; ++i) {
+        tile_registers[i] = kLoopRegisters[m_num_loop_registers++];
+        tile_labels[i] = m_label_num++;
+        const char *tile_instr = "    li %s, %s\n"
+                                 "L%d:\n";
+        dumpInstructions(m_out, tile_instr, tile_registers[i],
+                         tiled_loops[i]->getLowerBound().getConstantValueCString(),
+                         tile_labels[i]);
+        ++m_loop_depth;
+    }
+    std::vector<ForLoop> outer_loops;
+    for (size_t i = 0; i < num_outer_loops; ++i) {
+        outer_loops.push_back(beginForLoop({nest[i]}, *nest[i]->m_body));
+    }
+
+    // Each point loop runs up to the end of its tile or of its range,
+    // whichever comes first.
+    const char *counter_registers[2];
+    const char *variable_registers[2];
+    SymbolEntry *symbols[2];
+    int point_labels[2];
+    for (int i = 0; i < 2; ++i) {
+        counter_registers[i] = kLoopRegisters[m_num_loop_registers++];
+        variable_registers[i] = kLoopRegisters[m_num_loop_registers++];
+        symbols[i] = declareLoopVariable(*tiled_loops[i]);
+        m_register_variables[symbols[i]] = variable_registers[i];
+        point_labels[i] = m_label_num++;
+        const char *range_instr = "    mv %s, %s\n"
+                                  "    li %s, %s\n"
+                                  "    sub %s, %s, %s\n"
+                                  "    li t0, %d\n";
+        dumpInstructions(m_out, range_instr, variable_registers[i],
+                         tile_registers[i], counter_registers[i],
+                         tiled_loops[i]->getUpperBound().getConstantValueCString(),
+                         counter_registers[i], counter_registers[i],
+                         tile_registers[i], tile_size);
+        if (m_has_zbb) {
+            dumpInstructions(m_out, "    min %s, %s, t0\n", counter_registers[i],
+                             counter_registers[i]);
+        } else {
+            const char *min_instr = "    bge t0, %s, L%d\n"
+                                    "    mv %s, t0\n"
+                                    "L%d:\n";
+            dumpInstructions(m_out, min_instr, counter_registers[i], m_label_num,
+                             counter_registers[i], m_label_num);
+            ++m_label_num;
+        }
+        if (i == 1) {
+            alignLoopHeader(*column_loop.m_body);
+        }
+        dumpInstructions(m_out, "L%d:\n", point_labels[i]);
+        ++m_loop_depth;
+    }
+
+    dispatch(*column_loop.m_body);
+
+    for (int i = 1; i >= 0; --i) {
+        --m_loop_depth;
+        const char *loop_instr = "    addi %s, %s, 1\n"
+                                 "    addi %s, %s, -1\n"
+                                 "    bnez %s, L%d\n";
+        dumpInstructions(m_out, loop_instr, variable_registers[i],
+                         variable_registers[i], counter_registers[i],
+                         counter_registers[i], counter_registers[i],
+                         point_labels[i]);
+        m_register_variables.erase(symbols[i]);
+        m_num_loop_registers -= 2;
+    }
+    for (auto it = outer_loops.rbegin(); it != outer_loops.rend(); ++it) {
+        endForLoop(*it);
+    }
+    for (int i = 1; i >= 0; --i) {
+        --m_loop_depth;
+        const char *tile_instr = "    addi %s, %s, %d\n"
+                                 "    li t0, %s\n"
+                                 "    blt %s, t0, L%d\n";
+        dumpInstructions(m_out, tile_instr, tile_registers[i], tile_registers[i],
+                         tile_size,
+                         tiled_loops[i]->getUpperBound().getConstantValueCString(),
+                         tile_registers[i], tile_labels[i]);
+        --m_num_loop_registers;
+    }
+    return true;
+}
+
+void CodeGenerator::emitRemark(const AstNode &p_node, const char *p_format,
+                               ...) {
+    if (!m_has_remarks) {
+        return;
+    }
+    fprintf(stderr, "%s:%u:%u: remark: ", m_source_file_path.c_str(),
+            p_node.getLocation().getLine(), p_node.getLocation().getCol());
+    va_list args;
+    va_start(args, p_format);
+    vfprintf(stderr, p_format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void CodeGenerator::generateChildNodes(
+    CompoundStatementNode &p_compound_statement) {
+    auto visit_ast_node = [&](auto &ast_node) { dispatch(*ast_node); };
+    for_each(p_compound_statement.getDeclNodes().begin(),
+             p_compound_statement.getDeclNodes().end(), visit_ast_node);
+    auto &statements = p_compound_statement.getStatements();
+    for (size_t i = 0; i < statements.size();) {
+        const auto loops = findFusibleLoops(statements, i);
+        if (loops.size() > 1) {
+            emitRemark(*loops.front(), "fused %zu loops", loops.size());
+            generateForLoops(loops);
+            i += loops.size();
+        } else {
+            dispatch(*statements[i++]);
+        }
+    }
+}
+
+std::vector<ForNode *> CodeGenerator::findFusibleLoops(
+    CompoundStatementNode::StmtNodes &p_statements, const size_t p_begin) {
+    std::vector<ForNode *> loops;
+    std::vector<LoopAccesses> loop_accesses;
+    for (size_t i = p_begin; i < p_statements.size(); ++i) {
+        auto loop = dynamic_cast<ForNode *>(p_statements[i].get());
+        if (!loop ||
+            (!loops.empty() && !haveSameBounds(*loops.front(), *loop))) {
+            break;
+        }
+        AccessCollector collector;
+        collector.collect(*loop);
+        const LoopAccesses &accesses = collector.getAccesses();
+        if (!std::all_of(loop_accesses.begin(), loop_accesses.end(),
+                         [&accesses](const LoopAccesses &p_earlier) {
+                             return canFuse(p_earlier, accesses);
+                         })) {
+            break;
+        }
+        loops.push_back(loop);
+        loop_accesses.push_back(accesses);
+    }
+    return loops;
+}
+
+void CodeGenerator::alignLoopHeader(AstNode &p_body) {
+    // Only innermost loops are aligned since the padding runs on each entry.
+    if (canMoveOutOfLine() && !containsLoop(m_flat_ast, &p_body)) {
+        dumpInstructions(m_out, "    .p2align 4\n");
+    }
+}
+
+CodeGenerator::IfLayout CodeGenerator::chooseIfLayout(IfNode &p_if) const {
+    const bool has_else = p_if.m_else_body != nullptr;
+    if (m_profile && m_function_count > 0) {
+        const uint32_t then_count = getCount(p_if, 1);
+        const uint32_t else_count = getCount(p_if) - then_count;
+        if (isCold(then_count)) {
+            return IfLayout::kThenOutOfLine;
+        }
+        if (has_else && isCold(else_count)) {
+            return IfLayout::kElseOutOfLine;
+        }
+        return (has_else && else_count > then_count) ? IfLayout::kElseFirst
+                                                     : IfLayout::kThenFirst;
+    }
+
+    // A side that leads into a loop is likely (loop-nest heuristic);
+    // otherwise, look at the condition itself.
+    Prediction prediction = Prediction::kUnknown;
+    const bool then_has_loop = containsLoop(m_flat_ast, p_if.m_body.get());
+    const bool else_has_loop = containsLoop(m_flat_ast, p_if.m_else_body.get());
+    if (then_has_loop != else_has_loop) {
+        prediction = then_has_loop ? Prediction::kTaken : Prediction::kNotTaken;
+    } else {
+        prediction = predictCondition(*p_if.m_condition);
+    }
+
+    // In a loop, the unlikely side is moved out of line so that the likely
+    // path takes no branch; elsewhere the likely side just falls through.
+    const bool in_loop = m_loop_depth > 0 && canMoveOutOfLine();
+    switch (prediction) {
+    case Prediction::kTaken:
+        return (has_else && in_loop) ? IfLayout::kElseOutOfLine
+                                     : IfLayout::kThenFirst;
+    case Prediction::kNotTaken:
+        if (in_loop) {
+            return IfLayout::kThenOutOfLine;
+        }
+        return has_else ? IfLayout::kElseFirst : IfLayout::kThenFirst;
+    default:
+        return IfLayout::kThenFirst;
+    }
+}
+
+void CodeGenerator::emitCounterIncrement(const AstNode &p_node,
+                                         const uint32_t p_offset) {
+    if (m_profile_path.empty()) {
+        return;
+    }
+    const uint32_t counter = m_profile_layout->getCounter(p_node) + p_offset;
+    const char *increment_instr =
+        "    lui t0, %%hi(__profile_counters+%u)\n"
+        "    lw t1, %%lo(__profile_counters+%u)(t0)\n"
+        "    addi t1, t1, 1\n"
+        "    sw t1, %%lo(__profile_counters+%u)(t0)\n";
+    dumpInstructions(m_out, increment_instr, counter * 4, counter * 4,
+                     counter * 4);
+}
+
+uint32_t CodeGenerator::getCount(const AstNode &p_node,
+                                 const uint32_t p_offset) const {
+    if (!m_profile) {
+        return 0;
+    }
+    return m_profile->getCount(m_profile_layout->getCounter(p_node) + p_offset);
+}
+
+bool CodeGenerator::isCold(const uint32_t p_count) const {
+    // Nothing is split out of a function that never ran as a whole, nor out
+    // of a block that is already out of line.
+    return m_profile && m_function_count > 0 && p_count == 0 &&
+           canMoveOutOfLine();
+}
+
+void CodeGenerator::beginColdBlock() {
+    if (!m_cold_file) {
+        m_cold_file.reset(tmpfile());
+        assert(m_cold_file.get() && "Failed to create a temporary file");
+    }
+    m_out = m_cold_file.get();
+}
+
+void CodeGenerator::endColdBlock() { m_out = m_output_file.get(); }
+
+void CodeGenerator::flushColdBlocks() {
+    if (!m_cold_file) {
+        return;
+    }
+    rewind(m_cold_file.get());
+    char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), m_cold_file.get())) > 0) {
+        fwrite(buffer, 1, size, m_output_file.get());
+    }
+    m_cold_file.reset();
+}
+
 void CodeGenerator::visit(ProgramNode &p_program) {
     // Generate RISC-V instructions for program header
     // clang-format off
@@ -59,21 +1396,33 @@ void CodeGenerator::visit(ProgramNode &p_program) {
         ".section    .text\n"
         "    .align 2\n";
     // clang-format on
-    dumpInstructions(m_output_file.get(), riscv_assembly_file_prologue,
+    dumpInstructions(m_out, riscv_assembly_file_prologue,
                      m_source_file_path.c_str());
 
-    // Reconstruct the scope for looking up the symbol entry.
-    // Hint: Use m_symbol_manager->lookup(symbol_name) to get the symbol entry.
-    m_symbol_manager.pushScope(
-        std::move(m_symbol_table_of_scoping_nodes.at(&p_program)));
+    m_flat_ast.build(p_program);
 
-    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    auto visit_ast_node = [&](auto &ast_node) { dispatch(*ast_node); };
     for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
              visit_ast_node);
-    for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
-             visit_ast_node);
+    if (m_profile) {
+        // Keep the hot functions together.
+        std::vector<FunctionNode *> functions;
+        for (auto &function : p_program.getFuncNodes()) {
+            functions.push_back(function.get());
+        }
+        std::stable_sort(functions.begin(), functions.end(),
+                         [this](FunctionNode *p_lhs, FunctionNode *p_rhs) {
+                             return getCount(*p_lhs) > getCount(*p_rhs);
+                         });
+        for_each(functions.begin(), functions.end(), visit_ast_node);
+    } else {
+        for_each(p_program.getFuncNodes().begin(),
+                 p_program.getFuncNodes().end(), visit_ast_node);
+    }
 
     constexpr const char *const main_function_prologue = 
+        ".section    .text\n"
+        "    .align 2\n"
         "    .globl main\n"
         "    .type main, @function\n"
         "main:\n"
@@ -81,19 +1430,33 @@ void CodeGenerator::visit(ProgramNode &p_program) {
         "    sw ra, 124(sp)\n"
         "    sw s0, 120(sp)\n"
         "    addi s0, sp, 128\n";
-    dumpInstructions(m_output_file.get(), main_function_prologue);
+    dumpInstructions(m_out, main_function_prologue);
     m_offset = -12;
+    m_function_count = getCount(p_program);
+    emitCounterIncrement(p_program);
 
-    const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+    dispatch(const_cast<CompoundStatementNode &>(p_program.getBody()));
+    if (!m_profile_path.empty()) {
+        const char *const dump_profile_instr =
+            "    lui a0, %%hi(__profile_counters)\n"
+            "    addi a0, a0, %%lo(__profile_counters)\n"
+            "    li a1, %u\n"
+            "    li a2, %d\n"
+            "    lui a3, %%hi(__profile_path)\n"
+            "    addi a3, a3, %%lo(__profile_path)\n"
+            "    jal ra, dumpProfile\n";
+        dumpInstructions(m_out, dump_profile_instr,
+                         m_profile_layout->getNumCounters(),
+                         static_cast<int32_t>(m_profile_layout->getChecksum()));
+    }
     constexpr const char *const main_function_epilogue =
         "    lw ra, 124(sp)\n"
         "    lw s0, 120(sp)\n"
         "    addi sp, sp, 128\n"
-        "    jr ra\n"
-        "    .size main, .-main\n";
-    dumpInstructions(m_output_file.get(), main_function_epilogue);
-
-    m_symbol_manager.popScope();
+        "    jr ra\n";
+    dumpInstructions(m_out, main_function_epilogue);
+    flushColdBlocks();
+    dumpInstructions(m_out, "    .size main, .-main\n");
 
     for(auto& p:m_strings){
         const char *string_instruction =
@@ -101,7 +1464,7 @@ void CodeGenerator::visit(ProgramNode &p_program) {
             "    .align 2\n"
             "%s:\n"
             "    .string \"%s\"\n";
-        dumpInstructions(m_output_file.get(), string_instruction,
+        dumpInstructions(m_out, string_instruction,
                             p.first.c_str(), p.second.c_str());
     }
 
@@ -111,22 +1474,51 @@ void CodeGenerator::visit(ProgramNode &p_program) {
             "    .align 2\n"
             "%s:\n"
             "    .float %s\n";
-        dumpInstructions(m_output_file.get(), real_instruction,
+        dumpInstructions(m_out, real_instruction,
                             p.first.c_str(), p.second.c_str());
     }
+
+    for (const auto &jump_table : m_jump_tables) {
+        dumpInstructions(m_out, ".section .rodata\n"
+                                "    .align 2\n"
+                                "L%d:\n",
+                         jump_table.first);
+        for (const int label : jump_table.second) {
+            dumpInstructions(m_out, "    .word L%d\n", label);
+        }
+    }
+
+    if (!m_profile_path.empty()) {
+        const char *const profile_data =
+            ".comm __profile_counters, %u, 4\n"
+            ".section .rodata\n"
+            "    .align 2\n"
+            "__profile_path:\n"
+            "    .string \"%s\"\n";
+        dumpInstructions(m_out, profile_data,
+                         m_profile_layout->getNumCounters() * 4,
+                         m_profile_path.c_str());
+    }
 }
 
-void CodeGenerator::visit(DeclNode &p_decl) { p_decl.visitChildNodes(*this); }
+void CodeGenerator::visit(DeclNode &p_decl) { visitChildren(p_decl); }
 
 void CodeGenerator::visit(VariableNode &p_variable) {
     bool has_constant = p_variable.getConstantPtr() != nullptr;
-    if (m_symbol_manager.lookup(p_variable.getName())->getLevel() == 0) {
+    if (p_variable.getSymbolEntry()->getLevel() == 0) {
         // Global variable
         if (!has_constant) {
+            // An array takes a word per element since its elements may be
+            // indexed at run time, as the loops that fusion and the other
+            // loop transformations handle do.
+            int size = 4;
+            for (const auto dim : p_variable.getTypePtr()->getDimensions()) {
+                size *= dim;
+            }
             dumpInstructions(
-                m_output_file.get(),
-                ".comm %s, 4, 4\n",
-                p_variable.getNameCString());
+                m_out,
+                ".comm %s, %d, 4\n",
+                p_variable.getNameCString(), size);
         } else {
             // Global constant
             const char *constant_instruction = 
@@ -137,23 +1529,23 @@ void CodeGenerator::visit(VariableNode &p_variable) {
                 "%s:\n"
                 "    .word %s\n";
             dumpInstructions(
-                m_output_file.get(), constant_instruction,
+                m_out, constant_instruction,
                 p_variable.getNameCString(),
                 p_variable.getNameCString(),
                 p_variable.getNameCString(),
                 p_variable.getConstantPtr()->getConstantValueCString());
         }
     } else {
-        SymbolEntry* symbol = m_symbol_manager.lookup(p_variable.getName());
+        SymbolEntry* symbol = p_variable.getSymbolEntry();
         symbol->setOffset(m_offset);
         if (has_constant) {
-            PTypeSharedPtr constant_type = p_variable.getConstantPtr()->getTypeSharedPtr();
+            const PType *constant_type = p_variable.getConstantPtr()->getTypePtr();
             if (constant_type->isPrimitiveInteger()) {
                 const char* assign_instr = 
                     "    addi t0, s0, %d\n"
                     "    li t1, %s\n"
                     "    sw t1, 0(t0)\n";
-                dumpInstructions(m_output_file.get(), assign_instr, m_offset,
+                dumpInstructions(m_out, assign_instr, m_offset,
                                     p_variable.getConstantPtr()->getConstantValueCString());
             } else if (constant_type->isPrimitiveBool()) {
                 bool val = strcmp(p_variable.getConstantPtr()->getConstantValueCString(), "true") == 0;
@@ -161,7 +1553,7 @@ void CodeGenerator::visit(VariableNode &p_variable) {
                     "    addi t0, s0, %d\n"
                     "    li t1, %d\n"
                     "    sw t1, 0(t0)\n";
-                dumpInstructions(m_output_file.get(), assign_instr, m_offset, val);
+                dumpInstructions(m_out, assign_instr, m_offset, val);
             }
         } else if (m_function_para) {
             bool is_scalar = p_variable.getTypePtr()->isScalar();
@@ -174,7 +1566,7 @@ void CodeGenerator::visit(VariableNode &p_variable) {
                     load_instr = "    sw t%d, %d(s0)\n";
                     d -= 8;
                 }
-                dumpInstructions(m_output_file.get(), load_instr.c_str(), d, m_offset);
+                dumpInstructions(m_out, load_instr.c_str(), d, m_offset);
             } else {
                 auto dims = p_variable.getTypePtr()->getDimensions();
                 int size = 1;
@@ -189,7 +1581,7 @@ void CodeGenerator::visit(VariableNode &p_variable) {
                     }
                     lw_instr += "    sw t0, %d(s0)\n";
                     dumpInstructions(
-                        m_output_file.get(),
+                        m_out,
                         lw_instr.c_str(),
                         i*(-4),
                         d,
@@ -208,13 +1600,13 @@ void CodeGenerator::visit(VariableNode &p_variable) {
 }
 
 void CodeGenerator::visit(ConstantValueNode &p_constant_value) {
-    PTypeSharedPtr constantType = p_constant_value.getTypeSharedPtr();
+    const PType *constantType = p_constant_value.getTypePtr();
     if (constantType->isPrimitiveInteger()) {
         const char *constant_instruction =
             "    li t0, %s\n"
             "    addi sp, sp, -4\n"
             "    sw t0, 0(sp)\n";
-        dumpInstructions(m_output_file.get(), constant_instruction,
+        dumpInstructions(m_out, constant_instruction,
                             p_constant_value.getConstantValueCString());
     } else if (constantType->isPrimitiveBool()) {
         const char *constant_instruction =
@@ -222,18 +1614,16 @@ void CodeGenerator::visit(ConstantValueNode &p_constant_value) {
             "    addi sp, sp, -4\n"
             "    sw t0, 0(sp)\n";
         bool val = strcmp(p_constant_value.getConstantValueCString(), "true") == 0;
-        dumpInstructions(m_output_file.get(), constant_instruction, val);
+        dumpInstructions(m_out, constant_instruction, val);
     }
 }
 
 void CodeGenerator::visit(FunctionNode &p_function) {
-    // Reconstruct the scope for looking up the symbol entry.
-    m_symbol_manager.pushScope(
-        std::move(m_symbol_table_of_scoping_nodes.at(&p_function)));
-
-    // Generate function header
+    // Generate function header; functions that never ran are kept apart.
+    m_function_count = getCount(p_function);
+    const bool is_cold_function = m_profile && m_function_count == 0;
     const char *function_prologue =
-        ".section  .text\n"
+        ".section  %s\n"
         "    .align 2\n"
         "    .globl %s\n"
         "    .type  %s, @function\n"
@@ -242,7 +1632,8 @@ void CodeGenerator::visit(FunctionNode &p_function) {
         "    sw ra, 124(sp)\n"
         "    sw s0, 120(sp)\n"
         "    addi s0, sp, 128\n";
-    dumpInstructions(m_output_file.get(), function_prologue,
+    dumpInstructions(m_out, function_prologue,
+                        is_cold_function ? ".text.unlikely" : ".text",
                         p_function.getNameCString(),
                         p_function.getNameCString(),
                         p_function.getNameCString());
@@ -251,44 +1642,40 @@ void CodeGenerator::visit(FunctionNode &p_function) {
 
     m_function_para = true;
     // Generate function parameters
-    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    auto visit_ast_node = [&](auto &ast_node) { dispatch(*ast_node); };
     for_each(p_function.getParameters().begin(), p_function.getParameters().end(), visit_ast_node);
     m_function_para = false;
+    emitCounterIncrement(p_function);
 
     // Generate function body
-    p_function.visitBodyChildNodes(*this);
+    if (p_function.getBody()) {
+        generateChildNodes(
+            const_cast<CompoundStatementNode &>(*p_function.getBody()));
+    }
 
     // Generate function epilogue
     const char *const function_epilogue =
         "    lw ra, 124(sp)\n"
         "    lw s0, 120(sp)\n"
         "    addi sp, sp, 128\n"
-        "    jr ra\n"
-        "    .size %s, .-%s\n";
-    dumpInstructions(m_output_file.get(), function_epilogue,
+        "    jr ra\n";
+    dumpInstructions(m_out, function_epilogue);
+    flushColdBlocks();
+    dumpInstructions(m_out, "    .size %s, .-%s\n",
                         p_function.getNameCString(),
                         p_function.getNameCString());
-
-    // Remove the entries in the hash table
-    m_symbol_manager.popScope();
 }
 
 void CodeGenerator::visit(CompoundStatementNode &p_compound_statement) {
-    // Reconstruct the scope for looking up the symbol entry.
-    m_symbol_manager.pushScope(
-        std::move(m_symbol_table_of_scoping_nodes.at(&p_compound_statement)));
-
-    p_compound_statement.visitChildNodes(*this);
+    generateChildNodes(p_compound_statement);
     // for (auto &stmt: p_compound_statement.getStatements()) {
     //     if (m_has_return) break;
-    //     stmt->accept(*this);
+    //     dispatch(*stmt);
     // }
-
-    m_symbol_manager.popScope();
 }
 
 void CodeGenerator::visit(PrintNode &p_print) {
-    p_print.visitChildNodes(*this);
+    visitChildren(p_print);
     std::string function_name;
     switch(p_print.getTarget().getInferredType()->getPrimitiveType()) {
         case PType::PrimitiveTypeEnum::kIntegerType:
@@ -308,18 +1695,18 @@ void CodeGenerator::visit(PrintNode &p_print) {
             "    flw fa0, 0(sp)\n"
             "    addi sp, sp, 4\n"
             "    jal ra, %s\n";
-        dumpInstructions(m_output_file.get(), print_instr, function_name.c_str());
+        dumpInstructions(m_out, print_instr, function_name.c_str());
     } else {
         const char* print_instr =
             "    lw a0, 0(sp)\n"
             "    addi sp, sp, 4\n"
             "    jal ra, %s\n";
-        dumpInstructions(m_output_file.get(), print_instr, function_name.c_str());
+        dumpInstructions(m_out, print_instr, function_name.c_str());
     }
 }
 
 void CodeGenerator::visit(BinaryOperatorNode &p_bin_op) {
-    p_bin_op.visitChildNodes(*this);
+    visitChildren(p_bin_op);
     std::string binary_instr;
     bool is_real = p_bin_op.getInferredType()->isReal();
     switch(p_bin_op.getOp()){
@@ -394,12 +1781,12 @@ void CodeGenerator::visit(BinaryOperatorNode &p_bin_op) {
                       "    addi sp, sp, -4\n"
                       "    sw t0, 0(sp)\n";
     }
-    dumpInstructions(m_output_file.get(), final_instr.c_str(), binary_instr.c_str());
+    dumpInstructions(m_out, final_instr.c_str(), binary_instr.c_str());
 
 }
 
 void CodeGenerator::visit(UnaryOperatorNode &p_un_op) {
-    p_un_op.visitChildNodes(*this);
+    visitChildren(p_un_op);
     std::string unary_instr;
     std::string op;
     switch (p_un_op.getOp()) {
@@ -420,48 +1807,67 @@ void CodeGenerator::visit(UnaryOperatorNode &p_un_op) {
         default:
             assert(false && "Unsupported unary operator");
     }
-    dumpInstructions(m_output_file.get(), unary_instr.c_str());
+    dumpInstructions(m_out, unary_instr.c_str());
 }
 
 void CodeGenerator::visit(FunctionInvocationNode &p_func_invocation) {
-    p_func_invocation.visitChildNodes(*this);
+    emitCounterIncrement(p_func_invocation);
+    visitChildren(p_func_invocation);
     int arg_count = p_func_invocation.getArguments().size();
     for(int i=arg_count-1; i>=0; i--){
         std::string move_instr;
         if (i>=8) {
             move_instr = "    lw t%d, 0(sp)\n"
                          "    addi sp, sp, 4\n";
-            dumpInstructions(m_output_file.get(), move_instr.c_str(), i-8);
+            dumpInstructions(m_out, move_instr.c_str(), i-8);
         } else {
             move_instr = "    lw a%d, 0(sp)\n"
                          "    addi sp, sp, 4\n";
-            dumpInstructions(m_output_file.get(), move_instr.c_str(), i);
+            dumpInstructions(m_out, move_instr.c_str(), i);
         }
     }
     std::string function_name = p_func_invocation.getNameCString();
     const char* call_instr = "    jal ra, %s\n";
-    dumpInstructions(m_output_file.get(), call_instr, function_name.c_str());
-    SymbolEntry* symbol_entry = m_symbol_manager.lookup(function_name);
+    dumpInstructions(m_out, call_instr, function_name.c_str());
+    SymbolEntry* symbol_entry = p_func_invocation.getSymbolEntry();
     if (!symbol_entry->getTypePtr()->isVoid()) {
         const char* push_instr = "    mv t0, a0\n"
                                  "    addi sp, sp, -4\n"
                                  "    sw t0, 0(sp)\n";
-        dumpInstructions(m_output_file.get(), push_instr);
+        dumpInstructions(m_out, push_instr);
     }
 }
 
 void CodeGenerator::visit(VariableReferenceNode &p_variable_ref) {
-    SymbolEntry *symbol_entry = m_symbol_manager.lookup(p_variable_ref.getName());
+    SymbolEntry *symbol_entry = p_variable_ref.getSymbolEntry();
+    auto register_it = m_register_variables.find(symbol_entry);
+    if (register_it != m_register_variables.end()) {
+        // A loop variable kept in a register is only read.
+        const char *push_instr = "    addi sp, sp, -4\n"
+                                 "    sw %s, 0(sp)\n";
+        dumpInstructions(m_out, push_instr, register_it->second);
+        m_lhs = false;
+        return;
+    }
     if (symbol_entry->getLevel() == 0) {
         // Global variable
-        const char *load_instr = "    la t0, %s\n";
-        dumpInstructions(m_output_file.get(), load_instr,
-                            p_variable_ref.getNameCString());
+        if (symbol_entry->getTypePtr()->isScalar()) {
+            const char *load_instr = "    la t0, %s\n";
+            dumpInstructions(m_out, load_instr,
+                                p_variable_ref.getNameCString());
+        } else {
+            emitElementAddress(p_variable_ref, *symbol_entry);
+            // A whole (sub)array is passed by its address.
+            if (p_variable_ref.getIndices().size() <
+                symbol_entry->getTypePtr()->getDimensions().size()) {
+                m_lhs = true;
+            }
+        }
     } else if (symbol_entry->getTypePtr()->isPrimitiveString()){
         if(m_lhs == false){
             const char* get_string = "    lui t0, %%hi(%s)\n"
                                      "    addi t0, t0, %%lo(%s)\n";
-            dumpInstructions(m_output_file.get(), get_string,
+            dumpInstructions(m_out, get_string,
                                 p_variable_ref.getNameCString(),
                                 p_variable_ref.getNameCString());
         }
@@ -472,69 +1878,57 @@ void CodeGenerator::visit(VariableReferenceNode &p_variable_ref) {
                 "   lui t0, %%hi(%s)\n"
                 "   flw ft0, %%lo(%s)(t0)\n"
                 "   fsw ft0, %d(s0)\n";
-            dumpInstructions(m_output_file.get(), get_real,
+            dumpInstructions(m_out, get_real,
                                 p_variable_ref.getNameCString(),
                                 p_variable_ref.getNameCString(),
                                 symbol_entry->getOffset());
             return;
         } else {
             const char *get_real = "    flw ft0, %d(s0)\n";
-            dumpInstructions(m_output_file.get(), get_real,
+            dumpInstructions(m_out, get_real,
                                 symbol_entry->getOffset());
         }
         m_lhs = true;
-    } else {
+    } else if (symbol_entry->getTypePtr()->isScalar()) {
         const char *assign_instr = "    addi t0, s0, %d\n";
-        int offset = symbol_entry->getOffset();
-        bool is_ref_array = !symbol_entry->getTypePtr()->isScalar();
-        if (!symbol_entry->getTypePtr()->isScalar()) {
-            auto dims = symbol_entry->getTypePtr()->getDimensions();
-            reverse(dims.begin(), dims.end());
-            auto &index = p_variable_ref.getIndices();
-            int total = 1;
-            int size = 0;
-            // for(auto it=index.rbegin(); it!=index.rend(); ++it){
-            for(int i=index.size()-1, j=dims.size()-1; i>=0 && j>=0; --i, --j){
-                is_ref_array = false;
-                auto constant = dynamic_cast<ConstantValueNode *>(index[i].get());
-                int val = std::stoi(constant->getConstantPtr()->getConstantValueCString());
-                size += val * total;
-                total *= dims[j];
-            }
-            offset -= size * 4;
+        dumpInstructions(m_out, assign_instr, symbol_entry->getOffset());
+    } else {
+        emitElementAddress(p_variable_ref, *symbol_entry);
+        // A whole (sub)array is passed by its address.
+        if (p_variable_ref.getIndices().size() <
+            symbol_entry->getTypePtr()->getDimensions().size()) {
+            m_lhs = true;
         }
-        dumpInstructions(m_output_file.get(), assign_instr, offset);
-        if(is_ref_array) m_lhs = true;
     }
 
     if (!m_lhs){
         const char *load_instr = "    lw t0, 0(t0)\n";
-        dumpInstructions(m_output_file.get(), load_instr);
+        dumpInstructions(m_out, load_instr);
     }
     m_lhs = false;
     const char* push_instr = "    addi sp, sp, -4\n"
                              "    %ssw %st0, 0(sp)\n";
-    dumpInstructions(m_output_file.get(), push_instr,
+    dumpInstructions(m_out, push_instr,
                         (symbol_entry->getTypePtr()->isReal() ? "f" : ""),
                         (symbol_entry->getTypePtr()->isReal() ? "f" : ""));
     
 }
 
 void CodeGenerator::visit(AssignmentNode &p_assignment) {
-    bool is_string = m_symbol_manager.lookup(p_assignment.getLvalue().getName())
+    bool is_string = p_assignment.getLvalue().getSymbolEntry()
                          ->getTypePtr()
                          ->isPrimitiveString();
-    bool is_real = m_symbol_manager.lookup(p_assignment.getLvalue().getName())
+    bool is_real = p_assignment.getLvalue().getSymbolEntry()
                          ->getTypePtr()
                          ->isPrimitiveReal();
     if (is_string || is_real) {
         auto rval = dynamic_cast<ConstantValueNode *>(&p_assignment.getExpr());
         if (rval && is_real)  {
             m_lhs = true;
-            p_assignment.getLvalue().accept(*this);
+            dispatch(p_assignment.getLvalue());
             m_lhs = false;
         }
-        p_assignment.getExpr().accept(*this);
+        dispatch(p_assignment.getExpr());
         if (is_string) {
             m_strings.push_back(std::make_pair(p_assignment.getLvalue().getName(),
                                                rval->getConstantPtr()->getConstantValueCString()));
@@ -546,27 +1940,27 @@ void CodeGenerator::visit(AssignmentNode &p_assignment) {
                 const char *assign_instr = "    flw ft0, 0(sp)\n"
                                            "    addi sp, sp, 4\n"
                                            "    fsw ft0, %d(s0)\n";
-                dumpInstructions(m_output_file.get(), assign_instr,
-                                    m_symbol_manager.lookup(p_assignment.getLvalue().getName())->getOffset());
+                dumpInstructions(m_out, assign_instr,
+                                    p_assignment.getLvalue().getSymbolEntry()->getOffset());
             }
         }
     } else {
         m_lhs = true;
-        p_assignment.getLvalue().accept(*this);
+        dispatch(p_assignment.getLvalue());
         m_lhs = false;
-        p_assignment.getExpr().accept(*this);
+        dispatch(p_assignment.getExpr());
         const char *assign_instr = "    lw t0, 0(sp)\n"
                                    "    addi sp, sp, 4\n"
                                    "    lw t1, 0(sp)\n"
                                    "    addi sp, sp, 4\n"
                                    "    sw t0, 0(t1)\n";
-        dumpInstructions(m_output_file.get(), assign_instr);
+        dumpInstructions(m_out, assign_instr);
     }
 }
 
 void CodeGenerator::visit(ReadNode &p_read) {
     m_lhs = true;
-    p_read.visitChildNodes(*this);
+    visitChildren(p_read);
     m_lhs = false;
 
     std::string function_name;
@@ -585,91 +1979,263 @@ void CodeGenerator::visit(ReadNode &p_read) {
                              "    lw t1, 0(sp)\n"
                              "    addi sp, sp, 4\n"
                              "    sw t0, 0(t1)\n";
-    dumpInstructions(m_output_file.get(), read_instr, function_name.c_str());
+    dumpInstructions(m_out, read_instr, function_name.c_str());
 }
 
 void CodeGenerator::visit(IfNode &p_if) {
+    auto unswitched = m_unswitched_conditions.find(&p_if);
+    if (unswitched != m_unswitched_conditions.end()) {
+        // The condition has been tested before the loop.
+        emitCounterIncrement(p_if);
+        if (unswitched->second) {
+            emitCounterIncrement(p_if, 1);
+            dispatch(*p_if.m_body);
+        } else if (p_if.m_else_body) {
+            dispatch(*p_if.m_else_body);
+        }
+        return;
+    }
+    if (tryIfConversion(p_if) || trySwitchLowering(p_if)) {
+        return;
+    }
+
     bool has_else = p_if.m_else_body != nullptr;
     std::vector<int> labels = {m_label_num, m_label_num + 1};
 
     if (has_else) labels.push_back(m_label_num + 2);
     m_label_num += has_else+2;
 
-    p_if.m_condition->accept(*this);
-    const char* jump_instr = "    lw t0, 0(sp)\n"
-                             "    addi sp, sp, 4\n"
-                             "    beq t0, zero, L%d\n";
-    dumpInstructions(m_output_file.get(), jump_instr, labels[1]);
-    dumpInstructions(m_output_file.get(), "L%d:\n", labels[0]);
+    const IfLayout layout = chooseIfLayout(p_if);
 
-    p_if.m_body->accept(*this);
-    if (has_else) {
-        const char* jump_instr = "    j L%d\n"
-                                 "L%d:\n";
-        dumpInstructions(m_output_file.get(), jump_instr, labels[2], labels[1]);
-        p_if.m_else_body->accept(*this);
-        dumpInstructions(m_output_file.get(), "L%d:\n", labels[2]);
-    } else {
-        dumpInstructions(m_output_file.get(), "L%d:\n", labels[1]);
-    }
+    emitCounterIncrement(p_if);
+    dispatch(*p_if.m_condition);
+    const char *pop_instr = "    lw t0, 0(sp)\n"
+                            "    addi sp, sp, 4\n";
+    dumpInstructions(m_out, pop_instr);
+
+    switch (layout) {
+    case IfLayout::kThenOutOfLine:
+        dumpInstructions(m_out, "    bne t0, zero, L%d\n", labels[0]);
+        if (has_else) dispatch(*p_if.m_else_body);
+        dumpInstructions(m_out, "L%d:\n", labels.back());
 
+        beginColdBlock();
+        dumpInstructions(m_out, "L%d:\n", labels[0]);
+        emitCounterIncrement(p_if, 1);
+        dispatch(*p_if.m_body);
+        dumpInstructions(m_out, "    j L%d\n", labels.back());
+        endColdBlock();
+        break;
+    case IfLayout::kElseOutOfLine:
+        dumpInstructions(m_out, "    beq t0, zero, L%d\n", labels[1]);
+        dumpInstructions(m_out, "L%d:\n", labels[0]);
+        emitCounterIncrement(p_if, 1);
+        dispatch(*p_if.m_body);
+        dumpInstructions(m_out, "L%d:\n", labels[2]);
+
+        beginColdBlock();
+        dumpInstructions(m_out, "L%d:\n", labels[1]);
+        dispatch(*p_if.m_else_body);
+        dumpInstructions(m_out, "    j L%d\n", labels[2]);
+        endColdBlock();
+        break;
+    case IfLayout::kElseFirst:
+        dumpInstructions(m_out, "    bne t0, zero, L%d\n", labels[0]);
+        dumpInstructions(m_out, "L%d:\n", labels[1]);
+        dispatch(*p_if.m_else_body);
+        dumpInstructions(m_out, "    j L%d\n", labels[2]);
+        dumpInstructions(m_out, "L%d:\n", labels[0]);
+        emitCounterIncrement(p_if, 1);
+        dispatch(*p_if.m_body);
+        dumpInstructions(m_out, "L%d:\n", labels[2]);
+        break;
+    case IfLayout::kThenFirst:
+        dumpInstructions(m_out, "    beq t0, zero, L%d\n", labels[1]);
+        dumpInstructions(m_out, "L%d:\n", labels[0]);
+        emitCounterIncrement(p_if, 1);
+        dispatch(*p_if.m_body);
+        if (has_else) {
+            const char* jump_instr = "    j L%d\n"
+                                     "L%d:\n";
+            dumpInstructions(m_out, jump_instr, labels[2], labels[1]);
+            dispatch(*p_if.m_else_body);
+            dumpInstructions(m_out, "L%d:\n", labels[2]);
+        } else {
+            dumpInstructions(m_out, "L%d:\n", labels[1]);
+        }
+        break;
+    }
 }
 
 void CodeGenerator::visit(WhileNode &p_while) {
+    if (tryUnswitching(p_while)) {
+        return;
+    }
+
+    // The loop is rotated: the condition is tested once before the loop and
+    // then at the bottom, so that each iteration takes a single branch.
     std::vector<int> labels = {m_label_num, m_label_num + 1};
     m_label_num += 2;
-    dumpInstructions(m_output_file.get(), "L%d:\n", labels[0]);
-    p_while.m_condition->accept(*this);
-    const char* jump_instr = "    lw t0, 0(sp)\n"
-                             "    addi sp, sp, 4\n"
-                             "    beq t0, zero, L%d\n";
-    dumpInstructions(m_output_file.get(), jump_instr, labels[1]);
-    p_while.m_body->accept(*this);
-    const char *jump_instr2 = "    j L%d\n"
-                             "L%d:\n";
-    dumpInstructions(m_output_file.get(), jump_instr2, labels[0], labels[1]);
+    const bool is_cold_body = isCold(getCount(p_while));
+
+    const char *pop_instr = "    lw t0, 0(sp)\n"
+                            "    addi sp, sp, 4\n";
+    dispatch(*p_while.m_condition);
+    dumpInstructions(m_out, pop_instr);
+    if (is_cold_body) {
+        // Move the whole loop out of line.
+        const char *enter_loop_instr = "    bne t0, zero, L%d\n"
+                                       "L%d:\n";
+        dumpInstructions(m_out, enter_loop_instr, labels[0], labels[1]);
+        beginColdBlock();
+    } else {
+        dumpInstructions(m_out, "    beq t0, zero, L%d\n", labels[1]);
+        alignLoopHeader(*p_while.m_body);
+    }
+    dumpInstructions(m_out, "L%d:\n", labels[0]);
+
+    ++m_loop_depth;
+    emitCounterIncrement(p_while);
+    dispatch(*p_while.m_body);
+    --m_loop_depth;
+
+    dispatch(*p_while.m_condition);
+    dumpInstructions(m_out, pop_instr);
+    dumpInstructions(m_out, "    bne t0, zero, L%d\n", labels[0]);
+    if (is_cold_body) {
+        dumpInstructions(m_out, "    j L%d\n", labels[1]);
+        endColdBlock();
+    } else {
+        dumpInstructions(m_out, "L%d:\n", labels[1]);
+    }
 }
 
 void CodeGenerator::visit(ForNode &p_for) {
-    // Reconstruct the scope for looking up the symbol entry.
-    std::vector<int> labels = {m_label_num, m_label_num + 1, m_label_num + 2};
-    m_label_num += 3;
+    if (tryUnswitching(p_for) || tryInterchange(p_for) || tryTiling(p_for)) {
+        return;
+    }
+    generateForLoops({&p_for});
+}
 
-    m_symbol_manager.pushScope(
-        std::move(m_symbol_table_of_scoping_nodes.at(&p_for)));
+void CodeGenerator::generateForLoops(const std::vector<ForNode *> &p_loops) {
+    const ForLoop for_loop = beginForLoop(p_loops, *p_loops.front()->m_body);
+    for (ForNode *loop : p_loops) {
+        emitCounterIncrement(*loop);
+        dispatch(*loop->m_body);
+    }
+    endForLoop(for_loop);
+}
 
-    p_for.m_loop_var_decl->accept(*this);
-    p_for.m_init_stmt->accept(*this);
+CodeGenerator::ForLoop
+CodeGenerator::beginForLoop(const std::vector<ForNode *> &p_loops,
+                            AstNode &p_body) {
+    ForNode &first_loop = *p_loops.front();
+    ForLoop for_loop;
+    for_loop.loops = p_loops;
+    for_loop.labels[0] = m_label_num;
+    for_loop.labels[1] = m_label_num + 1;
+    m_label_num += 2;
 
-    dumpInstructions(m_output_file.get(), "L%d:\n", labels[0]);
-    p_for.m_end_condition->accept(*this);
+    // The loop variables of fused loops share the slot of the first one.
+    auto &symbols = for_loop.symbols;
+    for (ForNode *loop : p_loops) {
+        const int offset = m_offset;
+        symbols.push_back(declareLoopVariable(*loop));
+        if (symbols.size() > 1) {
+            symbols.back()->setOffset(symbols.front()->getOffset());
+            m_offset = offset;
+        }
+    }
 
-    SymbolEntry *symbol = m_symbol_manager.lookup(p_for.m_loop_var_decl->getVariables()[0]->getName());
-    const char *decl_instr = "    addi t0, s0, %d\n"
-                             "    lw t0, 0(t0)\n"
-                             "    lw t1, 0(sp)\n"
-                             "    addi sp, sp, 4\n";
-    dumpInstructions(m_output_file.get(), decl_instr, symbol->getOffset());
-    const char* exit_loop_instr = "    bge t0, t1, L%d\n"
-                                  "L%d:\n";
-    dumpInstructions(m_output_file.get(), exit_loop_instr, labels[2], labels[1]);
-    p_for.m_body->accept(*this);
-    const char *increase_loop_var = "    addi t0, s0, %d\n"
-                                    "    lw t1, 0(t0)\n"
-                                    "    addi t1, t1, 1\n"
-                                    "    sw t1, 0(t0)\n";
-    dumpInstructions(m_output_file.get(), increase_loop_var, symbol->getOffset());
-    const char *jump_instr = "    j L%d\n"
-                             "L%d:\n";
-    dumpInstructions(m_output_file.get(), jump_instr, labels[0], labels[2]);
-    // Remove the entries in the hash table
-    m_symbol_manager.popScope();
+    // A body that doesn't call out is counted down in a register, and the
+    // loop variable is kept in another; otherwise, both live in memory.
+    const int lower_bound = std::stoi(first_loop.getLowerBound().getConstantValueCString());
+    const int upper_bound = std::stoi(first_loop.getUpperBound().getConstantValueCString());
+    const bool is_counted =
+        lower_bound < upper_bound &&
+        m_num_loop_registers + 2 <= kNumLoopRegisters &&
+        std::none_of(p_loops.begin(), p_loops.end(), [this](ForNode *p_loop) {
+            return containsCall(m_flat_ast, *p_loop->m_body);
+        });
+    if (is_counted) {
+        for_loop.counter_register = kLoopRegisters[m_num_loop_registers++];
+        for_loop.variable_register = kLoopRegisters[m_num_loop_registers++];
+        const char *init_instr = "    li %s, %d\n"
+                                 "    li %s, %d\n";
+        dumpInstructions(m_out, init_instr, for_loop.counter_register,
+                         upper_bound - lower_bound, for_loop.variable_register,
+                         lower_bound);
+        for (SymbolEntry *symbol : symbols) {
+            m_register_variables[symbol] = for_loop.variable_register;
+        }
+    } else {
+        dispatch(*first_loop.m_init_stmt);
+    }
+
+    // The bounds are literals and the lower one is less than the upper one,
+    // so the body runs at least once and the loop needs no guard; the loop
+    // variable is tested at the bottom.
+    for_loop.is_cold_body = isCold(getCount(first_loop));
+    if (for_loop.is_cold_body) {
+        // Move the whole loop out of line.
+        const char *enter_loop_instr = "    j L%d\n"
+                                       "L%d:\n";
+        dumpInstructions(m_out, enter_loop_instr, for_loop.labels[0],
+                         for_loop.labels[1]);
+        beginColdBlock();
+    } else {
+        alignLoopHeader(p_body);
+    }
+    dumpInstructions(m_out, "L%d:\n", for_loop.labels[0]);
+    ++m_loop_depth;
+    return for_loop;
+}
+
+SymbolEntry *CodeGenerator::declareLoopVariable(ForNode &p_for) {
+    dispatch(*p_for.m_loop_var_decl);
+    return p_for.m_loop_var_decl->getVariables()[0]->getSymbolEntry();
+}
+
+void CodeGenerator::endForLoop(const ForLoop &p_for_loop) {
+    --m_loop_depth;
+    if (p_for_loop.counter_register) {
+        const char *counter_register = p_for_loop.counter_register;
+        const char *variable_register = p_for_loop.variable_register;
+        const char *loop_instr = "    addi %s, %s, 1\n"
+                                 "    addi %s, %s, -1\n"
+                                 "    bnez %s, L%d\n";
+        dumpInstructions(m_out, loop_instr, variable_register,
+                         variable_register, counter_register, counter_register,
+                         counter_register, p_for_loop.labels[0]);
+        for (SymbolEntry *symbol : p_for_loop.symbols) {
+            m_register_variables.erase(symbol);
+        }
+        m_num_loop_registers -= 2;
+    } else {
+        const int offset = p_for_loop.symbols.front()->getOffset();
+        const char *increase_loop_var = "    addi t0, s0, %d\n"
+                                        "    lw t1, 0(t0)\n"
+                                        "    addi t1, t1, 1\n"
+                                        "    sw t1, 0(t0)\n";
+        dumpInstructions(m_out, increase_loop_var, offset);
+        dispatch(*p_for_loop.loops.front()->m_end_condition);
+        const char *loop_instr = "    addi t0, s0, %d\n"
+                                 "    lw t0, 0(t0)\n"
+                                 "    lw t1, 0(sp)\n"
+                                 "    addi sp, sp, 4\n"
+                                 "    blt t0, t1, L%d\n";
+        dumpInstructions(m_out, loop_instr, offset, p_for_loop.labels[0]);
+    }
+    if (p_for_loop.is_cold_body) {
+        dumpInstructions(m_out, "    j L%d\n", p_for_loop.labels[1]);
+        endColdBlock();
+    }
 }
 
 void CodeGenerator::visit(ReturnNode &p_return) {
-    p_return.visitChildNodes(*this);
+    visitChildren(p_return);
     const char* return_instr = "    lw a0, 0(sp)\n"
                                "    addi sp, sp, 4\n";
-    dumpInstructions(m_output_file.get(), return_instr);
+    dumpInstructions(m_out, return_instr);
     m_has_return = true;
 }
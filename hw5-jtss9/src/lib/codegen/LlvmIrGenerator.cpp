@@ -0,0 +1,709 @@
+#include "codegen/LlvmIrGenerator.hpp"
+
+#include "AST/TypeContext.hpp"
+#include "util/OutputPath.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+void dumpInstructions(FILE *p_out_file, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(p_out_file, format, args);
+    va_end(args);
+}
+
+std::string getScalarIrType(const PType &p_type) {
+    switch (p_type.getPrimitiveType()) {
+    case PType::PrimitiveTypeEnum::kIntegerType:
+    case PType::PrimitiveTypeEnum::kBoolType:
+        return "i32";
+    case PType::PrimitiveTypeEnum::kRealType:
+        return "float";
+    case PType::PrimitiveTypeEnum::kStringType:
+        return "ptr";
+    case PType::PrimitiveTypeEnum::kVoidType:
+        return "void";
+    default:
+        assert(false && "Unsupported type");
+        return "";
+    }
+}
+
+std::string getIrType(const PType &p_type) {
+    std::string type = getScalarIrType(p_type);
+    const auto &dims = p_type.getDimensions();
+    for (auto it = dims.rbegin(); it != dims.rend(); ++it) {
+        type = "[" + std::to_string(*it) + " x " + type + "]";
+    }
+    return type;
+}
+
+/// @return The type of a value of `p_type`; arrays are passed by address.
+std::string getValueIrType(const PType &p_type) {
+    return p_type.isScalar() || p_type.isVoid() ? getScalarIrType(p_type)
+                                                : "ptr";
+}
+
+uint64_t getStorageSize(const PType &p_type) {
+    uint64_t size = p_type.isPrimitiveString() ? 8 : 4;
+    for (const auto dim : p_type.getDimensions()) {
+        size *= dim;
+    }
+    return size;
+}
+
+/// @brief LLVM spells a `float` constant as the hexadecimal `double` of the
+/// same value.
+std::string formatReal(const double p_value) {
+    const double value = static_cast<float>(p_value);
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "0x%016llX",
+             static_cast<unsigned long long>(bits));
+    return buffer;
+}
+
+std::string formatConstant(const Constant &p_constant) {
+    const PType &type = *p_constant.getTypePtr();
+    if (type.isPrimitiveInteger()) {
+        return std::to_string(static_cast<int32_t>(p_constant.integer()));
+    }
+    if (type.isPrimitiveReal()) {
+        return formatReal(p_constant.real());
+    }
+    if (type.isPrimitiveBool()) {
+        return p_constant.boolean() ? "1" : "0";
+    }
+    assert(false && "Strings are emitted as literals");
+    return "";
+}
+
+std::string getZeroValue(const PType &p_type) {
+    if (p_type.isReal()) {
+        return "0.0";
+    }
+    if (p_type.isString()) {
+        return "null";
+    }
+    return "0";
+}
+
+bool isComparison(const Operator p_op) {
+    switch (p_op) {
+    case Operator::kLessOp:
+    case Operator::kLessOrEqualOp:
+    case Operator::kGreaterOp:
+    case Operator::kGreaterOrEqualOp:
+    case Operator::kEqualOp:
+    case Operator::kNotEqualOp:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const char *getComparePredicate(const Operator p_op, const bool p_is_real) {
+    switch (p_op) {
+    case Operator::kLessOp:
+        return p_is_real ? "fcmp olt" : "icmp slt";
+    case Operator::kLessOrEqualOp:
+        return p_is_real ? "fcmp ole" : "icmp sle";
+    case Operator::kGreaterOp:
+        return p_is_real ? "fcmp ogt" : "icmp sgt";
+    case Operator::kGreaterOrEqualOp:
+        return p_is_real ? "fcmp oge" : "icmp sge";
+    case Operator::kEqualOp:
+        return p_is_real ? "fcmp oeq" : "icmp eq";
+    case Operator::kNotEqualOp:
+        return p_is_real ? "fcmp une" : "icmp ne";
+    default:
+        assert(false && "Not a comparison");
+        return "";
+    }
+}
+
+/// @return The type both operands are converted to before the operation.
+const PType &getOperandType(const BinaryOperatorNode &p_bin_op) {
+    const auto *left_type = p_bin_op.getLeftOperand().getInferredType();
+    const auto *right_type = p_bin_op.getRightOperand().getInferredType();
+    if (left_type->isReal() || right_type->isReal()) {
+        return *TypeContext::types().getType(
+            PType::PrimitiveTypeEnum::kRealType);
+    }
+    return *left_type;
+}
+
+// clang-format off
+constexpr const char *const kRuntimeDeclarations =
+    "declare void @printInt(i32)\n"
+    "declare i32 @readInt()\n"
+    "declare void @printReal(float)\n"
+    "declare float @readReal()\n"
+    "declare void @printString(ptr)\n"
+    "declare void @llvm.memcpy.p0.p0.i64(ptr, ptr, i64, i1)\n";
+
+/// NOTE: The result of `+` on strings is never freed.
+constexpr const char *const kConcatDefinition =
+    "\n"
+    "declare i64 @strlen(ptr)\n"
+    "declare ptr @malloc(i64)\n"
+    "\n"
+    "define private ptr @p.concat(ptr %%lhs, ptr %%rhs) {\n"
+    "entry:\n"
+    "  %%lhs.len = call i64 @strlen(ptr %%lhs)\n"
+    "  %%rhs.len = call i64 @strlen(ptr %%rhs)\n"
+    "  %%rhs.size = add i64 %%rhs.len, 1\n"
+    "  %%size = add i64 %%lhs.len, %%rhs.size\n"
+    "  %%result = call ptr @malloc(i64 %%size)\n"
+    "  call void @llvm.memcpy.p0.p0.i64(ptr %%result, ptr %%lhs, i64 %%lhs.len, i1 false)\n"
+    "  %%tail = getelementptr inbounds i8, ptr %%result, i64 %%lhs.len\n"
+    "  call void @llvm.memcpy.p0.p0.i64(ptr %%tail, ptr %%rhs, i64 %%rhs.size, i1 false)\n"
+    "  ret ptr %%result\n"
+    "}\n";
+// clang-format on
+
+} // namespace
+
+LlvmIrGenerator::LlvmIrGenerator(
+    const std::string &source_file_name, const std::string &save_path,
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        &&p_symbol_table_of_scoping_nodes)
+    : m_source_file_path(source_file_name),
+      m_symbol_table_of_scoping_nodes(
+          std::move(p_symbol_table_of_scoping_nodes)) {
+    m_output_file_path = getOutputPath(source_file_name, save_path, ".ll");
+    m_output_file.reset(fopen(m_output_file_path.c_str(), "w"));
+    assert(m_output_file.get() && "Failed to open output file");
+}
+
+void LlvmIrGenerator::emit(const char *format, ...) {
+    // Code after a terminator (e.g., a `return`) is unreachable, but still
+    // has to be in a block.
+    if (m_is_block_terminated) {
+        startBlock(newLabel());
+    }
+
+    va_list args;
+    va_start(args, format);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const int length = vsnprintf(nullptr, 0, format, args_copy);
+    va_end(args_copy);
+    std::string instruction(static_cast<size_t>(length) + 1, '\0');
+    vsnprintf(&instruction[0], instruction.size(), format, args);
+    va_end(args);
+    instruction.pop_back();
+
+    m_body += "  " + instruction + "\n";
+}
+
+std::string LlvmIrGenerator::newTemp() {
+    return "%t" + std::to_string(m_temp_num++);
+}
+
+std::string LlvmIrGenerator::newLabel() {
+    return "L" + std::to_string(m_label_num++);
+}
+
+void LlvmIrGenerator::startBlock(const std::string &p_label) {
+    if (!m_is_block_terminated) {
+        m_body += "  br label %" + p_label + "\n";
+    }
+    m_body += p_label + ":\n";
+    m_is_block_terminated = false;
+}
+
+void LlvmIrGenerator::emitTerminator(const std::string &p_instruction) {
+    emit("%s", p_instruction.c_str());
+    m_is_block_terminated = true;
+}
+
+void LlvmIrGenerator::beginFunction() {
+    m_allocas.clear();
+    m_body.clear();
+    m_is_block_terminated = false;
+}
+
+void LlvmIrGenerator::endFunction(const std::string &p_header) {
+    if (!m_is_block_terminated) {
+        if (m_return_type->isVoid()) {
+            emitTerminator("ret void");
+        } else {
+            // Falling off the end of a function returns 0.
+            emitTerminator("ret " + getScalarIrType(*m_return_type) + " " +
+                           getZeroValue(*m_return_type));
+        }
+    }
+    dumpInstructions(m_output_file.get(), "\n%s {\nentry:\n%s%s}\n",
+                     p_header.c_str(), m_allocas.c_str(), m_body.c_str());
+}
+
+std::string LlvmIrGenerator::addStringLiteral(const char *p_string) {
+    const std::string name = "@.str." + std::to_string(m_string_num++);
+    std::string bytes;
+    for (const char *c = p_string; *c; ++c) {
+        if (std::isprint(static_cast<unsigned char>(*c)) && *c != '"' &&
+            *c != '\\') {
+            bytes += *c;
+        } else {
+            char escaped[4];
+            snprintf(escaped, sizeof(escaped), "\\%02X",
+                     static_cast<unsigned char>(*c));
+            bytes += escaped;
+        }
+    }
+    m_string_literals += name + " = private unnamed_addr constant [" +
+                         std::to_string(std::strlen(p_string) + 1) +
+                         " x i8] c\"" + bytes + "\\00\"\n";
+    return name;
+}
+
+std::string LlvmIrGenerator::emitAddress(VariableReferenceNode &p_variable_ref) {
+    const SymbolEntry *entry = p_variable_ref.getSymbolEntry();
+    const std::string &base = m_addresses.at(entry);
+    const auto &indices = p_variable_ref.getIndices();
+    if (indices.empty()) {
+        return base;
+    }
+
+    std::string operands;
+    for (const auto &index : indices) {
+        index->accept(*this);
+        operands += ", i32 " + m_value;
+    }
+    const std::string address = newTemp();
+    emit("%s = getelementptr inbounds %s, ptr %s, i32 0%s", address.c_str(),
+         getIrType(*entry->getTypePtr()).c_str(), base.c_str(),
+         operands.c_str());
+    return address;
+}
+
+void LlvmIrGenerator::emitCoercion(const PType &p_from, const PType &p_to) {
+    if (p_from.isInteger() && p_to.isReal()) {
+        const std::string value = newTemp();
+        emit("%s = sitofp i32 %s to float", value.c_str(), m_value.c_str());
+        m_value = value;
+    }
+}
+
+std::string LlvmIrGenerator::emitCondition(ExpressionNode &p_condition) {
+    // Branch on the comparison directly instead of widening it to `i32`.
+    auto *bin_op = dynamic_cast<BinaryOperatorNode *>(&p_condition);
+    if (bin_op && isComparison(bin_op->getOp())) {
+        auto &left = const_cast<ExpressionNode &>(bin_op->getLeftOperand());
+        auto &right = const_cast<ExpressionNode &>(bin_op->getRightOperand());
+        const PType &operand_type = getOperandType(*bin_op);
+        left.accept(*this);
+        emitCoercion(*left.getInferredType(), operand_type);
+        const std::string lhs = m_value;
+        right.accept(*this);
+        emitCoercion(*right.getInferredType(), operand_type);
+        const std::string condition = newTemp();
+        emit("%s = %s %s %s, %s", condition.c_str(),
+             getComparePredicate(bin_op->getOp(), operand_type.isReal()),
+             getScalarIrType(operand_type).c_str(), lhs.c_str(),
+             m_value.c_str());
+        return condition;
+    }
+
+    p_condition.accept(*this);
+    const std::string condition = newTemp();
+    emit("%s = icmp ne i32 %s, 0", condition.c_str(), m_value.c_str());
+    return condition;
+}
+
+void LlvmIrGenerator::visit(ProgramNode &p_program) {
+    // clang-format off
+    constexpr const char *const llvm_ir_file_prologue =
+        "; ModuleID = '%s'\n"
+        "source_filename = \"%s\"\n"
+        "\n"
+        "%s";
+    // clang-format on
+    dumpInstructions(m_output_file.get(), llvm_ir_file_prologue,
+                     m_source_file_path.c_str(), m_source_file_path.c_str(),
+                     kRuntimeDeclarations);
+
+    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    if (!p_program.getDeclNodes().empty()) {
+        dumpInstructions(m_output_file.get(), "\n");
+    }
+    for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
+             visit_ast_node);
+    for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
+             visit_ast_node);
+
+    beginFunction();
+    m_return_type = p_program.getTypePtr();
+    const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+    if (!m_is_block_terminated) {
+        emitTerminator("ret i32 0");
+    }
+    endFunction("define i32 @main()");
+
+    if (!m_string_literals.empty()) {
+        dumpInstructions(m_output_file.get(), "\n%s",
+                         m_string_literals.c_str());
+    }
+    if (m_uses_concat) {
+        dumpInstructions(m_output_file.get(), kConcatDefinition);
+    }
+}
+
+void LlvmIrGenerator::visit(DeclNode &p_decl) { p_decl.visitChildNodes(*this); }
+
+void LlvmIrGenerator::visit(VariableNode &p_variable) {
+    SymbolEntry *entry = p_variable.getSymbolEntry();
+    const PType &type = *p_variable.getTypePtr();
+    const Constant *constant = p_variable.getConstantPtr();
+
+    if (entry->getLevel() == 0) {
+        // Global variable
+        const std::string name = "@" + p_variable.getName();
+        m_addresses[entry] = name;
+        if (!constant) {
+            dumpInstructions(m_output_file.get(), "%s = global %s %s\n",
+                             name.c_str(), getIrType(type).c_str(),
+                             type.isScalar() ? getZeroValue(type).c_str()
+                                             : "zeroinitializer");
+        } else if (type.isPrimitiveString()) {
+            dumpInstructions(m_output_file.get(), "%s = constant ptr %s\n",
+                             name.c_str(),
+                             addStringLiteral(constant->string()).c_str());
+        } else {
+            dumpInstructions(m_output_file.get(), "%s = constant %s %s\n",
+                             name.c_str(), getIrType(type).c_str(),
+                             formatConstant(*constant).c_str());
+        }
+        return;
+    }
+
+    // The suffix tells apart variables of the same name in nested scopes.
+    const std::string address =
+        "%" + p_variable.getName() + "." + std::to_string(m_temp_num++);
+    m_addresses[entry] = address;
+    m_allocas += "  " + address + " = alloca " + getIrType(type) + "\n";
+    if (constant) {
+        const std::string value = type.isPrimitiveString()
+                                      ? addStringLiteral(constant->string())
+                                      : formatConstant(*constant);
+        emit("store %s %s, ptr %s", getScalarIrType(type).c_str(),
+             value.c_str(), address.c_str());
+    }
+}
+
+void LlvmIrGenerator::visit(ConstantValueNode &p_constant_value) {
+    const Constant &constant = *p_constant_value.getConstantPtr();
+    if (constant.getTypePtr()->isPrimitiveString()) {
+        m_value = addStringLiteral(constant.string());
+    } else {
+        m_value = formatConstant(constant);
+    }
+}
+
+void LlvmIrGenerator::visit(FunctionNode &p_function) {
+    std::string parameters;
+    for (const auto &parameter : p_function.getParameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            if (!parameters.empty()) {
+                parameters += ", ";
+            }
+            parameters += getValueIrType(*variable->getTypePtr());
+            if (p_function.getBody()) {
+                parameters += " %" + variable->getName() + ".arg";
+            }
+        }
+    }
+    const std::string signature =
+        getScalarIrType(*p_function.getTypePtr()) + " @" +
+        p_function.getName() + "(" + parameters + ")";
+
+    if (!p_function.getBody()) {
+        dumpInstructions(m_output_file.get(), "\ndeclare %s\n",
+                         signature.c_str());
+        return;
+    }
+
+    beginFunction();
+    m_return_type = p_function.getTypePtr();
+    for (const auto &parameter : p_function.getParameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            variable->accept(*this);
+            const SymbolEntry *entry = variable->getSymbolEntry();
+            const PType &type = *variable->getTypePtr();
+            const std::string argument = "%" + variable->getName() + ".arg";
+            if (type.isScalar()) {
+                emit("store %s %s, ptr %s", getScalarIrType(type).c_str(),
+                     argument.c_str(), m_addresses.at(entry).c_str());
+            } else {
+                // Arrays are passed by reference and copied by the callee.
+                emit("call void @llvm.memcpy.p0.p0.i64(ptr %s, ptr %s, i64 "
+                     "%llu, i1 false)",
+                     m_addresses.at(entry).c_str(), argument.c_str(),
+                     static_cast<unsigned long long>(getStorageSize(type)));
+            }
+        }
+    }
+    p_function.visitBodyChildNodes(*this);
+    endFunction("define " + signature);
+}
+
+void LlvmIrGenerator::visit(CompoundStatementNode &p_compound_statement) {
+    p_compound_statement.visitChildNodes(*this);
+}
+
+void LlvmIrGenerator::visit(PrintNode &p_print) {
+    p_print.visitChildNodes(*this);
+
+    const PType &type = *p_print.getTarget().getInferredType();
+    if (type.isReal()) {
+        emit("call void @printReal(float %s)", m_value.c_str());
+    } else if (type.isString()) {
+        emit("call void @printString(ptr %s)", m_value.c_str());
+    } else {
+        // `boolean`s are printed as 0 or 1.
+        emit("call void @printInt(i32 %s)", m_value.c_str());
+    }
+}
+
+void LlvmIrGenerator::visit(BinaryOperatorNode &p_bin_op) {
+    auto &left = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+    auto &right = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+
+    if (p_bin_op.getInferredType()->isString()) {
+        left.accept(*this);
+        const std::string lhs = m_value;
+        right.accept(*this);
+        const std::string result = newTemp();
+        emit("%s = call ptr @p.concat(ptr %s, ptr %s)", result.c_str(),
+             lhs.c_str(), m_value.c_str());
+        m_value = result;
+        m_uses_concat = true;
+        return;
+    }
+
+    if (isComparison(p_bin_op.getOp())) {
+        const std::string condition = emitCondition(p_bin_op);
+        m_value = newTemp();
+        emit("%s = zext i1 %s to i32", m_value.c_str(), condition.c_str());
+        return;
+    }
+
+    const PType &operand_type = getOperandType(p_bin_op);
+    const bool is_real = operand_type.isReal();
+    left.accept(*this);
+    emitCoercion(*left.getInferredType(), operand_type);
+    const std::string lhs = m_value;
+    right.accept(*this);
+    emitCoercion(*right.getInferredType(), operand_type);
+
+    const char *instruction = nullptr;
+    switch (p_bin_op.getOp()) {
+    case Operator::kPlusOp:
+        instruction = is_real ? "fadd" : "add";
+        break;
+    case Operator::kMinusOp:
+        instruction = is_real ? "fsub" : "sub";
+        break;
+    case Operator::kMultiplyOp:
+        instruction = is_real ? "fmul" : "mul";
+        break;
+    case Operator::kDivideOp:
+        instruction = is_real ? "fdiv" : "sdiv";
+        break;
+    case Operator::kModOp:
+        instruction = "srem";
+        break;
+    case Operator::kAndOp:
+        instruction = "and";
+        break;
+    case Operator::kOrOp:
+        instruction = "or";
+        break;
+    default:
+        assert(false && "Unsupported binary operator");
+    }
+    const std::string result = newTemp();
+    emit("%s = %s %s %s, %s", result.c_str(), instruction,
+         getScalarIrType(operand_type).c_str(), lhs.c_str(), m_value.c_str());
+    m_value = result;
+}
+
+void LlvmIrGenerator::visit(UnaryOperatorNode &p_un_op) {
+    p_un_op.visitChildNodes(*this);
+    const std::string result = newTemp();
+    switch (p_un_op.getOp()) {
+    case Operator::kNegOp:
+        if (p_un_op.getInferredType()->isReal()) {
+            emit("%s = fneg float %s", result.c_str(), m_value.c_str());
+        } else {
+            emit("%s = sub i32 0, %s", result.c_str(), m_value.c_str());
+        }
+        break;
+    case Operator::kNotOp:
+        emit("%s = xor i32 %s, 1", result.c_str(), m_value.c_str());
+        break;
+    default:
+        assert(false && "Unsupported unary operator");
+    }
+    m_value = result;
+}
+
+void LlvmIrGenerator::visit(FunctionInvocationNode &p_func_invocation) {
+    const SymbolEntry *entry = p_func_invocation.getSymbolEntry();
+    std::vector<const PType *> parameter_types;
+    for (const auto &parameter : *entry->getAttribute().parameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            parameter_types.push_back(variable->getTypePtr());
+        }
+    }
+
+    std::string arguments;
+    const auto &argument_nodes = p_func_invocation.getArguments();
+    for (size_t i = 0; i < argument_nodes.size(); ++i) {
+        argument_nodes[i]->accept(*this);
+        emitCoercion(*argument_nodes[i]->getInferredType(),
+                     *parameter_types[i]);
+        if (i != 0) {
+            arguments += ", ";
+        }
+        arguments += getValueIrType(*parameter_types[i]) + " " + m_value;
+    }
+
+    const PType &return_type = *entry->getTypePtr();
+    if (return_type.isVoid()) {
+        emit("call void @%s(%s)", p_func_invocation.getNameCString(),
+             arguments.c_str());
+        m_value.clear();
+        return;
+    }
+    const std::string result = newTemp();
+    emit("%s = call %s @%s(%s)", result.c_str(),
+         getScalarIrType(return_type).c_str(),
+         p_func_invocation.getNameCString(), arguments.c_str());
+    m_value = result;
+}
+
+void LlvmIrGenerator::visit(VariableReferenceNode &p_variable_ref) {
+    const std::string address = emitAddress(p_variable_ref);
+    const PType &type = *p_variable_ref.getInferredType();
+    // An array (e.g., an argument) is designated by its address.
+    if (!type.isScalar()) {
+        m_value = address;
+        return;
+    }
+    m_value = newTemp();
+    emit("%s = load %s, ptr %s", m_value.c_str(), getScalarIrType(type).c_str(),
+         address.c_str());
+}
+
+void LlvmIrGenerator::visit(AssignmentNode &p_assignment) {
+    const std::string address = emitAddress(p_assignment.getLvalue());
+    const PType &type = *p_assignment.getLvalue().getInferredType();
+    p_assignment.getExpr().accept(*this);
+    emitCoercion(*p_assignment.getExpr().getInferredType(), type);
+    emit("store %s %s, ptr %s", getScalarIrType(type).c_str(), m_value.c_str(),
+         address.c_str());
+}
+
+void LlvmIrGenerator::visit(ReadNode &p_read) {
+    auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+    const std::string address = emitAddress(target);
+    const PType &type = *target.getInferredType();
+    const std::string value = newTemp();
+    if (type.isReal()) {
+        emit("%s = call float @readReal()", value.c_str());
+    } else {
+        emit("%s = call i32 @readInt()", value.c_str());
+    }
+    emit("store %s %s, ptr %s", getScalarIrType(type).c_str(), value.c_str(),
+         address.c_str());
+}
+
+void LlvmIrGenerator::visit(IfNode &p_if) {
+    const std::string then_label = newLabel();
+    const std::string else_label = newLabel();
+    const std::string end_label = p_if.m_else_body ? newLabel() : else_label;
+
+    const std::string condition = emitCondition(*p_if.m_condition);
+    emitTerminator("br i1 " + condition + ", label %" + then_label +
+                   ", label %" + else_label);
+    startBlock(then_label);
+    p_if.m_body->accept(*this);
+    if (p_if.m_else_body) {
+        if (!m_is_block_terminated) {
+            emitTerminator("br label %" + end_label);
+        }
+        startBlock(else_label);
+        p_if.m_else_body->accept(*this);
+    }
+    startBlock(end_label);
+}
+
+void LlvmIrGenerator::visit(WhileNode &p_while) {
+    const std::string condition_label = newLabel();
+    const std::string body_label = newLabel();
+    const std::string exit_label = newLabel();
+
+    startBlock(condition_label);
+    const std::string condition = emitCondition(*p_while.m_condition);
+    emitTerminator("br i1 " + condition + ", label %" + body_label +
+                   ", label %" + exit_label);
+    startBlock(body_label);
+    p_while.m_body->accept(*this);
+    if (!m_is_block_terminated) {
+        emitTerminator("br label %" + condition_label);
+    }
+    startBlock(exit_label);
+}
+
+void LlvmIrGenerator::visit(ForNode &p_for) {
+    p_for.m_loop_var_decl->accept(*this);
+    p_for.m_init_stmt->accept(*this);
+
+    const SymbolEntry *entry =
+        p_for.m_loop_var_decl->getVariables()[0]->getSymbolEntry();
+    const std::string &address = m_addresses.at(entry);
+    const std::string condition_label = newLabel();
+    const std::string body_label = newLabel();
+    const std::string exit_label = newLabel();
+
+    startBlock(condition_label);
+    const std::string value = newTemp();
+    emit("%s = load i32, ptr %s", value.c_str(), address.c_str());
+    const std::string condition = newTemp();
+    emit("%s = icmp slt i32 %s, %s", condition.c_str(), value.c_str(),
+         formatConstant(*p_for.getUpperBound().getConstantPtr()).c_str());
+    emitTerminator("br i1 " + condition + ", label %" + body_label +
+                   ", label %" + exit_label);
+    startBlock(body_label);
+    p_for.m_body->accept(*this);
+    const std::string current = newTemp();
+    emit("%s = load i32, ptr %s", current.c_str(), address.c_str());
+    const std::string next = newTemp();
+    emit("%s = add i32 %s, 1", next.c_str(), current.c_str());
+    emit("store i32 %s, ptr %s", next.c_str(), address.c_str());
+    emitTerminator("br label %" + condition_label);
+    startBlock(exit_label);
+}
+
+void LlvmIrGenerator::visit(ReturnNode &p_return) {
+    auto &value = const_cast<ExpressionNode &>(p_return.getReturnValue());
+    value.accept(*this);
+    emitCoercion(*value.getInferredType(), *m_return_type);
+    emitTerminator("ret " + getScalarIrType(*m_return_type) + " " + m_value);
+}
@@ -0,0 +1,132 @@
+#include "codegen/Profile.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <fstream>
+
+uint32_t ProfileLayout::getCounter(const AstNode &p_node) const {
+    auto it = m_first_counters.find(&p_node);
+    return it == m_first_counters.end() ? kNoCounter : it->second;
+}
+
+uint32_t ProfileLayout::getChecksum() const {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const uint32_t p_value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= (p_value >> shift) & 0xff;
+            hash *= 16777619u;
+        }
+    };
+    for (const auto &counter : m_counters) {
+        mix(static_cast<uint32_t>(counter.kind));
+        mix(counter.line);
+        mix(counter.col);
+    }
+    return hash;
+}
+
+void ProfileLayout::addCounters(const AstNode &p_node, const CounterKind p_kind,
+                                const uint32_t p_count) {
+    m_first_counters.emplace(&p_node, getNumCounters());
+    for (uint32_t i = 0; i < p_count; ++i) {
+        m_counters.push_back({static_cast<CounterKind>(
+                                  static_cast<uint8_t>(p_kind) + i),
+                              p_node.getLocation().getLine(),
+                              p_node.getLocation().getCol()});
+    }
+}
+
+void ProfileLayout::visit(ProgramNode &p_program) {
+    addCounters(p_program, CounterKind::kFunctionEntry);
+    p_program.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(FunctionNode &p_function) {
+    addCounters(p_function, CounterKind::kFunctionEntry);
+    p_function.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(CompoundStatementNode &p_compound_statement) {
+    p_compound_statement.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(PrintNode &p_print) { p_print.visitChildNodes(*this); }
+
+void ProfileLayout::visit(BinaryOperatorNode &p_bin_op) {
+    p_bin_op.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(UnaryOperatorNode &p_un_op) {
+    p_un_op.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(FunctionInvocationNode &p_func_invocation) {
+    addCounters(p_func_invocation, CounterKind::kCallEdge);
+    p_func_invocation.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(VariableReferenceNode &p_variable_ref) {
+    p_variable_ref.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(AssignmentNode &p_assignment) {
+    p_assignment.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(ReadNode &p_read) { p_read.visitChildNodes(*this); }
+
+void ProfileLayout::visit(IfNode &p_if) {
+    // The count of the `else` side is the difference of the two.
+    addCounters(p_if, CounterKind::kIfEntry, 2);
+    p_if.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(WhileNode &p_while) {
+    addCounters(p_while, CounterKind::kLoopBody);
+    p_while.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(ForNode &p_for) {
+    addCounters(p_for, CounterKind::kLoopBody);
+    p_for.visitChildNodes(*this);
+}
+
+void ProfileLayout::visit(ReturnNode &p_return) {
+    p_return.visitChildNodes(*this);
+}
+
+bool ProfileData::load(const std::string &p_path,
+                       const ProfileLayout &p_layout, std::string &p_error) {
+    std::ifstream file(p_path);
+    if (!file) {
+        p_error = "cannot open " + p_path;
+        return false;
+    }
+
+    std::string header;
+    std::string key;
+    uint32_t checksum = 0;
+    uint32_t num_counters = 0;
+    if (!std::getline(file, header) || header != "P profile 1" ||
+        !(file >> key) || key != "checksum" || !(file >> std::hex >> checksum) ||
+        !(file >> key) || key != "counters" ||
+        !(file >> std::dec >> num_counters)) {
+        p_error = p_path + ": not a profile";
+        return false;
+    }
+    if (checksum != p_layout.getChecksum() ||
+        num_counters != p_layout.getNumCounters()) {
+        p_error = p_path + ": profile doesn't match the program";
+        return false;
+    }
+
+    std::vector<uint32_t> counts(num_counters);
+    for (auto &count : counts) {
+        if (!(file >> count)) {
+            p_error = p_path + ": truncated profile";
+            return false;
+        }
+    }
+    m_counts = std::move(counts);
+    return true;
+}
@@ -0,0 +1,769 @@
+#include "jit/JitCompiler.hpp"
+
+#include "AST/TypeContext.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <utility>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define JIT_HOST_SUPPORTED 1
+#endif
+
+namespace {
+
+// The runtime of `test/io.c`, called natively by the compiled code.
+void printInt(int value) { printf("%d\n", value); }
+
+int readInt() {
+    int value = 0;
+    if (scanf("%d", &value) != 1) {
+        value = 0;
+    }
+    return value;
+}
+
+void printReal(float value) { printf("%f\n", value); }
+
+float readReal() {
+    float value = 0;
+    if (scanf("%f", &value) != 1) {
+        value = 0;
+    }
+    return value;
+}
+
+void printString(const char *value) { printf("%s\n", value); }
+
+const char *concatStrings(const char *p_lhs, const char *p_rhs,
+                          std::deque<std::string> *p_pool) {
+    p_pool->emplace_back(p_lhs);
+    p_pool->back() += p_rhs;
+    return p_pool->back().c_str();
+}
+
+constexpr int32_t kPointerSize = 8;
+/// @brief Every scalar takes an 8-byte slot so that a `string` fits in.
+constexpr int32_t kSlotSize = 8;
+
+size_t alignTo(const size_t p_value, const size_t p_alignment) {
+    return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+}
+
+/// @return The size of an element of an array of `p_type`.
+int32_t getElementSize(const PType &p_type) {
+    return p_type.isPrimitiveString() ? kPointerSize : 4;
+}
+
+int32_t getStorageSize(const PType &p_type) {
+    if (p_type.getDimensions().empty()) {
+        return kSlotSize;
+    }
+    int32_t size = getElementSize(p_type);
+    for (const auto dim : p_type.getDimensions()) {
+        size *= static_cast<int32_t>(dim);
+    }
+    return size;
+}
+
+uint32_t floatBits(const double p_value) {
+    const float value = static_cast<float>(p_value);
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+bool isComparison(const Operator p_op) {
+    switch (p_op) {
+    case Operator::kLessOp:
+    case Operator::kLessOrEqualOp:
+    case Operator::kGreaterOp:
+    case Operator::kGreaterOrEqualOp:
+    case Operator::kEqualOp:
+    case Operator::kNotEqualOp:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// @return The condition under which the comparison holds.
+Cond getCondition(const Operator p_op, const bool p_is_real) {
+    // `ucomiss` sets the flags as an unsigned comparison does.
+    switch (p_op) {
+    case Operator::kLessOp:
+        return p_is_real ? Cond::kBelow : Cond::kLess;
+    case Operator::kLessOrEqualOp:
+        return p_is_real ? Cond::kBelowOrEqual : Cond::kLessOrEqual;
+    case Operator::kGreaterOp:
+        return p_is_real ? Cond::kAbove : Cond::kGreater;
+    case Operator::kGreaterOrEqualOp:
+        return p_is_real ? Cond::kAboveOrEqual : Cond::kGreaterOrEqual;
+    case Operator::kEqualOp:
+        return Cond::kEqual;
+    case Operator::kNotEqualOp:
+        return Cond::kNotEqual;
+    default:
+        assert(false && "Not a comparison");
+        return Cond::kEqual;
+    }
+}
+
+Cond invert(const Cond p_cond) {
+    // The lowest bit of `tttn` negates the condition.
+    return static_cast<Cond>(static_cast<uint8_t>(p_cond) ^ 1);
+}
+
+/// @return The type both operands are converted to before the operation.
+const PType &getOperandType(const BinaryOperatorNode &p_bin_op) {
+    const auto *left_type = p_bin_op.getLeftOperand().getInferredType();
+    const auto *right_type = p_bin_op.getRightOperand().getInferredType();
+    if (left_type->isReal() || right_type->isReal()) {
+        return *TypeContext::types().getType(
+            PType::PrimitiveTypeEnum::kRealType);
+    }
+    return *left_type;
+}
+
+} // namespace
+
+JitCompiler::JitCompiler(std::unordered_map<SemanticAnalyzer::AstNodeAddr,
+                                            SymbolManager::Table>
+                             &&p_symbol_table_of_scoping_nodes)
+    : m_symbol_table_of_scoping_nodes(
+          std::move(p_symbol_table_of_scoping_nodes)) {}
+
+void JitCompiler::fail(const std::string &p_message) {
+    // Keep the first error; the rest are likely caused by it.
+    if (m_error.empty()) {
+        m_error = p_message;
+    }
+}
+
+X86Emitter::Label JitCompiler::getFunctionLabel(const SymbolEntry *p_entry) {
+    auto it = m_function_labels.find(p_entry);
+    if (it == m_function_labels.end()) {
+        it = m_function_labels.emplace(p_entry, m_emitter.newLabel()).first;
+    }
+    return it->second;
+}
+
+size_t JitCompiler::emitPrologue() {
+    m_emitter.push(Reg::kRbp);
+    m_emitter.movRegReg64(Reg::kRbp, Reg::kRsp);
+    m_frame_size = 0;
+    m_stack_depth = 0;
+    m_return_label = m_emitter.newLabel();
+    return m_emitter.subRsp(0);
+}
+
+void JitCompiler::emitEpilogue(const size_t p_frame_size_position) {
+    m_emitter.bind(m_return_label);
+    m_emitter.leave();
+    m_emitter.ret();
+    // Keep rsp 16-byte aligned after the frame is allocated.
+    m_emitter.patch32(p_frame_size_position,
+                      static_cast<uint32_t>(alignTo(m_frame_size, 16)));
+}
+
+void JitCompiler::pushRax() {
+    m_emitter.push(Reg::kRax);
+    ++m_stack_depth;
+}
+
+void JitCompiler::popReg(const Reg p_reg) {
+    m_emitter.pop(p_reg);
+    --m_stack_depth;
+}
+
+void JitCompiler::callHost(const void *p_function) {
+    // rsp is 16-byte aligned at the start of every statement.
+    const bool needs_padding = m_stack_depth % 2 != 0;
+    if (needs_padding) {
+        m_emitter.subRsp(8);
+    }
+    m_emitter.movRegImm64(Reg::kRax, reinterpret_cast<uintptr_t>(p_function));
+    m_emitter.callReg(Reg::kRax);
+    if (needs_padding) {
+        m_emitter.addRsp(8);
+    }
+}
+
+uint32_t JitCompiler::allocateData(const size_t p_size) {
+    const size_t offset = alignTo(m_data.size(), kPointerSize);
+    m_data.resize(offset + p_size, 0);
+    return static_cast<uint32_t>(offset);
+}
+
+int32_t JitCompiler::allocateLocal(const size_t p_size) {
+    m_frame_size += static_cast<int32_t>(alignTo(p_size, kSlotSize));
+    return -m_frame_size;
+}
+
+void JitCompiler::emitBaseAddress(const Reg p_dst, const SymbolEntry &p_entry) {
+    if (p_entry.getLevel() == 0) {
+        m_emitter.leaData(p_dst, static_cast<uint32_t>(p_entry.getOffset()));
+    } else {
+        m_emitter.lea(p_dst, Reg::kRbp, p_entry.getOffset());
+    }
+}
+
+void JitCompiler::emitAddress(VariableReferenceNode &p_variable_ref,
+                              const SymbolEntry &p_entry) {
+    const auto &indices = p_variable_ref.getIndices();
+    if (indices.empty()) {
+        emitBaseAddress(Reg::kRax, p_entry);
+        return;
+    }
+
+    // Row-major: ((i0 * d1 + i1) * d2 + i2) ...
+    const auto &dims = p_entry.getTypePtr()->getDimensions();
+    indices[0]->accept(*this);
+    for (size_t i = 1; i < indices.size(); ++i) {
+        pushRax();
+        indices[i]->accept(*this);
+        m_emitter.movRegReg32(Reg::kRcx, Reg::kRax);
+        popReg(Reg::kRax);
+        m_emitter.imul32(Reg::kRax, Reg::kRax, static_cast<int32_t>(dims[i]));
+        m_emitter.add32(Reg::kRax, Reg::kRcx);
+    }
+    // A partial reference designates a sub-array.
+    int32_t stride = 1;
+    for (size_t i = indices.size(); i < dims.size(); ++i) {
+        stride *= static_cast<int32_t>(dims[i]);
+    }
+    if (stride != 1) {
+        m_emitter.imul32(Reg::kRax, Reg::kRax, stride);
+    }
+    m_emitter.movsxd(Reg::kRcx, Reg::kRax);
+    emitBaseAddress(Reg::kRax, p_entry);
+    m_emitter.leaIndexed(Reg::kRax, Reg::kRax, Reg::kRcx,
+                         getElementSize(*p_entry.getTypePtr()));
+}
+
+void JitCompiler::emitCoercion(const PType &p_from, const PType &p_to) {
+    if (p_from.isInteger() && p_to.isReal()) {
+        m_emitter.cvtsi2ss(0, Reg::kRax);
+        m_emitter.movdFromXmm(Reg::kRax, 0);
+    }
+}
+
+void JitCompiler::emitConstant(const Constant &p_constant) {
+    const PType &type = *p_constant.getTypePtr();
+    if (type.isPrimitiveInteger()) {
+        m_emitter.movRegImm32(Reg::kRax,
+                              static_cast<uint32_t>(p_constant.integer()));
+    } else if (type.isPrimitiveReal()) {
+        m_emitter.movRegImm32(Reg::kRax, floatBits(p_constant.real()));
+    } else if (type.isPrimitiveBool()) {
+        m_emitter.movRegImm32(Reg::kRax, p_constant.boolean() ? 1 : 0);
+    } else if (type.isPrimitiveString()) {
+        const char *string = p_constant.string();
+        const size_t length = std::strlen(string) + 1;
+        const uint32_t offset = allocateData(length);
+        std::memcpy(m_data.data() + offset, string, length);
+        m_emitter.leaData(Reg::kRax, offset);
+    }
+}
+
+void JitCompiler::emitLoad(const Reg p_dst, const Reg p_base,
+                           const int32_t p_disp, const PType &p_type) {
+    if (p_type.isPrimitiveString()) {
+        m_emitter.load64(p_dst, p_base, p_disp);
+    } else {
+        m_emitter.load32(p_dst, p_base, p_disp);
+    }
+}
+
+void JitCompiler::emitStore(const Reg p_base, const int32_t p_disp,
+                            const Reg p_src, const PType &p_type) {
+    if (p_type.isPrimitiveString()) {
+        m_emitter.store64(p_base, p_disp, p_src);
+    } else {
+        m_emitter.store32(p_base, p_disp, p_src);
+    }
+}
+
+void JitCompiler::emitCondition(ExpressionNode &p_condition,
+                                const X86Emitter::Label p_false_label) {
+    // Fuse integer comparisons with the branch instead of materializing the
+    // boolean first.
+    auto *bin_op = dynamic_cast<BinaryOperatorNode *>(&p_condition);
+    if (bin_op && isComparison(bin_op->getOp()) &&
+        getOperandType(*bin_op).isInteger()) {
+        const_cast<ExpressionNode &>(bin_op->getLeftOperand()).accept(*this);
+        pushRax();
+        const_cast<ExpressionNode &>(bin_op->getRightOperand()).accept(*this);
+        m_emitter.movRegReg32(Reg::kRcx, Reg::kRax);
+        popReg(Reg::kRax);
+        m_emitter.cmp32(Reg::kRax, Reg::kRcx);
+        m_emitter.jcc(invert(getCondition(bin_op->getOp(), false)),
+                      p_false_label);
+        return;
+    }
+
+    p_condition.accept(*this);
+    m_emitter.test32(Reg::kRax, Reg::kRax);
+    m_emitter.jcc(Cond::kEqual, p_false_label);
+}
+
+void JitCompiler::visit(ProgramNode &p_program) {
+    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
+             visit_ast_node);
+    for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
+             visit_ast_node);
+
+    m_main_label = m_emitter.newLabel();
+    m_emitter.bind(m_main_label);
+    const size_t frame_size_position = emitPrologue();
+    m_return_type = p_program.getTypePtr();
+
+    const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+
+    m_emitter.movRegImm32(Reg::kRax, 0);
+    emitEpilogue(frame_size_position);
+
+    if (!m_emitter.resolveLabels()) {
+        fail("invoking a function that is declared but never defined");
+    }
+}
+
+void JitCompiler::visit(DeclNode &p_decl) { p_decl.visitChildNodes(*this); }
+
+void JitCompiler::visit(VariableNode &p_variable) {
+    SymbolEntry *entry = p_variable.getSymbolEntry();
+    const PType &type = *p_variable.getTypePtr();
+    const Constant *constant = p_variable.getConstantPtr();
+
+    if (entry->getLevel() == 0) {
+        const uint32_t offset = allocateData(getStorageSize(type));
+        entry->setOffset(static_cast<int>(offset));
+        if (!constant) {
+            return;
+        }
+        if (type.isPrimitiveString()) {
+            const char *string = constant->string();
+            const size_t length = std::strlen(string) + 1;
+            const uint32_t string_offset = allocateData(length);
+            std::memcpy(m_data.data() + string_offset, string, length);
+            m_data_relocations.emplace_back(offset, string_offset);
+            return;
+        }
+        uint32_t bits = 0;
+        if (type.isPrimitiveInteger()) {
+            bits = static_cast<uint32_t>(constant->integer());
+        } else if (type.isPrimitiveReal()) {
+            bits = floatBits(constant->real());
+        } else if (type.isPrimitiveBool()) {
+            bits = constant->boolean() ? 1 : 0;
+        }
+        std::memcpy(m_data.data() + offset, &bits, sizeof(bits));
+        return;
+    }
+
+    entry->setOffset(allocateLocal(getStorageSize(type)));
+    if (constant) {
+        emitConstant(*constant);
+        emitStore(Reg::kRbp, entry->getOffset(), Reg::kRax, type);
+    }
+}
+
+void JitCompiler::visit(ConstantValueNode &p_constant_value) {
+    emitConstant(*p_constant_value.getConstantPtr());
+}
+
+void JitCompiler::visit(FunctionNode &p_function) {
+    const X86Emitter::Label label =
+        getFunctionLabel(p_function.getSymbolEntry());
+
+    if (p_function.getBody()) {
+        m_emitter.bind(label);
+        const size_t frame_size_position = emitPrologue();
+        m_return_type = p_function.getTypePtr();
+
+        // The arguments are pushed from left to right by the caller, right
+        // above the return address and the saved rbp.
+        size_t num_parameters = 0;
+        for (const auto &parameter : p_function.getParameters()) {
+            num_parameters += parameter->getVariables().size();
+        }
+        size_t index = 0;
+        for (const auto &parameter : p_function.getParameters()) {
+            for (const auto &variable : parameter->getVariables()) {
+                SymbolEntry *entry = variable->getSymbolEntry();
+                const PType &type = *variable->getTypePtr();
+                const int32_t argument_offset = static_cast<int32_t>(
+                    16 + kSlotSize * (num_parameters - 1 - index));
+                entry->setOffset(allocateLocal(getStorageSize(type)));
+
+                // Arrays are passed by reference and copied by the callee.
+                m_emitter.load64(Reg::kRax, Reg::kRbp, argument_offset);
+                if (type.isScalar()) {
+                    m_emitter.store64(Reg::kRbp, entry->getOffset(), Reg::kRax);
+                } else {
+                    m_emitter.lea(Reg::kRdx, Reg::kRbp, entry->getOffset());
+                    m_emitter.copyBytes(Reg::kRdx, Reg::kRax,
+                                        getStorageSize(type));
+                }
+                ++index;
+            }
+        }
+
+        p_function.visitBodyChildNodes(*this);
+        emitEpilogue(frame_size_position);
+    }
+}
+
+void JitCompiler::visit(CompoundStatementNode &p_compound_statement) {
+    p_compound_statement.visitChildNodes(*this);
+}
+
+void JitCompiler::visit(PrintNode &p_print) {
+    p_print.visitChildNodes(*this);
+
+    const PType &type = *p_print.getTarget().getInferredType();
+    if (type.isReal()) {
+        m_emitter.movdToXmm(0, Reg::kRax);
+        callHost(reinterpret_cast<const void *>(&printReal));
+    } else if (type.isString()) {
+        m_emitter.movRegReg64(Reg::kRdi, Reg::kRax);
+        callHost(reinterpret_cast<const void *>(&printString));
+    } else {
+        // `boolean`s are printed as 0 or 1.
+        m_emitter.movRegReg32(Reg::kRdi, Reg::kRax);
+        callHost(reinterpret_cast<const void *>(&printInt));
+    }
+}
+
+void JitCompiler::visit(BinaryOperatorNode &p_bin_op) {
+    auto &left = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+    auto &right = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+
+    if (p_bin_op.getInferredType()->isString()) {
+        left.accept(*this);
+        pushRax();
+        right.accept(*this);
+        m_emitter.movRegReg64(Reg::kRsi, Reg::kRax);
+        popReg(Reg::kRdi);
+        m_emitter.movRegImm64(Reg::kRdx,
+                              reinterpret_cast<uintptr_t>(&m_string_pool));
+        callHost(reinterpret_cast<const void *>(&concatStrings));
+        return;
+    }
+
+    const PType &operand_type = getOperandType(p_bin_op);
+    left.accept(*this);
+    emitCoercion(*left.getInferredType(), operand_type);
+    pushRax();
+    right.accept(*this);
+    emitCoercion(*right.getInferredType(), operand_type);
+    m_emitter.movRegReg32(Reg::kRcx, Reg::kRax);
+    popReg(Reg::kRax);
+
+    const Operator op = p_bin_op.getOp();
+    if (isComparison(op)) {
+        if (operand_type.isReal()) {
+            m_emitter.movdToXmm(0, Reg::kRax);
+            m_emitter.movdToXmm(1, Reg::kRcx);
+            m_emitter.ucomiss(0, 1);
+        } else {
+            m_emitter.cmp32(Reg::kRax, Reg::kRcx);
+        }
+        m_emitter.setcc(getCondition(op, operand_type.isReal()));
+        return;
+    }
+
+    if (operand_type.isReal()) {
+        uint8_t opcode = X86Emitter::kAddss;
+        switch (op) {
+        case Operator::kPlusOp:
+            opcode = X86Emitter::kAddss;
+            break;
+        case Operator::kMinusOp:
+            opcode = X86Emitter::kSubss;
+            break;
+        case Operator::kMultiplyOp:
+            opcode = X86Emitter::kMulss;
+            break;
+        case Operator::kDivideOp:
+            opcode = X86Emitter::kDivss;
+            break;
+        default:
+            assert(false && "Unsupported real operator");
+        }
+        m_emitter.movdToXmm(0, Reg::kRax);
+        m_emitter.movdToXmm(1, Reg::kRcx);
+        m_emitter.scalarSingle(opcode, 0, 1);
+        m_emitter.movdFromXmm(Reg::kRax, 0);
+        return;
+    }
+
+    switch (op) {
+    case Operator::kPlusOp:
+        m_emitter.add32(Reg::kRax, Reg::kRcx);
+        break;
+    case Operator::kMinusOp:
+        m_emitter.sub32(Reg::kRax, Reg::kRcx);
+        break;
+    case Operator::kMultiplyOp:
+        m_emitter.imul32(Reg::kRax, Reg::kRcx);
+        break;
+    case Operator::kDivideOp:
+    case Operator::kModOp: {
+        // Division by zero and overflow follow RISC-V instead of trapping, so
+        // that `--jit` and `--run` agree.
+        const bool is_div = op == Operator::kDivideOp;
+        const X86Emitter::Label by_zero = m_emitter.newLabel();
+        const X86Emitter::Label by_minus_one = m_emitter.newLabel();
+        const X86Emitter::Label done = m_emitter.newLabel();
+        m_emitter.test32(Reg::kRcx, Reg::kRcx);
+        m_emitter.jcc(Cond::kEqual, by_zero);
+        m_emitter.cmp32(Reg::kRcx, -1);
+        m_emitter.jcc(Cond::kEqual, by_minus_one);
+        m_emitter.idiv32(Reg::kRcx);
+        if (!is_div) {
+            m_emitter.movRegReg32(Reg::kRax, Reg::kRdx);
+        }
+        m_emitter.jmp(done);
+        m_emitter.bind(by_minus_one);
+        if (is_div) {
+            m_emitter.neg32(Reg::kRax);
+        } else {
+            m_emitter.movRegImm32(Reg::kRax, 0);
+        }
+        m_emitter.jmp(done);
+        m_emitter.bind(by_zero);
+        if (is_div) {
+            m_emitter.movRegImm32(Reg::kRax, static_cast<uint32_t>(-1));
+        }
+        m_emitter.bind(done);
+        break;
+    }
+    case Operator::kAndOp:
+        m_emitter.and32(Reg::kRax, Reg::kRcx);
+        break;
+    case Operator::kOrOp:
+        m_emitter.or32(Reg::kRax, Reg::kRcx);
+        break;
+    default:
+        assert(false && "Unsupported binary operator");
+    }
+}
+
+void JitCompiler::visit(UnaryOperatorNode &p_un_op) {
+    p_un_op.visitChildNodes(*this);
+    switch (p_un_op.getOp()) {
+    case Operator::kNegOp:
+        if (p_un_op.getInferredType()->isReal()) {
+            m_emitter.xor32(Reg::kRax, INT32_MIN);
+        } else {
+            m_emitter.neg32(Reg::kRax);
+        }
+        break;
+    case Operator::kNotOp:
+        m_emitter.xor32(Reg::kRax, 1);
+        break;
+    default:
+        assert(false && "Unsupported unary operator");
+    }
+}
+
+void JitCompiler::visit(FunctionInvocationNode &p_func_invocation) {
+    const SymbolEntry *entry = p_func_invocation.getSymbolEntry();
+    std::vector<const PType *> parameter_types;
+    for (const auto &parameter : *entry->getAttribute().parameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            parameter_types.push_back(variable->getTypePtr());
+        }
+    }
+
+    const auto &arguments = p_func_invocation.getArguments();
+    const int32_t num_slots = static_cast<int32_t>(arguments.size()) +
+                              (m_stack_depth + arguments.size()) % 2;
+    if (num_slots != static_cast<int32_t>(arguments.size())) {
+        // Pad below the arguments so that rsp is 16-byte aligned at the call.
+        m_emitter.subRsp(8);
+        ++m_stack_depth;
+    }
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        arguments[i]->accept(*this);
+        emitCoercion(*arguments[i]->getInferredType(), *parameter_types[i]);
+        pushRax();
+    }
+    m_emitter.call(getFunctionLabel(entry));
+    m_emitter.addRsp(num_slots * 8);
+    m_stack_depth -= num_slots;
+}
+
+void JitCompiler::visit(VariableReferenceNode &p_variable_ref) {
+    const SymbolEntry *entry = p_variable_ref.getSymbolEntry();
+    const PType &type = *entry->getTypePtr();
+
+    if (type.isScalar() && entry->getLevel() != 0) {
+        emitLoad(Reg::kRax, Reg::kRbp, entry->getOffset(), type);
+        return;
+    }
+
+    emitAddress(p_variable_ref, *entry);
+    // An array (e.g., an argument) is designated by its address.
+    if (p_variable_ref.getInferredType()->isScalar()) {
+        emitLoad(Reg::kRax, Reg::kRax, 0, type);
+    }
+}
+
+void JitCompiler::visit(AssignmentNode &p_assignment) {
+    VariableReferenceNode &lvalue = p_assignment.getLvalue();
+    ExpressionNode &expr = p_assignment.getExpr();
+    const SymbolEntry *entry = lvalue.getSymbolEntry();
+    const PType &type = *lvalue.getInferredType();
+
+    if (lvalue.getIndices().empty() && entry->getLevel() != 0) {
+        expr.accept(*this);
+        emitCoercion(*expr.getInferredType(), type);
+        emitStore(Reg::kRbp, entry->getOffset(), Reg::kRax, type);
+        return;
+    }
+
+    emitAddress(lvalue, *entry);
+    pushRax();
+    expr.accept(*this);
+    emitCoercion(*expr.getInferredType(), type);
+    popReg(Reg::kRcx);
+    emitStore(Reg::kRcx, 0, Reg::kRax, type);
+}
+
+void JitCompiler::visit(ReadNode &p_read) {
+    auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+    const SymbolEntry *entry = target.getSymbolEntry();
+    const PType &type = *target.getInferredType();
+
+    emitAddress(target, *entry);
+    pushRax();
+    if (type.isReal()) {
+        callHost(reinterpret_cast<const void *>(&readReal));
+        m_emitter.movdFromXmm(Reg::kRax, 0);
+    } else {
+        callHost(reinterpret_cast<const void *>(&readInt));
+    }
+    popReg(Reg::kRcx);
+    emitStore(Reg::kRcx, 0, Reg::kRax, type);
+}
+
+void JitCompiler::visit(IfNode &p_if) {
+    const X86Emitter::Label else_label = m_emitter.newLabel();
+    emitCondition(*p_if.m_condition, else_label);
+    p_if.m_body->accept(*this);
+    if (p_if.m_else_body) {
+        const X86Emitter::Label end_label = m_emitter.newLabel();
+        m_emitter.jmp(end_label);
+        m_emitter.bind(else_label);
+        p_if.m_else_body->accept(*this);
+        m_emitter.bind(end_label);
+    } else {
+        m_emitter.bind(else_label);
+    }
+}
+
+void JitCompiler::visit(WhileNode &p_while) {
+    const X86Emitter::Label condition_label = m_emitter.newLabel();
+    const X86Emitter::Label exit_label = m_emitter.newLabel();
+    m_emitter.bind(condition_label);
+    emitCondition(*p_while.m_condition, exit_label);
+    p_while.m_body->accept(*this);
+    m_emitter.jmp(condition_label);
+    m_emitter.bind(exit_label);
+}
+
+void JitCompiler::visit(ForNode &p_for) {
+    p_for.m_loop_var_decl->accept(*this);
+    p_for.m_init_stmt->accept(*this);
+
+    const SymbolEntry *entry =
+        p_for.m_loop_var_decl->getVariables()[0]->getSymbolEntry();
+    const X86Emitter::Label condition_label = m_emitter.newLabel();
+    const X86Emitter::Label exit_label = m_emitter.newLabel();
+    m_emitter.bind(condition_label);
+    m_emitter.load32(Reg::kRax, Reg::kRbp, entry->getOffset());
+    m_emitter.cmp32(Reg::kRax,
+                    static_cast<int32_t>(
+                        p_for.getUpperBound().getConstantPtr()->integer()));
+    m_emitter.jcc(Cond::kGreaterOrEqual, exit_label);
+    p_for.m_body->accept(*this);
+    m_emitter.addMem32(Reg::kRbp, entry->getOffset(), 1);
+    m_emitter.jmp(condition_label);
+    m_emitter.bind(exit_label);
+}
+
+void JitCompiler::visit(ReturnNode &p_return) {
+    auto &value = const_cast<ExpressionNode &>(p_return.getReturnValue());
+    value.accept(*this);
+    emitCoercion(*value.getInferredType(), *m_return_type);
+    m_emitter.jmp(m_return_label);
+}
+
+bool JitCompiler::run() {
+    if (hasError()) {
+        return false;
+    }
+#ifdef JIT_HOST_SUPPORTED
+    const auto &code = m_emitter.getCode();
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t code_size = alignTo(std::max<size_t>(code.size(), 1), page_size);
+    const size_t data_size =
+        alignTo(std::max<size_t>(m_data.size(), 1), page_size);
+
+    void *memory = mmap(nullptr, code_size + data_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        fail("failed to map memory for the compiled code");
+        return false;
+    }
+    auto *text = static_cast<uint8_t *>(memory);
+    uint8_t *data = text + code_size;
+    std::memcpy(text, code.data(), code.size());
+    if (!m_data.empty()) {
+        std::memcpy(data, m_data.data(), m_data.size());
+    }
+
+    for (const auto &fixup : m_emitter.getDataFixups()) {
+        const int64_t displacement =
+            static_cast<int64_t>(code_size + fixup.data_offset) -
+            static_cast<int64_t>(fixup.position + 4);
+        const int32_t disp32 = static_cast<int32_t>(displacement);
+        std::memcpy(text + fixup.position, &disp32, sizeof(disp32));
+    }
+    for (const auto &relocation : m_data_relocations) {
+        const uint64_t address =
+            reinterpret_cast<uintptr_t>(data + relocation.second);
+        std::memcpy(data + relocation.first, &address, sizeof(address));
+    }
+
+    // W^X: the code is never writable while it's executable.
+    if (mprotect(text, code_size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, code_size + data_size);
+        fail("failed to make the compiled code executable");
+        return false;
+    }
+
+    using MainFunction = int (*)();
+    auto main_function = reinterpret_cast<MainFunction>(
+        text + m_emitter.getLabelPosition(m_main_label));
+    main_function();
+    fflush(stdout);
+
+    munmap(memory, code_size + data_size);
+    return true;
+#else
+    fail("the JIT only runs on x86-64 hosts");
+    return false;
+#endif
+}
@@ -0,0 +1,333 @@
+#include "jit/X86Emitter.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+namespace {
+
+uint8_t code(const Reg p_reg) { return static_cast<uint8_t>(p_reg); }
+
+uint8_t scaleBits(const uint8_t p_scale) {
+    switch (p_scale) {
+    case 1:
+        return 0;
+    case 2:
+        return 1;
+    case 4:
+        return 2;
+    case 8:
+        return 3;
+    default:
+        assert(false && "Invalid scale");
+        return 0;
+    }
+}
+
+} // namespace
+
+X86Emitter::Label X86Emitter::newLabel() {
+    m_label_positions.push_back(SIZE_MAX);
+    return m_label_positions.size() - 1;
+}
+
+void X86Emitter::bind(const Label p_label) {
+    assert(m_label_positions[p_label] == SIZE_MAX && "Label bound twice");
+    m_label_positions[p_label] = m_code.size();
+}
+
+bool X86Emitter::resolveLabels() {
+    for (const auto &fixup : m_label_fixups) {
+        const size_t target = m_label_positions[fixup.second];
+        if (target == SIZE_MAX) {
+            return false;
+        }
+        // rel32 is relative to the end of the instruction, which always ends
+        // right after the displacement.
+        patch32(fixup.first,
+                static_cast<uint32_t>(static_cast<int64_t>(target) -
+                                      static_cast<int64_t>(fixup.first + 4)));
+    }
+    m_label_fixups.clear();
+    return true;
+}
+
+void X86Emitter::emit32(const uint32_t p_value) {
+    for (int i = 0; i < 4; ++i) {
+        emit8(static_cast<uint8_t>(p_value >> (8 * i)));
+    }
+}
+
+void X86Emitter::patch32(const size_t p_position, const uint32_t p_value) {
+    for (int i = 0; i < 4; ++i) {
+        m_code[p_position + i] = static_cast<uint8_t>(p_value >> (8 * i));
+    }
+}
+
+void X86Emitter::emitModRm(const uint8_t p_mod, const uint8_t p_reg,
+                           const uint8_t p_rm) {
+    emit8(static_cast<uint8_t>((p_mod << 6) | ((p_reg & 7) << 3) | (p_rm & 7)));
+}
+
+void X86Emitter::emitMemory(const uint8_t p_reg, const Reg p_base,
+                            const int32_t p_disp) {
+    emitModRm(0b10, p_reg, code(p_base));
+    if (p_base == Reg::kRsp) {
+        emit8(0x24);
+    }
+    emit32(static_cast<uint32_t>(p_disp));
+}
+
+void X86Emitter::emitRel32(const Label p_label) {
+    m_label_fixups.emplace_back(m_code.size(), p_label);
+    emit32(0);
+}
+
+void X86Emitter::push(const Reg p_reg) { emit8(0x50 + code(p_reg)); }
+
+void X86Emitter::pop(const Reg p_reg) { emit8(0x58 + code(p_reg)); }
+
+void X86Emitter::leave() { emit8(0xc9); }
+
+void X86Emitter::ret() { emit8(0xc3); }
+
+void X86Emitter::movRegReg32(const Reg p_dst, const Reg p_src) {
+    emit8(0x89);
+    emitModRm(0b11, code(p_src), code(p_dst));
+}
+
+void X86Emitter::movRegReg64(const Reg p_dst, const Reg p_src) {
+    emitRexW();
+    movRegReg32(p_dst, p_src);
+}
+
+void X86Emitter::movRegImm32(const Reg p_dst, const uint32_t p_imm) {
+    emit8(0xb8 + code(p_dst));
+    emit32(p_imm);
+}
+
+void X86Emitter::movRegImm64(const Reg p_dst, const uint64_t p_imm) {
+    emitRexW();
+    emit8(0xb8 + code(p_dst));
+    emit32(static_cast<uint32_t>(p_imm));
+    emit32(static_cast<uint32_t>(p_imm >> 32));
+}
+
+void X86Emitter::load32(const Reg p_dst, const Reg p_base,
+                        const int32_t p_disp) {
+    emit8(0x8b);
+    emitMemory(code(p_dst), p_base, p_disp);
+}
+
+void X86Emitter::load64(const Reg p_dst, const Reg p_base,
+                        const int32_t p_disp) {
+    emitRexW();
+    load32(p_dst, p_base, p_disp);
+}
+
+void X86Emitter::store32(const Reg p_base, const int32_t p_disp,
+                         const Reg p_src) {
+    emit8(0x89);
+    emitMemory(code(p_src), p_base, p_disp);
+}
+
+void X86Emitter::store64(const Reg p_base, const int32_t p_disp,
+                         const Reg p_src) {
+    emitRexW();
+    store32(p_base, p_disp, p_src);
+}
+
+void X86Emitter::lea(const Reg p_dst, const Reg p_base, const int32_t p_disp) {
+    emitRexW();
+    emit8(0x8d);
+    emitMemory(code(p_dst), p_base, p_disp);
+}
+
+void X86Emitter::leaIndexed(const Reg p_dst, const Reg p_base,
+                            const Reg p_index, const uint8_t p_scale) {
+    // mod = 00 with base = rbp means "no base", and rsp can't be an index.
+    assert(p_base != Reg::kRbp && p_index != Reg::kRsp);
+    emitRexW();
+    emit8(0x8d);
+    emitModRm(0b00, code(p_dst), 0b100);
+    emitModRm(scaleBits(p_scale), code(p_index), code(p_base));
+}
+
+void X86Emitter::leaData(const Reg p_dst, const uint32_t p_data_offset) {
+    emitRexW();
+    emit8(0x8d);
+    emitModRm(0b00, code(p_dst), 0b101);
+    m_data_fixups.push_back(DataFixup{m_code.size(), p_data_offset});
+    emit32(0);
+}
+
+void X86Emitter::movsxd(const Reg p_dst, const Reg p_src) {
+    emitRexW();
+    emit8(0x63);
+    emitModRm(0b11, code(p_dst), code(p_src));
+}
+
+void X86Emitter::add32(const Reg p_dst, const Reg p_src) {
+    emit8(0x01);
+    emitModRm(0b11, code(p_src), code(p_dst));
+}
+
+void X86Emitter::sub32(const Reg p_dst, const Reg p_src) {
+    emit8(0x29);
+    emitModRm(0b11, code(p_src), code(p_dst));
+}
+
+void X86Emitter::imul32(const Reg p_dst, const Reg p_src) {
+    emit8(0x0f);
+    emit8(0xaf);
+    emitModRm(0b11, code(p_dst), code(p_src));
+}
+
+void X86Emitter::imul32(const Reg p_dst, const Reg p_src,
+                        const int32_t p_imm) {
+    emit8(0x69);
+    emitModRm(0b11, code(p_dst), code(p_src));
+    emit32(static_cast<uint32_t>(p_imm));
+}
+
+void X86Emitter::and32(const Reg p_dst, const Reg p_src) {
+    emit8(0x21);
+    emitModRm(0b11, code(p_src), code(p_dst));
+}
+
+void X86Emitter::or32(const Reg p_dst, const Reg p_src) {
+    emit8(0x09);
+    emitModRm(0b11, code(p_src), code(p_dst));
+}
+
+void X86Emitter::xor32(const Reg p_dst, const int32_t p_imm) {
+    emit8(0x81);
+    emitModRm(0b11, 6, code(p_dst));
+    emit32(static_cast<uint32_t>(p_imm));
+}
+
+void X86Emitter::cmp32(const Reg p_lhs, const Reg p_rhs) {
+    emit8(0x39);
+    emitModRm(0b11, code(p_rhs), code(p_lhs));
+}
+
+void X86Emitter::cmp32(const Reg p_lhs, const int32_t p_imm) {
+    emit8(0x81);
+    emitModRm(0b11, 7, code(p_lhs));
+    emit32(static_cast<uint32_t>(p_imm));
+}
+
+void X86Emitter::test32(const Reg p_lhs, const Reg p_rhs) {
+    emit8(0x85);
+    emitModRm(0b11, code(p_rhs), code(p_lhs));
+}
+
+void X86Emitter::neg32(const Reg p_reg) {
+    emit8(0xf7);
+    emitModRm(0b11, 3, code(p_reg));
+}
+
+void X86Emitter::addMem32(const Reg p_base, const int32_t p_disp,
+                          const int32_t p_imm) {
+    emit8(0x81);
+    emitMemory(0, p_base, p_disp);
+    emit32(static_cast<uint32_t>(p_imm));
+}
+
+void X86Emitter::addRsp(const int32_t p_imm) {
+    emitRexW();
+    emit8(0x81);
+    emitModRm(0b11, 0, code(Reg::kRsp));
+    emit32(static_cast<uint32_t>(p_imm));
+}
+
+size_t X86Emitter::subRsp(const int32_t p_imm) {
+    emitRexW();
+    emit8(0x81);
+    emitModRm(0b11, 5, code(Reg::kRsp));
+    const size_t position = m_code.size();
+    emit32(static_cast<uint32_t>(p_imm));
+    return position;
+}
+
+void X86Emitter::idiv32(const Reg p_divisor) {
+    emit8(0x99);
+    emit8(0xf7);
+    emitModRm(0b11, 7, code(p_divisor));
+}
+
+void X86Emitter::setcc(const Cond p_cond) {
+    emit8(0x0f);
+    emit8(0x90 + static_cast<uint8_t>(p_cond));
+    emitModRm(0b11, 0, code(Reg::kRax));
+    // movzx eax, al
+    emit8(0x0f);
+    emit8(0xb6);
+    emitModRm(0b11, code(Reg::kRax), code(Reg::kRax));
+}
+
+void X86Emitter::jmp(const Label p_label) {
+    emit8(0xe9);
+    emitRel32(p_label);
+}
+
+void X86Emitter::jcc(const Cond p_cond, const Label p_label) {
+    emit8(0x0f);
+    emit8(0x80 + static_cast<uint8_t>(p_cond));
+    emitRel32(p_label);
+}
+
+void X86Emitter::call(const Label p_label) {
+    emit8(0xe8);
+    emitRel32(p_label);
+}
+
+void X86Emitter::callReg(const Reg p_reg) {
+    emit8(0xff);
+    emitModRm(0b11, 2, code(p_reg));
+}
+
+void X86Emitter::copyBytes(const Reg p_dst, const Reg p_src,
+                           const uint32_t p_size) {
+    assert(p_dst != Reg::kRsi && p_dst != Reg::kRcx && p_src != Reg::kRcx);
+    movRegReg64(Reg::kRsi, p_src);
+    movRegReg64(Reg::kRdi, p_dst);
+    movRegImm32(Reg::kRcx, p_size);
+    // rep movsb
+    emit8(0xf3);
+    emit8(0xa4);
+}
+
+void X86Emitter::movdToXmm(const uint8_t p_xmm, const Reg p_src) {
+    emit8(0x66);
+    emit8(0x0f);
+    emit8(0x6e);
+    emitModRm(0b11, p_xmm, code(p_src));
+}
+
+void X86Emitter::movdFromXmm(const Reg p_dst, const uint8_t p_xmm) {
+    emit8(0x66);
+    emit8(0x0f);
+    emit8(0x7e);
+    emitModRm(0b11, p_xmm, code(p_dst));
+}
+
+void X86Emitter::scalarSingle(const uint8_t p_opcode, const uint8_t p_dst,
+                              const uint8_t p_src) {
+    emit8(0xf3);
+    emit8(0x0f);
+    emit8(p_opcode);
+    emitModRm(0b11, p_dst, p_src);
+}
+
+void X86Emitter::ucomiss(const uint8_t p_lhs, const uint8_t p_rhs) {
+    emit8(0x0f);
+    emit8(0x2e);
+    emitModRm(0b11, p_lhs, p_rhs);
+}
+
+void X86Emitter::cvtsi2ss(const uint8_t p_dst, const Reg p_src) {
+    emit8(0xf3);
+    emit8(0x0f);
+    emit8(0x2a);
+    emitModRm(0b11, p_dst, code(p_src));
+}
@@ -2,29 +2,33 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include "AST/ast.hpp"
-
-extern FILE *yyin;
-extern long line_positions[];
+#include "util/LineIndex.hpp"
+#include "util/SourceFile.hpp"
 
 ErrorPrinter::ErrorPrinter(std::FILE *p_file) : m_file{p_file} {}
 
 void ErrorPrinter::print(const Error &p_error) const {
-  std::fprintf(m_file, "<Error> Found in line %d, column %d: %s\n",
-               p_error.getLocation().line, p_error.getLocation().col,
+  const uint32_t line = p_error.getLocation().getLine();
+  const uint32_t col = p_error.getLocation().getCol();
+  std::fprintf(m_file, "<Error> Found in line %d, column %d: %s\n", line, col,
                p_error.getMessage().c_str());
 
+  // The line is quoted from the mapped source.
   constexpr uint32_t kIndentionWidth = 4;
-  if (std::fseek(yyin, line_positions[p_error.getLocation().line], SEEK_SET) ==
-      0) {
-    char buffer[512];
-    std::fgets(buffer, sizeof(buffer), yyin);
-    std::fprintf(m_file, "%*s%s", kIndentionWidth, "", buffer);
-    std::fprintf(m_file, "%*s\n", kIndentionWidth + p_error.getLocation().col,
-                 "^");
-  } else {
-    std::fprintf(m_file, "Fail to reposition the yyin file stream.\n");
+  const SourceFile &source = SourceFile::current();
+  const char *const line_begin =
+      source.getText() + LineIndex::source().getLineStart(line);
+  const char *const source_end = source.getText() + source.getLength();
+  const auto *line_end = static_cast<const char *>(
+      std::memchr(line_begin, '\n', source_end - line_begin));
+  if (!line_end) {
+    line_end = source_end;
   }
+  std::fprintf(m_file, "%*s%.*s\n", kIndentionWidth, "",
+               static_cast<int>(line_end - line_begin), line_begin);
+  std::fprintf(m_file, "%*s\n", kIndentionWidth + col, "^");
 }
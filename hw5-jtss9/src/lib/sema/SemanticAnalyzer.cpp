@@ -1,4 +1,5 @@
 #include "AST/PType.hpp"
+#include "AST/TypeContext.hpp"
 #include "sema/Error.hpp"
 #include "sema/ErrorPrinter.hpp"
 #include "sema/SemanticAnalyzer.hpp"
@@ -35,14 +36,14 @@ void SemanticAnalyzer::visit(ProgramNode &p_program) {
     m_returned_type_stack.push(p_program.getTypePtr());
 
     auto *entry = m_symbol_manager.addSymbol(
-        p_program.getName(), SymbolEntry::KindEnum::kProgramKind,
+        p_program.getNameId(), SymbolEntry::KindEnum::kProgramKind,
         p_program.getTypePtr(), static_cast<Constant *>(nullptr));
     if (!entry) {
         printError(SymbolRedeclarationError(p_program.getLocation(),
                                             p_program.getNameCString()));
     }
 
-    p_program.visitChildNodes(*this);
+    visitChildren(p_program);
 
     m_returned_type_stack.pop();
     m_context_stack.pop();
@@ -50,7 +51,7 @@ void SemanticAnalyzer::visit(ProgramNode &p_program) {
 }
 
 void SemanticAnalyzer::visit(DeclNode &p_decl) {
-    p_decl.visitChildNodes(*this);
+    visitChildren(p_decl);
 }
 
 SymbolEntry::KindEnum
@@ -72,6 +73,11 @@ SemanticAnalyzer::determineVarKind(const VariableNode &p_variable) const {
 // visible in the current translation unit, which is similar to the static
 // keyword in C.
 namespace {
+/// @return The interned scalar type of `p_type`.
+const PType *getType(const PType::PrimitiveTypeEnum p_type) {
+    return TypeContext::types().getType(p_type);
+}
+
 bool hasNonPositiveDimension(const PType *p_type) {
     return std::any_of(p_type->getDimensions().begin(),
                        p_type->getDimensions().end(),
@@ -79,30 +85,31 @@ bool hasNonPositiveDimension(const PType *p_type) {
 }
 }  // namespace
 
-bool SemanticAnalyzer::isShadowingLoopVar(const std::string &p_name) const {
+bool SemanticAnalyzer::isShadowingLoopVar(const IdentifierId p_name) const {
     auto to_be_shadowed = m_symbol_manager.lookup(p_name);
     return to_be_shadowed &&
            to_be_shadowed->getKind() == SymbolEntry::KindEnum::kLoopVarKind;
 }
 
-bool SemanticAnalyzer::isRedeclaringSymbol(const std::string &p_name) const {
-    return m_symbol_manager.getCurrentTable()->lookup(p_name);
+bool SemanticAnalyzer::isRedeclaringSymbol(const IdentifierId p_name) const {
+    return m_symbol_manager.lookupCurrentScope(p_name);
 }
 
 void SemanticAnalyzer::visit(VariableNode &p_variable) {
     SymbolEntry *entry = nullptr;
-    if (isShadowingLoopVar(p_variable.getName()) ||
-        isRedeclaringSymbol(p_variable.getName())) {
+    if (isShadowingLoopVar(p_variable.getNameId()) ||
+        isRedeclaringSymbol(p_variable.getNameId())) {
         printError(SymbolRedeclarationError(p_variable.getLocation(),
                                             p_variable.getNameCString()));
     } else {
         entry = m_symbol_manager.addSymbol(
-            p_variable.getName(), determineVarKind(p_variable),
+            p_variable.getNameId(), determineVarKind(p_variable),
             p_variable.getTypePtr(), p_variable.getConstantPtr());
         assert(entry);
     }
+    p_variable.setSymbolEntry(entry);
 
-    p_variable.visitChildNodes(*this);
+    visitChildren(p_variable);
 
     // The size of an array should be positive. Notice that size error doesn't
     // stop the array from being added to the symbol table; however, the symbol is
@@ -120,15 +127,16 @@ void SemanticAnalyzer::visit(ConstantValueNode &p_constant_value) {
 }
 
 void SemanticAnalyzer::visit(FunctionNode &p_function) {
-    if (isShadowingLoopVar(p_function.getName()) ||
-        isRedeclaringSymbol(p_function.getName())) {
+    if (isShadowingLoopVar(p_function.getNameId()) ||
+        isRedeclaringSymbol(p_function.getNameId())) {
         printError(SymbolRedeclarationError(p_function.getLocation(),
                                             p_function.getNameCString()));
     } else {
         auto *entry = m_symbol_manager.addSymbol(
-            p_function.getName(), SymbolEntry::KindEnum::kFunctionKind,
+            p_function.getNameId(), SymbolEntry::KindEnum::kFunctionKind,
             p_function.getTypePtr(), &p_function.getParameters());
         assert(entry);
+        p_function.setSymbolEntry(entry);
     }
 
     m_symbol_manager.pushScope();
@@ -136,12 +144,15 @@ void SemanticAnalyzer::visit(FunctionNode &p_function) {
     m_returned_type_stack.push(p_function.getTypePtr());
 
     for (const auto &parameter : p_function.getParameters()) {
-        parameter->accept(*this);
+        dispatch(*parameter);
     }
 
     // directly visit the body to prevent pushing duplicate scope
     m_context_stack.push(SemanticContext::kLocal);
-    p_function.visitBodyChildNodes(*this);
+    if (p_function.getBody()) {
+        visitChildren(
+            const_cast<CompoundStatementNode &>(*p_function.getBody()));
+    }
     m_context_stack.pop();
 
     m_returned_type_stack.pop();
@@ -153,7 +164,7 @@ void SemanticAnalyzer::visit(CompoundStatementNode &p_compound_statement) {
     m_symbol_manager.pushScope();
     m_context_stack.push(SemanticContext::kLocal);
 
-    p_compound_statement.visitChildNodes(*this);
+    visitChildren(p_compound_statement);
 
     m_context_stack.pop();
     m_symbol_table_of_scoping_nodes[&p_compound_statement] =
@@ -162,7 +173,7 @@ void SemanticAnalyzer::visit(CompoundStatementNode &p_compound_statement) {
 
 
 void SemanticAnalyzer::visit(PrintNode &p_print) {
-    p_print.visitChildNodes(*this);
+    visitChildren(p_print);
 
     if (p_print.getTarget().getInferredType()->isError()) {
         return;
@@ -229,7 +240,7 @@ void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
     case Operator::kPlusOp:
         if (left_type->isString() && right_type->isString()) {
             p_bin_op.setInferredType(
-                new PType(PType::PrimitiveTypeEnum::kStringType));
+                getType(PType::PrimitiveTypeEnum::kStringType));
             return;
         }
         [[fallthrough]];
@@ -238,17 +249,17 @@ void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
     case Operator::kDivideOp:
         if (left_type->isReal() || right_type->isReal()) {
             p_bin_op.setInferredType(
-                new PType(PType::PrimitiveTypeEnum::kRealType));
+                getType(PType::PrimitiveTypeEnum::kRealType));
             return;
         }
     case Operator::kModOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kIntegerType));
+            getType(PType::PrimitiveTypeEnum::kIntegerType));
         return;
     case Operator::kAndOp:
     case Operator::kOrOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kBoolType));
+            getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     case Operator::kLessOp:
     case Operator::kLessOrEqualOp:
@@ -257,7 +268,7 @@ void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
     case Operator::kGreaterOrEqualOp:
     case Operator::kNotEqualOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kBoolType));
+            getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     default:
         assert(false && "unknown binary op or unary op");
@@ -266,7 +277,7 @@ void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
 } // namespace
 
 void SemanticAnalyzer::visit(BinaryOperatorNode &p_bin_op) {
-    p_bin_op.visitChildNodes(*this);
+    visitChildren(p_bin_op);
 
     if (p_bin_op.getLeftOperand().getInferredType()->isError() ||
         p_bin_op.getRightOperand().getInferredType()->isError()) {
@@ -274,7 +285,7 @@ void SemanticAnalyzer::visit(BinaryOperatorNode &p_bin_op) {
         // NOTE: Although for operations other than arithmetic operations that has
         // fixed result type, we can set the type to the expected one, this compiler
         // handles errors with propagation.
-        p_bin_op.setInferredType(new PType(PType::PrimitiveTypeEnum::kErrorType));
+        p_bin_op.setInferredType(getType(PType::PrimitiveTypeEnum::kErrorType));
         return;
     }
 
@@ -314,11 +325,11 @@ bool validateUnaryOperand(const UnaryOperatorNode &p_un_op) {
 void setUnaryOpInferredType(UnaryOperatorNode &p_un_op) {
     switch (p_un_op.getOp()) {
     case Operator::kNegOp:
-        p_un_op.setInferredType(new PType(
+        p_un_op.setInferredType(getType(
             p_un_op.getOperand().getInferredType()->getPrimitiveType()));
         return;
     case Operator::kNotOp:
-        p_un_op.setInferredType(new PType(PType::PrimitiveTypeEnum::kBoolType));
+        p_un_op.setInferredType(getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     default:
         assert(false && "unknown binary op or unary op");
@@ -327,13 +338,13 @@ void setUnaryOpInferredType(UnaryOperatorNode &p_un_op) {
 } // namespace
 
 void SemanticAnalyzer::visit(UnaryOperatorNode &p_un_op) {
-    p_un_op.visitChildNodes(*this);
+    visitChildren(p_un_op);
 
     if (p_un_op.getOperand().getInferredType()->isError()) {
         // Propagate the error type.
         // NOTE: Although for the not operator, we can set the type to boolean, this
         // compiler handles errors with propagation.
-        p_un_op.setInferredType(new PType(PType::PrimitiveTypeEnum::kErrorType));
+        p_un_op.setInferredType(getType(PType::PrimitiveTypeEnum::kErrorType));
         return;
     }
 
@@ -377,13 +388,16 @@ bool SemanticAnalyzer::analyzeArgumentTypes(
 }
 
 void SemanticAnalyzer::visit(FunctionInvocationNode &p_func_invocation) {
-    p_func_invocation.visitChildNodes(*this);
+    visitChildren(p_func_invocation);
 
-    const SymbolEntry *entry = m_symbol_manager.lookup(p_func_invocation.getName());
+    SymbolEntry *const entry =
+        m_symbol_manager.lookup(p_func_invocation.getNameId());
+    // Later passes use the binding instead of resolving the name again.
+    p_func_invocation.setSymbolEntry(entry);
     if (entry && m_error_entry_set.find(const_cast<SymbolEntry *>(entry)) !=
         m_error_entry_set.end()) {
         p_func_invocation.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kErrorType));
+            getType(PType::PrimitiveTypeEnum::kErrorType));
         return;
     }
     // 1. The identifier has to be in symbol tables.
@@ -422,22 +436,24 @@ void SemanticAnalyzer::visit(FunctionInvocationNode &p_func_invocation) {
     // appropriate type coercion.
     if (!analyzeArgumentTypes(parameters, arguments)) {
         p_func_invocation.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kErrorType));
+            getType(PType::PrimitiveTypeEnum::kErrorType));
         return;
     }
 
     p_func_invocation.setInferredType(
-        new PType(entry->getTypePtr()->getPrimitiveType()));
+        getType(entry->getTypePtr()->getPrimitiveType()));
 }
 
 void SemanticAnalyzer::visit(VariableReferenceNode &p_variable_ref) {
-    p_variable_ref.visitChildNodes(*this);
+    visitChildren(p_variable_ref);
 
-    const SymbolEntry *entry = m_symbol_manager.lookup(p_variable_ref.getName());
+    SymbolEntry *const entry =
+        m_symbol_manager.lookup(p_variable_ref.getNameId());
+    p_variable_ref.setSymbolEntry(entry);
     if (entry && m_error_entry_set.find(const_cast<SymbolEntry *>(entry)) !=
         m_error_entry_set.end()) {
         p_variable_ref.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kErrorType));
+            getType(PType::PrimitiveTypeEnum::kErrorType));
         return;
     }
 
@@ -467,7 +483,7 @@ void SemanticAnalyzer::visit(VariableReferenceNode &p_variable_ref) {
     for (const auto &index : p_variable_ref.getIndices()) {
         if (index->getInferredType()->isError()) {
             p_variable_ref.setInferredType(
-                new PType(PType::PrimitiveTypeEnum::kErrorType));
+                getType(PType::PrimitiveTypeEnum::kErrorType));
             return;
         }
         if (!index->getInferredType()->isInteger()) {
@@ -491,8 +507,7 @@ void SemanticAnalyzer::visit(VariableReferenceNode &p_variable_ref) {
 }
 
 bool SemanticAnalyzer::analyzeAssignmentLvalue(
-        const AssignmentNode &p_assignment,
-        const SymbolManager &p_symbol_manager) {
+        const AssignmentNode &p_assignment) {
     const auto &lvalue = p_assignment.getLvalue();
     const auto *const lvalue_type = lvalue.getInferredType();
 
@@ -503,7 +518,7 @@ bool SemanticAnalyzer::analyzeAssignmentLvalue(
         return false;
     }
 
-    const auto *const entry = p_symbol_manager.lookup(lvalue.getName());
+    const auto *const entry = lvalue.getSymbolEntry();
     // 2. The variable reference cannot be a reference to a constant variable.
     if (entry->getKind() == SymbolEntry::KindEnum::kConstantKind) {
         printError(AssignToConstantError(lvalue.getLocation(), lvalue.getNameCString()));
@@ -545,7 +560,7 @@ bool SemanticAnalyzer::analyzeAssignmentExpr(
 }
 
 void SemanticAnalyzer::visit(AssignmentNode &p_assignment) {
-    p_assignment.visitChildNodes(*this);
+    visitChildren(p_assignment);
 
     // Skip the rest of semantic checks if there are any errors in the node of the
     // variable reference.
@@ -554,7 +569,7 @@ void SemanticAnalyzer::visit(AssignmentNode &p_assignment) {
     }
     // Skip the rest of semantic checks if there are any errors in the node of the
     // variable reference.
-    if (!analyzeAssignmentLvalue(p_assignment, m_symbol_manager)) {
+    if (!analyzeAssignmentLvalue(p_assignment)) {
         return;
     }
     // Skip the rest of semantic checks if there are any errors in the node of the
@@ -568,7 +583,7 @@ void SemanticAnalyzer::visit(AssignmentNode &p_assignment) {
 }
 
 void SemanticAnalyzer::visit(ReadNode &p_read) {
-    p_read.visitChildNodes(*this);
+    visitChildren(p_read);
 
     if (p_read.getTarget().getInferredType()->isError()) {
         return;
@@ -579,8 +594,7 @@ void SemanticAnalyzer::visit(ReadNode &p_read) {
         return;
     }
 
-    const auto *const entry =
-        m_symbol_manager.lookup(p_read.getTarget().getName());
+    const auto *const entry = p_read.getTarget().getSymbolEntry();
     assert(entry && "Shouldn't reach here. This should be caught during the"
                     "visits of child nodes");
     if (m_error_entry_set.find(const_cast<SymbolEntry *>(entry)) !=
@@ -597,7 +611,7 @@ void SemanticAnalyzer::visit(ReadNode &p_read) {
 }
 
 void SemanticAnalyzer::visit(IfNode &p_if) {
-    p_if.visitChildNodes(*this);
+    visitChildren(p_if);
 
     if (p_if.getCondition().getInferredType()->isError()) {
         return;
@@ -611,7 +625,7 @@ void SemanticAnalyzer::visit(IfNode &p_if) {
 }
 
 void SemanticAnalyzer::visit(WhileNode &p_while) {
-    p_while.visitChildNodes(*this);
+    visitChildren(p_while);
 
     if (p_while.getCondition().getInferredType()->isError()) {
         return;
@@ -628,7 +642,7 @@ void SemanticAnalyzer::visit(ForNode &p_for) {
     m_symbol_manager.pushScope();
     m_context_stack.push(SemanticContext::kForLoop);
 
-    p_for.visitChildNodes(*this);
+    visitChildren(p_for);
     // The initial value of the loop variable and the constant value of the
     // condition must be in the incremental order.
     if (p_for.getLowerBound().getConstantPtr()->integer() >=
@@ -641,7 +655,7 @@ void SemanticAnalyzer::visit(ForNode &p_for) {
 }
 
 void SemanticAnalyzer::visit(ReturnNode &p_return) {
-    p_return.visitChildNodes(*this);
+    visitChildren(p_return);
 
     const auto *const expected_return_type = m_returned_type_stack.top();
     // 1. The current context shouldn't be in the program or a procedure since
@@ -676,5 +690,5 @@ void SemanticAnalyzer::printError(const Error& p_error) {
 void SemanticAnalyzer::printErrorAndSetType(const Error& p_error,
                                             ExpressionNode& p_expr) {
     printError(p_error);
-    p_expr.setInferredType(new PType(PType::PrimitiveTypeEnum::kErrorType));
+    p_expr.setInferredType(getType(PType::PrimitiveTypeEnum::kErrorType));
 }
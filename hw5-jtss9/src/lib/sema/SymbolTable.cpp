@@ -29,7 +29,7 @@ const FunctionNode::DeclNodes *Attribute::parameters() const {
 // ===========================================
 // > SymbolTable
 // ===========================================
-SymbolEntry *SymbolTable::addSymbol(const std::string &p_name,
+SymbolEntry *SymbolTable::addSymbol(const IdentifierId p_name,
                                     const SymbolEntry::KindEnum p_kind,
                                     const size_t p_level,
                                     const PType *const p_p_type,
@@ -40,7 +40,7 @@ SymbolEntry *SymbolTable::addSymbol(const std::string &p_name,
 }
 
 SymbolEntry *
-SymbolTable::addSymbol(const std::string &p_name,
+SymbolTable::addSymbol(const IdentifierId p_name,
                        const SymbolEntry::KindEnum p_kind,
                        const size_t p_level,
                        const PType *const p_p_type,
@@ -50,15 +50,6 @@ SymbolTable::addSymbol(const std::string &p_name,
     return m_entries.back().get();
 }
 
-SymbolEntry *SymbolTable::lookup(const std::string &p_name) const {
-    for (const auto &entry : m_entries) {
-        if (entry->getName() == p_name) {
-            return entry.get();
-        }
-    }
-    return nullptr;
-}
-
 void SymbolTable::dump() const {
     std::printf("=========================================================="
                 "====================================================\n");
@@ -113,6 +104,9 @@ void SymbolManager::pushScope() {
 }
 
 void SymbolManager::pushScope(SymbolManager::Table p_table) {
+    for (const auto &entry : p_table->getEntries()) {
+        bind(*entry);
+    }
     m_tables.push_back(std::move(p_table));
 }
 
@@ -125,39 +119,63 @@ SymbolManager::Table SymbolManager::popScope() {
 
     auto table = std::move(m_tables.back());
     m_tables.pop_back();
+    const auto &entries = table->getEntries();
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        unbind(**it);
+    }
     return table;
 }
 
+void SymbolManager::bind(SymbolEntry &p_entry) {
+    if (p_entry.getNameId() >= m_bindings.size()) {
+        m_bindings.resize(p_entry.getNameId() + 1, nullptr);
+    }
+    auto &binding = m_bindings[p_entry.getNameId()];
+    p_entry.m_shadowed = binding;
+    binding = &p_entry;
+}
+
+void SymbolManager::unbind(SymbolEntry &p_entry) {
+    auto &binding = m_bindings[p_entry.getNameId()];
+    assert(binding == &p_entry &&
+           "Scopes should be popped in the reverse order of pushing");
+    binding = p_entry.m_shadowed;
+    p_entry.m_shadowed = nullptr;
+}
+
 template <typename AttributeType>
-SymbolEntry *SymbolManager::addSymbol(const std::string &p_name,
+SymbolEntry *SymbolManager::addSymbol(const IdentifierId p_name,
                                       const SymbolEntry::KindEnum p_kind,
                                       const PType *const p_p_type,
                                       const AttributeType *const p_attribute) {
-    if (getCurrentTable()->lookup(p_name)) {
+    if (lookupCurrentScope(p_name)) {
         return nullptr;
     }
 
     auto& current_table = m_tables.back();
     auto *entry = current_table->addSymbol(
         p_name, p_kind, getCurrentLevel(), p_p_type, p_attribute);
+    bind(*entry);
     return entry;
 }
 
 // explicit instantiation
 template SymbolEntry *SymbolManager::addSymbol<Constant>(
-    const std::string &, const SymbolEntry::KindEnum, const PType *const,
+    const IdentifierId, const SymbolEntry::KindEnum, const PType *const,
     const Constant *const);
 template SymbolEntry *SymbolManager::addSymbol<FunctionNode::DeclNodes>(
-    const std::string &, const SymbolEntry::KindEnum, const PType *const,
+    const IdentifierId, const SymbolEntry::KindEnum, const PType *const,
     const FunctionNode::DeclNodes *const);
 
-SymbolEntry *SymbolManager::lookup(const std::string &p_name) const {
-    for (auto it = m_tables.rbegin(); it != m_tables.rend(); ++it) {
-        if (auto *entry = (*it)->lookup(p_name)) {
-            return entry;
-        }
-    }
-    return nullptr;
+SymbolEntry *SymbolManager::lookup(const IdentifierId p_name) const {
+    return p_name < m_bindings.size() ? m_bindings[p_name] : nullptr;
+}
+
+SymbolEntry *
+SymbolManager::lookupCurrentScope(const IdentifierId p_name) const {
+    // The entries of the current scope hide all the others.
+    SymbolEntry *entry = lookup(p_name);
+    return entry && entry->getLevel() == getCurrentLevel() ? entry : nullptr;
 }
 
 const SymbolTable *SymbolManager::getCurrentTable() const {
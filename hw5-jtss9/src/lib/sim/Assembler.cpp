@@ -0,0 +1,927 @@
+#include "sim/Assembler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//
+// The assembler works in two passes over the parsed statements:
+// 1. Assign every label a (section, offset) pair. Pseudo instructions are
+//    sized here so that the layout is final after this pass.
+// 2. Lay out the sections (text, rodata, data, bss), resolve the symbols and
+//    emit the instructions and the initialized data.
+//
+
+namespace {
+enum class Section : uint8_t { kText, kRodata, kData, kBss, kNumSections };
+
+uint32_t alignTo(const uint32_t p_value, const uint32_t p_alignment) {
+    return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+}
+
+std::string trim(const std::string &p_str) {
+    auto begin = p_str.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    auto end = p_str.find_last_not_of(" \t\r");
+    return p_str.substr(begin, end - begin + 1);
+}
+
+/// @brief Splits the operands by commas that are not inside a string literal.
+std::vector<std::string> splitOperands(const std::string &p_operands) {
+    std::vector<std::string> operands;
+    std::string current;
+    bool in_string = false;
+    for (size_t i = 0; i < p_operands.size(); ++i) {
+        const char c = p_operands[i];
+        if (c == '"' && (i == 0 || p_operands[i - 1] != '\\')) {
+            in_string = !in_string;
+        }
+        if (c == ',' && !in_string) {
+            operands.emplace_back(trim(current));
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!trim(current).empty()) {
+        operands.emplace_back(trim(current));
+    }
+    return operands;
+}
+
+int parseRegister(const std::string &p_name, const bool p_is_float) {
+    static const std::unordered_map<std::string, int> kIntRegisters = {
+        {"zero", 0}, {"ra", 1},  {"sp", 2},   {"gp", 3},   {"tp", 4},
+        {"t0", 5},   {"t1", 6},  {"t2", 7},   {"s0", 8},   {"fp", 8},
+        {"s1", 9},   {"a0", 10}, {"a1", 11},  {"a2", 12},  {"a3", 13},
+        {"a4", 14},  {"a5", 15}, {"a6", 16},  {"a7", 17},  {"s2", 18},
+        {"s3", 19},  {"s4", 20}, {"s5", 21},  {"s6", 22},  {"s7", 23},
+        {"s8", 24},  {"s9", 25}, {"s10", 26}, {"s11", 27}, {"t3", 28},
+        {"t4", 29},  {"t5", 30}, {"t6", 31}};
+    static const std::unordered_map<std::string, int> kFloatRegisters = {
+        {"ft0", 0},   {"ft1", 1},   {"ft2", 2},  {"ft3", 3},  {"ft4", 4},
+        {"ft5", 5},   {"ft6", 6},   {"ft7", 7},  {"fs0", 8},  {"fs1", 9},
+        {"fa0", 10},  {"fa1", 11},  {"fa2", 12}, {"fa3", 13}, {"fa4", 14},
+        {"fa5", 15},  {"fa6", 16},  {"fa7", 17}, {"fs2", 18}, {"fs3", 19},
+        {"fs4", 20},  {"fs5", 21},  {"fs6", 22}, {"fs7", 23}, {"fs8", 24},
+        {"fs9", 25},  {"fs10", 26}, {"fs11", 27}, {"ft8", 28}, {"ft9", 29},
+        {"ft10", 30}, {"ft11", 31}};
+
+    const auto &table = p_is_float ? kFloatRegisters : kIntRegisters;
+    auto it = table.find(p_name);
+    if (it != table.end()) {
+        return it->second;
+    }
+    // numeric names: x0-x31 / f0-f31
+    const char prefix = p_is_float ? 'f' : 'x';
+    if (p_name.size() >= 2 && p_name[0] == prefix &&
+        std::all_of(p_name.begin() + 1, p_name.end(), ::isdigit)) {
+        const int number = std::atoi(p_name.c_str() + 1);
+        if (number < 32) {
+            return number;
+        }
+    }
+    return -1;
+}
+
+bool parseInteger(const std::string &p_str, int64_t &p_value) {
+    if (p_str.empty()) {
+        return false;
+    }
+    const char *begin = p_str.c_str();
+    char *end = nullptr;
+    p_value = std::strtoll(begin, &end, 0);
+    return end != begin && *end == '\0';
+}
+
+enum class Format : uint8_t {
+    kR,       // rd, rs1, rs2
+    kI,       // rd, rs1, imm
+    kLoad,    // rd, imm(rs1)
+    kStore,   // rs2, imm(rs1)
+    kBranch,  // rs1, rs2, label
+    kU,       // rd, imm
+    kJal,     // [rd,] label
+    kJalr,    // rs | rd, rs, imm | rd, imm(rs)
+    kFR,      // fd, fs1, fs2
+    kFUnary,  // fd, fs1
+    kFLoad,   // fd, imm(rs1)
+    kFStore,  // fs2, imm(rs1)
+    kFToX,    // rd, fs1
+    kXToF,    // fd, rs1
+    kFCmp,    // rd, fs1, fs2
+};
+
+struct OpcodeInfo {
+    Opcode op;
+    Format format;
+};
+
+const std::unordered_map<std::string, OpcodeInfo> &getOpcodeTable() {
+    static const std::unordered_map<std::string, OpcodeInfo> kTable = {
+        {"lui", {Opcode::kLui, Format::kU}},
+        {"auipc", {Opcode::kAuipc, Format::kU}},
+        {"jal", {Opcode::kJal, Format::kJal}},
+        {"jalr", {Opcode::kJalr, Format::kJalr}},
+        {"beq", {Opcode::kBeq, Format::kBranch}},
+        {"bne", {Opcode::kBne, Format::kBranch}},
+        {"blt", {Opcode::kBlt, Format::kBranch}},
+        {"bge", {Opcode::kBge, Format::kBranch}},
+        {"bltu", {Opcode::kBltu, Format::kBranch}},
+        {"bgeu", {Opcode::kBgeu, Format::kBranch}},
+        {"lb", {Opcode::kLb, Format::kLoad}},
+        {"lh", {Opcode::kLh, Format::kLoad}},
+        {"lw", {Opcode::kLw, Format::kLoad}},
+        {"lbu", {Opcode::kLbu, Format::kLoad}},
+        {"lhu", {Opcode::kLhu, Format::kLoad}},
+        {"sb", {Opcode::kSb, Format::kStore}},
+        {"sh", {Opcode::kSh, Format::kStore}},
+        {"sw", {Opcode::kSw, Format::kStore}},
+        {"addi", {Opcode::kAddi, Format::kI}},
+        {"slti", {Opcode::kSlti, Format::kI}},
+        {"sltiu", {Opcode::kSltiu, Format::kI}},
+        {"xori", {Opcode::kXori, Format::kI}},
+        {"ori", {Opcode::kOri, Format::kI}},
+        {"andi", {Opcode::kAndi, Format::kI}},
+        {"slli", {Opcode::kSlli, Format::kI}},
+        {"srli", {Opcode::kSrli, Format::kI}},
+        {"srai", {Opcode::kSrai, Format::kI}},
+        {"add", {Opcode::kAdd, Format::kR}},
+        {"sub", {Opcode::kSub, Format::kR}},
+        {"sll", {Opcode::kSll, Format::kR}},
+        {"slt", {Opcode::kSlt, Format::kR}},
+        {"sltu", {Opcode::kSltu, Format::kR}},
+        {"xor", {Opcode::kXor, Format::kR}},
+        {"srl", {Opcode::kSrl, Format::kR}},
+        {"sra", {Opcode::kSra, Format::kR}},
+        {"or", {Opcode::kOr, Format::kR}},
+        {"and", {Opcode::kAnd, Format::kR}},
+        {"mul", {Opcode::kMul, Format::kR}},
+        {"mulh", {Opcode::kMulh, Format::kR}},
+        {"mulhsu", {Opcode::kMulhsu, Format::kR}},
+        {"mulhu", {Opcode::kMulhu, Format::kR}},
+        {"div", {Opcode::kDiv, Format::kR}},
+        {"divu", {Opcode::kDivu, Format::kR}},
+        {"rem", {Opcode::kRem, Format::kR}},
+        {"remu", {Opcode::kRemu, Format::kR}},
+        {"min", {Opcode::kMin, Format::kR}},
+        {"max", {Opcode::kMax, Format::kR}},
+        {"minu", {Opcode::kMinu, Format::kR}},
+        {"maxu", {Opcode::kMaxu, Format::kR}},
+        {"czero.eqz", {Opcode::kCzeroEqz, Format::kR}},
+        {"czero.nez", {Opcode::kCzeroNez, Format::kR}},
+        {"flw", {Opcode::kFlw, Format::kFLoad}},
+        {"fsw", {Opcode::kFsw, Format::kFStore}},
+        {"fadd.s", {Opcode::kFaddS, Format::kFR}},
+        {"fsub.s", {Opcode::kFsubS, Format::kFR}},
+        {"fmul.s", {Opcode::kFmulS, Format::kFR}},
+        {"fdiv.s", {Opcode::kFdivS, Format::kFR}},
+        {"fsqrt.s", {Opcode::kFsqrtS, Format::kFUnary}},
+        {"fmin.s", {Opcode::kFminS, Format::kFR}},
+        {"fmax.s", {Opcode::kFmaxS, Format::kFR}},
+        {"fsgnj.s", {Opcode::kFsgnjS, Format::kFR}},
+        {"fsgnjn.s", {Opcode::kFsgnjnS, Format::kFR}},
+        {"fsgnjx.s", {Opcode::kFsgnjxS, Format::kFR}},
+        {"fcvt.w.s", {Opcode::kFcvtWS, Format::kFToX}},
+        {"fcvt.wu.s", {Opcode::kFcvtWuS, Format::kFToX}},
+        {"fcvt.s.w", {Opcode::kFcvtSW, Format::kXToF}},
+        {"fcvt.s.wu", {Opcode::kFcvtSWu, Format::kXToF}},
+        {"fmv.x.w", {Opcode::kFmvXW, Format::kFToX}},
+        {"fmv.x.s", {Opcode::kFmvXW, Format::kFToX}},
+        {"fmv.w.x", {Opcode::kFmvWX, Format::kXToF}},
+        {"fmv.s.x", {Opcode::kFmvWX, Format::kXToF}},
+        {"feq.s", {Opcode::kFeqS, Format::kFCmp}},
+        {"flt.s", {Opcode::kFltS, Format::kFCmp}},
+        {"fle.s", {Opcode::kFleS, Format::kFCmp}},
+    };
+    return kTable;
+}
+
+/// @brief R-type operations that GNU as also accepts with an immediate as the
+/// last operand, e.g., `xor t0, t0, 1`.
+Opcode toImmediateForm(const Opcode p_op) {
+    switch (p_op) {
+    case Opcode::kAdd:
+        return Opcode::kAddi;
+    case Opcode::kSlt:
+        return Opcode::kSlti;
+    case Opcode::kSltu:
+        return Opcode::kSltiu;
+    case Opcode::kXor:
+        return Opcode::kXori;
+    case Opcode::kOr:
+        return Opcode::kOri;
+    case Opcode::kAnd:
+        return Opcode::kAndi;
+    case Opcode::kSll:
+        return Opcode::kSlli;
+    case Opcode::kSrl:
+        return Opcode::kSrli;
+    case Opcode::kSra:
+        return Opcode::kSrai;
+    default:
+        return Opcode::kNumOpcodes;
+    }
+}
+
+bool fitsInImm12(const int64_t p_value) {
+    return p_value >= -2048 && p_value <= 2047;
+}
+
+int32_t hiPart(const uint32_t p_value) {
+    return static_cast<int32_t>((p_value + 0x800) >> 12);
+}
+
+int32_t loPart(const uint32_t p_value) {
+    return static_cast<int32_t>(p_value << 20) >> 20;
+}
+
+Section sectionOf(const std::string &p_name) {
+    auto starts_with = [&p_name](const char *p_prefix) {
+        return p_name.compare(0, std::strlen(p_prefix), p_prefix) == 0;
+    };
+    if (starts_with(".text")) {
+        return Section::kText;
+    }
+    if (starts_with(".rodata") || starts_with(".srodata")) {
+        return Section::kRodata;
+    }
+    if (starts_with(".bss") || starts_with(".sbss")) {
+        return Section::kBss;
+    }
+    return Section::kData;
+}
+} // namespace
+
+struct Assembler::Statement {
+    uint32_t line;
+    Section section;
+    uint32_t offset;
+    std::string mnemonic;
+    std::vector<std::string> operands;
+};
+
+bool Assembler::fail(const uint32_t p_line, const std::string &p_message) {
+    m_error = m_file_name + ":" + std::to_string(p_line) + ": error: " +
+              p_message;
+    return false;
+}
+
+bool Assembler::assemble(const std::string &p_source, Program &p_program) {
+    constexpr size_t kNumSections = static_cast<size_t>(Section::kNumSections);
+
+    std::vector<Statement> statements;
+    uint32_t section_sizes[kNumSections] = {0};
+    uint32_t section_alignments[kNumSections] = {4, 4, 4, 4};
+    std::unordered_map<std::string, std::pair<Section, uint32_t>> labels;
+    // .comm symbols are allocated after every other bss object.
+    std::vector<std::pair<std::string, std::pair<uint32_t, uint32_t>>> commons;
+
+    //
+    // Pass 1: parse and size everything.
+    //
+    Section section = Section::kText;
+    uint32_t line_number = 0;
+    size_t line_begin = 0;
+    while (line_begin < p_source.size()) {
+        ++line_number;
+        size_t line_end = p_source.find('\n', line_begin);
+        if (line_end == std::string::npos) {
+            line_end = p_source.size();
+        }
+        std::string line = p_source.substr(line_begin, line_end - line_begin);
+        line_begin = line_end + 1;
+
+        // strip the comment, which is not inside a string literal
+        bool in_string = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '"' && (i == 0 || line[i - 1] != '\\')) {
+                in_string = !in_string;
+            } else if (line[i] == '#' && !in_string) {
+                line.erase(i);
+                break;
+            }
+        }
+        line = trim(line);
+
+        // labels; there may be a statement following on the same line
+        size_t colon;
+        while ((colon = line.find(':')) != std::string::npos &&
+               line.find('"') > colon &&
+               line.find_first_of(" \t") > colon) {
+            const std::string label = line.substr(0, colon);
+            if (labels.count(label)) {
+                return fail(line_number, "symbol `" + label +
+                                             "' is already defined");
+            }
+            labels[label] = {section, section_sizes[static_cast<size_t>(section)]};
+            line = trim(line.substr(colon + 1));
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        Statement statement;
+        statement.line = line_number;
+        const size_t space = line.find_first_of(" \t");
+        statement.mnemonic = line.substr(0, space);
+        if (space != std::string::npos) {
+            statement.operands = splitOperands(line.substr(space + 1));
+        }
+        const std::string &mnemonic = statement.mnemonic;
+        const auto &operands = statement.operands;
+        auto &size = section_sizes[static_cast<size_t>(section)];
+
+        if (mnemonic == ".section") {
+            if (operands.empty()) {
+                return fail(line_number, "missing section name");
+            }
+            section = sectionOf(operands[0]);
+            continue;
+        }
+        if (mnemonic == ".text" || mnemonic == ".data" ||
+            mnemonic == ".rodata" || mnemonic == ".bss") {
+            section = sectionOf(mnemonic);
+            continue;
+        }
+        if (mnemonic == ".file" || mnemonic == ".option" ||
+            mnemonic == ".globl" || mnemonic == ".global" ||
+            mnemonic == ".type" || mnemonic == ".size" ||
+            mnemonic == ".ident" || mnemonic == ".local") {
+            continue;
+        }
+        if (mnemonic == ".comm") {
+            int64_t comm_size = 0, comm_align = 4;
+            if (operands.size() < 2 || !parseInteger(operands[1], comm_size) ||
+                (operands.size() > 2 && !parseInteger(operands[2], comm_align))) {
+                return fail(line_number, "invalid .comm directive");
+            }
+            commons.push_back({operands[0],
+                               {static_cast<uint32_t>(comm_size),
+                                static_cast<uint32_t>(comm_align)}});
+            continue;
+        }
+
+        statement.section = section;
+        if (mnemonic == ".align" || mnemonic == ".p2align" ||
+            mnemonic == ".balign") {
+            int64_t value = 0;
+            if (operands.empty() || !parseInteger(operands[0], value)) {
+                return fail(line_number, "invalid alignment");
+            }
+            const uint32_t alignment =
+                (mnemonic == ".balign") ? static_cast<uint32_t>(value)
+                                        : (1u << value);
+            auto &section_alignment =
+                section_alignments[static_cast<size_t>(section)];
+            section_alignment = std::max(section_alignment, alignment);
+            // keep the requested alignment as the only operand
+            statement.operands = {std::to_string(alignment)};
+            statement.offset = size;
+            size = alignTo(size, alignment);
+        } else if (mnemonic == ".word" || mnemonic == ".float") {
+            statement.offset = size;
+            size += 4 * operands.size();
+        } else if (mnemonic == ".half") {
+            statement.offset = size;
+            size += 2 * operands.size();
+        } else if (mnemonic == ".byte") {
+            statement.offset = size;
+            size += operands.size();
+        } else if (mnemonic == ".zero" || mnemonic == ".space") {
+            int64_t value = 0;
+            if (operands.empty() || !parseInteger(operands[0], value)) {
+                return fail(line_number, "invalid " + mnemonic + " directive");
+            }
+            statement.offset = size;
+            size += value;
+        } else if (mnemonic == ".string" || mnemonic == ".asciz" ||
+                   mnemonic == ".ascii") {
+            if (operands.size() != 1 || operands[0].size() < 2 ||
+                operands[0].front() != '"' || operands[0].back() != '"') {
+                return fail(line_number, "expected a string literal");
+            }
+            // decode the escape sequences right away
+            std::string decoded;
+            const std::string &literal = operands[0];
+            for (size_t i = 1; i + 1 < literal.size(); ++i) {
+                if (literal[i] != '\\') {
+                    decoded += literal[i];
+                    continue;
+                }
+                switch (literal[++i]) {
+                case 'n':
+                    decoded += '\n';
+                    break;
+                case 't':
+                    decoded += '\t';
+                    break;
+                case '0':
+                    decoded += '\0';
+                    break;
+                default:
+                    decoded += literal[i];
+                    break;
+                }
+            }
+            if (mnemonic != ".ascii") {
+                decoded += '\0';
+            }
+            statement.operands = {decoded};
+            statement.offset = size;
+            size += decoded.size();
+        } else if (mnemonic[0] == '.') {
+            return fail(line_number, "unknown directive `" + mnemonic + "'");
+        } else {
+            if (section != Section::kText) {
+                return fail(line_number, "instruction outside of .text");
+            }
+            statement.offset = size;
+            int64_t value = 0;
+            if (mnemonic == "la" ||
+                (mnemonic == "li" && operands.size() == 2 &&
+                 !(parseInteger(operands[1], value) && fitsInImm12(value)))) {
+                size += 8;
+            } else {
+                size += 4;
+            }
+        }
+        statements.emplace_back(std::move(statement));
+    }
+
+    //
+    // Lay out the sections and resolve the labels.
+    //
+    uint32_t section_bases[kNumSections];
+    section_bases[static_cast<size_t>(Section::kText)] = Program::kTextBase;
+    uint32_t cursor =
+        Program::kTextBase + section_sizes[static_cast<size_t>(Section::kText)];
+    cursor = alignTo(cursor, 4096);
+    p_program.data_base = cursor;
+    for (auto s : {Section::kRodata, Section::kData, Section::kBss}) {
+        cursor = alignTo(cursor, section_alignments[static_cast<size_t>(s)]);
+        section_bases[static_cast<size_t>(s)] = cursor;
+        cursor += section_sizes[static_cast<size_t>(s)];
+    }
+    for (const auto &common : commons) {
+        cursor = alignTo(cursor, std::max(common.second.second, 1u));
+        if (!labels.count(common.first)) {
+            p_program.symbols[common.first] = cursor;
+        }
+        cursor += common.second.first;
+    }
+    p_program.data.assign(cursor - p_program.data_base, 0);
+    for (const auto &label : labels) {
+        p_program.symbols[label.first] =
+            section_bases[static_cast<size_t>(label.second.first)] +
+            label.second.second;
+    }
+
+    //
+    // Pass 2: emit.
+    //
+    auto host_call_address = [&p_program](const std::string &p_name) {
+        auto it = std::find(p_program.host_calls.begin(),
+                            p_program.host_calls.end(), p_name);
+        const auto index = it - p_program.host_calls.begin();
+        if (it == p_program.host_calls.end()) {
+            p_program.host_calls.push_back(p_name);
+        }
+        const uint32_t address = Program::kHostCallBase + 4 * index;
+        p_program.symbols[p_name] = address;
+        return address;
+    };
+
+    for (const auto &statement : statements) {
+        const uint32_t line = statement.line;
+        const std::string &mnemonic = statement.mnemonic;
+        const auto &operands = statement.operands;
+        const uint32_t address =
+            section_bases[static_cast<size_t>(statement.section)] +
+            statement.offset;
+
+        // Evaluates `symbol`, `symbol+offset` or a number.
+        std::string error_message;
+        auto evaluate_symbol = [&](const std::string &p_expr, int64_t &p_value,
+                                   const bool p_allow_host_call) {
+            std::string expr = trim(p_expr);
+            if (parseInteger(expr, p_value)) {
+                return true;
+            }
+            int64_t offset = 0;
+            const size_t sign = expr.find_first_of("+-", 1);
+            if (sign != std::string::npos) {
+                if (!parseInteger(trim(expr.substr(sign)), offset)) {
+                    error_message = "invalid expression `" + expr + "'";
+                    return false;
+                }
+                expr = trim(expr.substr(0, sign));
+            }
+            auto it = p_program.symbols.find(expr);
+            if (it != p_program.symbols.end()) {
+                p_value = static_cast<int64_t>(it->second) + offset;
+                return true;
+            }
+            if (p_allow_host_call) {
+                p_value = host_call_address(expr);
+                return true;
+            }
+            error_message = "undefined symbol `" + expr + "'";
+            return false;
+        };
+        // Additionally accepts `%hi(x)` and `%lo(x)`.
+        auto evaluate = [&](const std::string &p_expr, int64_t &p_value,
+                            const bool p_allow_host_call = false) {
+            const std::string expr = trim(p_expr);
+            if (expr.compare(0, 4, "%hi(") == 0 ||
+                expr.compare(0, 4, "%lo(") == 0) {
+                int64_t inner = 0;
+                if (expr.back() != ')' ||
+                    !evaluate_symbol(expr.substr(4, expr.size() - 5), inner,
+                                     false)) {
+                    return false;
+                }
+                const auto value = static_cast<uint32_t>(inner);
+                p_value = (expr[1] == 'h') ? hiPart(value) : loPart(value);
+                return true;
+            }
+            return evaluate_symbol(expr, p_value, p_allow_host_call);
+        };
+        auto evaluate_or_fail = [&](const std::string &p_expr, int64_t &p_value,
+                                    const bool p_allow_host_call = false) {
+            if (!evaluate(p_expr, p_value, p_allow_host_call)) {
+                return fail(line, error_message.empty()
+                                      ? "invalid expression `" + p_expr + "'"
+                                      : error_message);
+            }
+            return true;
+        };
+
+        if (mnemonic[0] == '.') {
+            if (statement.section == Section::kText) {
+                // pad with nops so that the padding is executable
+                const uint32_t alignment = std::stoul(operands[0]);
+                for (uint32_t pc = address; pc % alignment;
+                     pc += 4) {
+                    p_program.text.push_back(
+                        Instruction{Opcode::kAddi, 0, 0, 0, 0, line});
+                }
+                continue;
+            }
+            if (statement.section == Section::kBss) {
+                if (mnemonic != ".align" && mnemonic != ".p2align" &&
+                    mnemonic != ".balign" && mnemonic != ".zero" &&
+                    mnemonic != ".space") {
+                    return fail(line, "initialized data in .bss");
+                }
+                continue;
+            }
+            uint8_t *out = &p_program.data[address - p_program.data_base];
+            if (mnemonic == ".word" || mnemonic == ".half" ||
+                mnemonic == ".byte") {
+                const size_t width =
+                    (mnemonic == ".word") ? 4 : (mnemonic == ".half") ? 2 : 1;
+                for (const auto &operand : operands) {
+                    int64_t value = 0;
+                    if (!evaluate_or_fail(operand, value)) {
+                        return false;
+                    }
+                    const auto word = static_cast<uint32_t>(value);
+                    std::memcpy(out, &word, width);
+                    out += width;
+                }
+            } else if (mnemonic == ".float") {
+                for (const auto &operand : operands) {
+                    const float value = std::strtof(operand.c_str(), nullptr);
+                    std::memcpy(out, &value, 4);
+                    out += 4;
+                }
+            } else if (mnemonic == ".string" || mnemonic == ".asciz" ||
+                       mnemonic == ".ascii") {
+                std::memcpy(out, operands[0].data(), operands[0].size());
+            }
+            continue;
+        }
+
+        auto emit = [&](const Opcode p_op, const int p_rd, const int p_rs1,
+                        const int p_rs2, const int64_t p_imm) {
+            p_program.text.push_back(Instruction{
+                p_op, static_cast<uint8_t>(p_rd), static_cast<uint8_t>(p_rs1),
+                static_cast<uint8_t>(p_rs2), static_cast<int32_t>(p_imm), line});
+        };
+        auto expect_operands = [&](const size_t p_count) {
+            if (operands.size() != p_count) {
+                return fail(line, "`" + mnemonic + "' expects " +
+                                      std::to_string(p_count) + " operands");
+            }
+            return true;
+        };
+        auto reg = [&](const std::string &p_name, int &p_reg,
+                       const bool p_is_float = false) {
+            p_reg = parseRegister(p_name, p_is_float);
+            if (p_reg < 0) {
+                return fail(line, "invalid register `" + p_name + "'");
+            }
+            return true;
+        };
+        // `imm(reg)`
+        auto memory = [&](const std::string &p_operand, int &p_base,
+                          int64_t &p_offset) {
+            const size_t open = p_operand.rfind('(');
+            if (open == std::string::npos || p_operand.back() != ')') {
+                return fail(line, "invalid memory operand `" + p_operand + "'");
+            }
+            const std::string offset = trim(p_operand.substr(0, open));
+            if (offset.empty()) {
+                p_offset = 0;
+            } else if (!evaluate_or_fail(offset, p_offset)) {
+                return false;
+            }
+            return reg(trim(p_operand.substr(open + 1,
+                                             p_operand.size() - open - 2)),
+                       p_base);
+        };
+        auto branch_target = [&](const std::string &p_label, int64_t &p_offset) {
+            if (!evaluate_or_fail(p_label, p_offset, true)) {
+                return false;
+            }
+            p_offset -= address;
+            return true;
+        };
+
+        int rd = 0, rs1 = 0, rs2 = 0;
+        int64_t imm = 0;
+
+        //
+        // Pseudo instructions
+        //
+        if (mnemonic == "nop") {
+            emit(Opcode::kAddi, 0, 0, 0, 0);
+        } else if (mnemonic == "li") {
+            if (!expect_operands(2) || !reg(operands[0], rd) ||
+                !evaluate_or_fail(operands[1], imm)) {
+                return false;
+            }
+            int64_t literal = 0;
+            if (parseInteger(operands[1], literal) && fitsInImm12(literal)) {
+                emit(Opcode::kAddi, rd, 0, 0, imm);
+            } else {
+                const auto value = static_cast<uint32_t>(imm);
+                emit(Opcode::kLui, rd, 0, 0, hiPart(value));
+                emit(Opcode::kAddi, rd, rd, 0, loPart(value));
+            }
+        } else if (mnemonic == "la") {
+            if (!expect_operands(2) || !reg(operands[0], rd) ||
+                !evaluate_or_fail(operands[1], imm)) {
+                return false;
+            }
+            const auto relative = static_cast<uint32_t>(imm - address);
+            emit(Opcode::kAuipc, rd, 0, 0, hiPart(relative));
+            emit(Opcode::kAddi, rd, rd, 0, loPart(relative));
+        } else if (mnemonic == "mv" || mnemonic == "not" ||
+                   mnemonic == "neg" || mnemonic == "seqz" ||
+                   mnemonic == "snez" || mnemonic == "sltz" ||
+                   mnemonic == "sgtz") {
+            if (!expect_operands(2) || !reg(operands[0], rd) ||
+                !reg(operands[1], rs1)) {
+                return false;
+            }
+            if (mnemonic == "mv") {
+                emit(Opcode::kAddi, rd, rs1, 0, 0);
+            } else if (mnemonic == "not") {
+                emit(Opcode::kXori, rd, rs1, 0, -1);
+            } else if (mnemonic == "neg") {
+                emit(Opcode::kSub, rd, 0, rs1, 0);
+            } else if (mnemonic == "seqz") {
+                emit(Opcode::kSltiu, rd, rs1, 0, 1);
+            } else if (mnemonic == "snez") {
+                emit(Opcode::kSltu, rd, 0, rs1, 0);
+            } else if (mnemonic == "sltz") {
+                emit(Opcode::kSlt, rd, rs1, 0, 0);
+            } else {
+                emit(Opcode::kSlt, rd, 0, rs1, 0);
+            }
+        } else if (mnemonic == "j" || mnemonic == "tail") {
+            if (!expect_operands(1) || !branch_target(operands[0], imm)) {
+                return false;
+            }
+            emit(Opcode::kJal, 0, 0, 0, imm);
+        } else if (mnemonic == "call") {
+            if (!expect_operands(1) || !branch_target(operands[0], imm)) {
+                return false;
+            }
+            emit(Opcode::kJal, 1, 0, 0, imm);
+        } else if (mnemonic == "jr") {
+            if (!expect_operands(1) || !reg(operands[0], rs1)) {
+                return false;
+            }
+            emit(Opcode::kJalr, 0, rs1, 0, 0);
+        } else if (mnemonic == "ret") {
+            emit(Opcode::kJalr, 0, 1, 0, 0);
+        } else if (mnemonic == "beqz" || mnemonic == "bnez" ||
+                   mnemonic == "blez" || mnemonic == "bgez" ||
+                   mnemonic == "bltz" || mnemonic == "bgtz") {
+            if (!expect_operands(2) || !reg(operands[0], rs1) ||
+                !branch_target(operands[1], imm)) {
+                return false;
+            }
+            if (mnemonic == "beqz") {
+                emit(Opcode::kBeq, 0, rs1, 0, imm);
+            } else if (mnemonic == "bnez") {
+                emit(Opcode::kBne, 0, rs1, 0, imm);
+            } else if (mnemonic == "blez") {
+                emit(Opcode::kBge, 0, 0, rs1, imm);
+            } else if (mnemonic == "bgez") {
+                emit(Opcode::kBge, 0, rs1, 0, imm);
+            } else if (mnemonic == "bltz") {
+                emit(Opcode::kBlt, 0, rs1, 0, imm);
+            } else {
+                emit(Opcode::kBlt, 0, 0, rs1, imm);
+            }
+        } else if (mnemonic == "bgt" || mnemonic == "ble" ||
+                   mnemonic == "bgtu" || mnemonic == "bleu") {
+            if (!expect_operands(3) || !reg(operands[0], rs1) ||
+                !reg(operands[1], rs2) || !branch_target(operands[2], imm)) {
+                return false;
+            }
+            const Opcode op = (mnemonic == "bgt")    ? Opcode::kBlt
+                              : (mnemonic == "ble")  ? Opcode::kBge
+                              : (mnemonic == "bgtu") ? Opcode::kBltu
+                                                     : Opcode::kBgeu;
+            // swap the operands
+            emit(op, 0, rs2, rs1, imm);
+        } else if (mnemonic == "fmv.s" || mnemonic == "fneg.s" ||
+                   mnemonic == "fabs.s") {
+            if (!expect_operands(2) || !reg(operands[0], rd, true) ||
+                !reg(operands[1], rs1, true)) {
+                return false;
+            }
+            const Opcode op = (mnemonic == "fmv.s")    ? Opcode::kFsgnjS
+                              : (mnemonic == "fneg.s") ? Opcode::kFsgnjnS
+                                                       : Opcode::kFsgnjxS;
+            emit(op, rd, rs1, rs1, 0);
+        } else {
+            //
+            // Real instructions
+            //
+            auto it = getOpcodeTable().find(mnemonic);
+            if (it == getOpcodeTable().end()) {
+                return fail(line, "unknown instruction `" + mnemonic + "'");
+            }
+            Opcode op = it->second.op;
+            // The optional rounding mode operand of the F extension is only
+            // honored for the conversions to integers, where `rtz` (recorded
+            // as a non-zero immediate) selects truncation instead of the
+            // default round-to-nearest-even.
+            std::vector<std::string> ops = operands;
+            int64_t rounding_mode = 0;
+            if ((it->second.format == Format::kFR ||
+                 it->second.format == Format::kFUnary ||
+                 it->second.format == Format::kFToX ||
+                 it->second.format == Format::kXToF) &&
+                !ops.empty() && parseRegister(ops.back(), true) < 0 &&
+                parseRegister(ops.back(), false) < 0) {
+                rounding_mode = (ops.back() == "rtz") ? 1 : 0;
+                ops.pop_back();
+            }
+            auto expect = [&](const size_t p_count) {
+                if (ops.size() != p_count) {
+                    return fail(line, "`" + mnemonic + "' expects " +
+                                          std::to_string(p_count) +
+                                          " operands");
+                }
+                return true;
+            };
+
+            switch (it->second.format) {
+            case Format::kR:
+                if (!expect(3) || !reg(ops[0], rd) || !reg(ops[1], rs1)) {
+                    return false;
+                }
+                if (parseRegister(ops[2], false) < 0 &&
+                    toImmediateForm(op) != Opcode::kNumOpcodes) {
+                    if (!evaluate_or_fail(ops[2], imm)) {
+                        return false;
+                    }
+                    emit(toImmediateForm(op), rd, rs1, 0, imm);
+                } else {
+                    if (!reg(ops[2], rs2)) {
+                        return false;
+                    }
+                    emit(op, rd, rs1, rs2, 0);
+                }
+                break;
+            case Format::kI:
+                if (!expect(3) || !reg(ops[0], rd) || !reg(ops[1], rs1) ||
+                    !evaluate_or_fail(ops[2], imm)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, imm);
+                break;
+            case Format::kLoad:
+            case Format::kFLoad:
+                if (!expect(2) ||
+                    !reg(ops[0], rd, it->second.format == Format::kFLoad) ||
+                    !memory(ops[1], rs1, imm)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, imm);
+                break;
+            case Format::kStore:
+            case Format::kFStore:
+                if (!expect(2) ||
+                    !reg(ops[0], rs2, it->second.format == Format::kFStore) ||
+                    !memory(ops[1], rs1, imm)) {
+                    return false;
+                }
+                emit(op, 0, rs1, rs2, imm);
+                break;
+            case Format::kBranch:
+                if (!expect(3) || !reg(ops[0], rs1) || !reg(ops[1], rs2) ||
+                    !branch_target(ops[2], imm)) {
+                    return false;
+                }
+                emit(op, 0, rs1, rs2, imm);
+                break;
+            case Format::kU:
+                if (!expect(2) || !reg(ops[0], rd) ||
+                    !evaluate_or_fail(ops[1], imm)) {
+                    return false;
+                }
+                emit(op, rd, 0, 0, imm);
+                break;
+            case Format::kJal:
+                if (ops.size() == 1) {
+                    rd = 1;
+                    if (!branch_target(ops[0], imm)) {
+                        return false;
+                    }
+                } else if (!expect(2) || !reg(ops[0], rd) ||
+                           !branch_target(ops[1], imm)) {
+                    return false;
+                }
+                emit(op, rd, 0, 0, imm);
+                break;
+            case Format::kJalr:
+                if (ops.size() == 1) {
+                    rd = 1;
+                    if (!reg(ops[0], rs1)) {
+                        return false;
+                    }
+                } else if (ops.size() == 2) {
+                    if (!reg(ops[0], rd) || !memory(ops[1], rs1, imm)) {
+                        return false;
+                    }
+                } else if (!expect(3) || !reg(ops[0], rd) ||
+                           !reg(ops[1], rs1) ||
+                           !evaluate_or_fail(ops[2], imm)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, imm);
+                break;
+            case Format::kFR:
+            case Format::kFCmp:
+                if (!expect(3) ||
+                    !reg(ops[0], rd, it->second.format == Format::kFR) ||
+                    !reg(ops[1], rs1, true) || !reg(ops[2], rs2, true)) {
+                    return false;
+                }
+                emit(op, rd, rs1, rs2, 0);
+                break;
+            case Format::kFUnary:
+                if (!expect(2) || !reg(ops[0], rd, true) ||
+                    !reg(ops[1], rs1, true)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, 0);
+                break;
+            case Format::kFToX:
+                if (!expect(2) || !reg(ops[0], rd) || !reg(ops[1], rs1, true)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, rounding_mode);
+                break;
+            case Format::kXToF:
+                if (!expect(2) || !reg(ops[0], rd, true) || !reg(ops[1], rs1)) {
+                    return false;
+                }
+                emit(op, rd, rs1, 0, 0);
+                break;
+            }
+        }
+    }
+
+    assert(p_program.text.size() * 4 ==
+               section_sizes[static_cast<size_t>(Section::kText)] &&
+           "The sizes of pass 1 and pass 2 should agree");
+    return true;
+}
@@ -0,0 +1,529 @@
+#include "sim/Simulator.hpp"
+
+#include <cinttypes>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+/// @brief `main` returns here; it's inside the host-call region so that the
+/// same check catches both.
+constexpr uint32_t kExitAddress = 0xfffffffc;
+
+int32_t toInt32(const float p_value, const bool p_truncate) {
+    if (std::isnan(p_value)) {
+        return INT32_MAX;
+    }
+    const float rounded = p_truncate ? std::trunc(p_value)
+                                     : std::nearbyint(p_value);
+    if (rounded >= 2147483648.0f) {
+        return INT32_MAX;
+    }
+    if (rounded < -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return static_cast<int32_t>(rounded);
+}
+
+uint32_t toUint32(const float p_value, const bool p_truncate) {
+    if (std::isnan(p_value)) {
+        return UINT32_MAX;
+    }
+    const float rounded = p_truncate ? std::trunc(p_value)
+                                     : std::nearbyint(p_value);
+    if (rounded >= 4294967296.0f) {
+        return UINT32_MAX;
+    }
+    if (rounded <= 0.0f) {
+        return 0;
+    }
+    return static_cast<uint32_t>(rounded);
+}
+
+uint32_t bitsOf(const float p_value) {
+    uint32_t bits;
+    std::memcpy(&bits, &p_value, sizeof(bits));
+    return bits;
+}
+
+float floatOf(const uint32_t p_bits) {
+    float value;
+    std::memcpy(&value, &p_bits, sizeof(value));
+    return value;
+}
+} // namespace
+
+Simulator::Simulator(const Program &p_program, std::FILE *p_in,
+                     std::FILE *p_out)
+    : m_program(p_program), m_memory(kMemorySize, 0), m_in(p_in),
+      m_out(p_out) {
+    std::memcpy(&m_memory[p_program.data_base], p_program.data.data(),
+                p_program.data.size());
+    m_x[1] = static_cast<int32_t>(kExitAddress);
+    m_x[2] = static_cast<int32_t>(kMemorySize - 16);
+}
+
+bool Simulator::fault(const std::string &p_message) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "pc 0x%08" PRIx32, m_pc);
+    m_error = std::string{buffer};
+    const uint32_t index = (m_pc - Program::kTextBase) / 4;
+    if (m_pc >= Program::kTextBase && index < m_program.text.size()) {
+        m_error += " (line " + std::to_string(m_program.text[index].line) + ")";
+    }
+    m_error += ": " + p_message;
+    return false;
+}
+
+bool Simulator::checkAddress(const uint32_t p_address, const uint32_t p_size) {
+    if (p_address % p_size != 0) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "misaligned access to 0x%08" PRIx32,
+                      p_address);
+        return fault(buffer);
+    }
+    if (p_address < m_program.data_base ||
+        static_cast<uint64_t>(p_address) + p_size > kMemorySize) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer),
+                      "access to unmapped address 0x%08" PRIx32, p_address);
+        return fault(buffer);
+    }
+    return true;
+}
+
+bool Simulator::callHost(const uint32_t p_address) {
+    const uint32_t index = (p_address - Program::kHostCallBase) / 4;
+    if (index >= m_program.host_calls.size()) {
+        return fault("jump to an invalid address");
+    }
+    const std::string &name = m_program.host_calls[index];
+    ++m_statistics.host_calls;
+
+    if (name == "printInt") {
+        std::fprintf(m_out, "%d\n", m_x[10]);
+    } else if (name == "printReal") {
+        std::fprintf(m_out, "%f\n", m_f[10]);
+    } else if (name == "printString") {
+        const uint32_t begin = static_cast<uint32_t>(m_x[10]);
+        uint32_t end = begin;
+        while (end < kMemorySize && m_memory[end] != '\0') {
+            ++end;
+        }
+        if (begin < m_program.data_base || end >= kMemorySize) {
+            return fault("printString() on an invalid string");
+        }
+        std::fprintf(m_out, "%.*s\n", static_cast<int>(end - begin),
+                     reinterpret_cast<const char *>(&m_memory[begin]));
+    } else if (name == "readInt") {
+        int value = 0;
+        if (std::fscanf(m_in, "%d", &value) != 1) {
+            value = 0;
+        }
+        m_x[10] = value;
+    } else if (name == "readReal") {
+        float value = 0;
+        if (std::fscanf(m_in, "%f", &value) != 1) {
+            value = 0;
+        }
+        m_f[10] = value;
+    } else if (name == "dumpProfile") {
+        // dumpProfile(counters, count, checksum, path) of an instrumented
+        // program (`--profile-generate`).
+        const auto counters = static_cast<uint32_t>(m_x[10]);
+        const auto count = static_cast<uint32_t>(m_x[11]);
+        const uint32_t path = static_cast<uint32_t>(m_x[13]);
+        uint32_t path_end = path;
+        while (path_end < kMemorySize && m_memory[path_end] != '\0') {
+            ++path_end;
+        }
+        if (path < m_program.data_base || path_end >= kMemorySize ||
+            counters < m_program.data_base || counters % 4 != 0 ||
+            counters + uint64_t{count} * 4 > kMemorySize) {
+            return fault("dumpProfile() on invalid counters");
+        }
+        const std::string path_name(
+            reinterpret_cast<const char *>(&m_memory[path]), path_end - path);
+        std::FILE *file = std::fopen(path_name.c_str(), "w");
+        if (!file) {
+            return fault("cannot write the profile to " + path_name);
+        }
+        std::fprintf(file,
+                     "P profile 1\nchecksum %08" PRIx32 "\ncounters %" PRIu32
+                     "\n",
+                     static_cast<uint32_t>(m_x[12]), count);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t value;
+            std::memcpy(&value, &m_memory[counters + i * 4], sizeof(value));
+            std::fprintf(file, "%" PRIu32 "\n", value);
+        }
+        std::fclose(file);
+    } else {
+        return fault("call to undefined function `" + name + "'");
+    }
+    m_pc = static_cast<uint32_t>(m_x[1]);
+    return true;
+}
+
+bool Simulator::run() {
+    auto it = m_program.symbols.find("main");
+    if (it == m_program.symbols.end()) {
+        return fault("undefined reference to `main'");
+    }
+    m_pc = it->second;
+
+    const auto &text = m_program.text;
+    int32_t *const x = m_x;
+    float *const f = m_f;
+    uint8_t *const memory = m_memory.data();
+
+    while (true) {
+        if (m_pc >= Program::kHostCallBase) {
+            if (m_pc == kExitAddress) {
+                break;
+            }
+            if (!callHost(m_pc)) {
+                return false;
+            }
+            continue;
+        }
+
+        const uint32_t index = (m_pc - Program::kTextBase) / 4;
+        if (m_pc < Program::kTextBase || m_pc % 4 != 0 ||
+            index >= text.size()) {
+            return fault("jump to an invalid address");
+        }
+        const Instruction &inst = text[index];
+        const int32_t rs1 = x[inst.rs1];
+        const int32_t rs2 = x[inst.rs2];
+        const auto urs1 = static_cast<uint32_t>(rs1);
+        const auto urs2 = static_cast<uint32_t>(rs2);
+        const int32_t imm = inst.imm;
+        const uint32_t address = urs1 + static_cast<uint32_t>(imm);
+        uint32_t next_pc = m_pc + 4;
+        int32_t result = 0;
+        bool writes_rd = true;
+
+        ++m_statistics.retired_instructions;
+        switch (inst.op) {
+        case Opcode::kLui:
+            result = static_cast<int32_t>(static_cast<uint32_t>(imm) << 12);
+            break;
+        case Opcode::kAuipc:
+            result = static_cast<int32_t>(m_pc + (static_cast<uint32_t>(imm) << 12));
+            break;
+        case Opcode::kJal:
+            result = static_cast<int32_t>(m_pc + 4);
+            next_pc = m_pc + imm;
+            break;
+        case Opcode::kJalr:
+            result = static_cast<int32_t>(m_pc + 4);
+            next_pc = address & ~1u;
+            break;
+        case Opcode::kBeq:
+        case Opcode::kBne:
+        case Opcode::kBlt:
+        case Opcode::kBge:
+        case Opcode::kBltu:
+        case Opcode::kBgeu: {
+            bool taken = false;
+            switch (inst.op) {
+            case Opcode::kBeq:
+                taken = rs1 == rs2;
+                break;
+            case Opcode::kBne:
+                taken = rs1 != rs2;
+                break;
+            case Opcode::kBlt:
+                taken = rs1 < rs2;
+                break;
+            case Opcode::kBge:
+                taken = rs1 >= rs2;
+                break;
+            case Opcode::kBltu:
+                taken = urs1 < urs2;
+                break;
+            default:
+                taken = urs1 >= urs2;
+                break;
+            }
+            if (taken) {
+                next_pc = m_pc + imm;
+                ++m_statistics.taken_branches;
+            }
+            writes_rd = false;
+            break;
+        }
+        case Opcode::kLb:
+        case Opcode::kLbu:
+            if (!checkAddress(address, 1)) {
+                return false;
+            }
+            result = (inst.op == Opcode::kLb)
+                         ? static_cast<int8_t>(memory[address])
+                         : memory[address];
+            ++m_statistics.loads;
+            break;
+        case Opcode::kLh:
+        case Opcode::kLhu: {
+            if (!checkAddress(address, 2)) {
+                return false;
+            }
+            uint16_t half;
+            std::memcpy(&half, &memory[address], 2);
+            result = (inst.op == Opcode::kLh) ? static_cast<int16_t>(half)
+                                               : half;
+            ++m_statistics.loads;
+            break;
+        }
+        case Opcode::kLw:
+            if (!checkAddress(address, 4)) {
+                return false;
+            }
+            std::memcpy(&result, &memory[address], 4);
+            ++m_statistics.loads;
+            break;
+        case Opcode::kSb:
+        case Opcode::kSh:
+        case Opcode::kSw: {
+            const uint32_t size = (inst.op == Opcode::kSb)   ? 1
+                                  : (inst.op == Opcode::kSh) ? 2
+                                                             : 4;
+            if (!checkAddress(address, size)) {
+                return false;
+            }
+            std::memcpy(&memory[address], &rs2, size);
+            ++m_statistics.stores;
+            writes_rd = false;
+            break;
+        }
+        case Opcode::kAddi:
+            result = static_cast<int32_t>(urs1 + static_cast<uint32_t>(imm));
+            break;
+        case Opcode::kSlti:
+            result = rs1 < imm;
+            break;
+        case Opcode::kSltiu:
+            result = urs1 < static_cast<uint32_t>(imm);
+            break;
+        case Opcode::kXori:
+            result = rs1 ^ imm;
+            break;
+        case Opcode::kOri:
+            result = rs1 | imm;
+            break;
+        case Opcode::kAndi:
+            result = rs1 & imm;
+            break;
+        case Opcode::kSlli:
+            result = static_cast<int32_t>(urs1 << (imm & 31));
+            break;
+        case Opcode::kSrli:
+            result = static_cast<int32_t>(urs1 >> (imm & 31));
+            break;
+        case Opcode::kSrai:
+            result = rs1 >> (imm & 31);
+            break;
+        case Opcode::kAdd:
+            result = static_cast<int32_t>(urs1 + urs2);
+            break;
+        case Opcode::kSub:
+            result = static_cast<int32_t>(urs1 - urs2);
+            break;
+        case Opcode::kSll:
+            result = static_cast<int32_t>(urs1 << (urs2 & 31));
+            break;
+        case Opcode::kSlt:
+            result = rs1 < rs2;
+            break;
+        case Opcode::kSltu:
+            result = urs1 < urs2;
+            break;
+        case Opcode::kXor:
+            result = rs1 ^ rs2;
+            break;
+        case Opcode::kSrl:
+            result = static_cast<int32_t>(urs1 >> (urs2 & 31));
+            break;
+        case Opcode::kSra:
+            result = rs1 >> (urs2 & 31);
+            break;
+        case Opcode::kOr:
+            result = rs1 | rs2;
+            break;
+        case Opcode::kAnd:
+            result = rs1 & rs2;
+            break;
+        case Opcode::kMul:
+            result = static_cast<int32_t>(urs1 * urs2);
+            break;
+        case Opcode::kMulh:
+            result = static_cast<int32_t>(
+                (static_cast<int64_t>(rs1) * static_cast<int64_t>(rs2)) >> 32);
+            break;
+        case Opcode::kMulhsu:
+            result = static_cast<int32_t>(
+                (static_cast<int64_t>(rs1) * static_cast<int64_t>(urs2)) >> 32);
+            break;
+        case Opcode::kMulhu:
+            result = static_cast<int32_t>(
+                (static_cast<uint64_t>(urs1) * static_cast<uint64_t>(urs2)) >> 32);
+            break;
+        case Opcode::kDiv:
+            if (rs2 == 0) {
+                result = -1;
+            } else if (rs1 == INT32_MIN && rs2 == -1) {
+                result = INT32_MIN;
+            } else {
+                result = rs1 / rs2;
+            }
+            break;
+        case Opcode::kDivu:
+            result = (urs2 == 0) ? -1 : static_cast<int32_t>(urs1 / urs2);
+            break;
+        case Opcode::kRem:
+            if (rs2 == 0) {
+                result = rs1;
+            } else if (rs1 == INT32_MIN && rs2 == -1) {
+                result = 0;
+            } else {
+                result = rs1 % rs2;
+            }
+            break;
+        case Opcode::kRemu:
+            result = (urs2 == 0) ? rs1 : static_cast<int32_t>(urs1 % urs2);
+            break;
+        case Opcode::kMin:
+            result = (rs1 < rs2) ? rs1 : rs2;
+            break;
+        case Opcode::kMax:
+            result = (rs1 < rs2) ? rs2 : rs1;
+            break;
+        case Opcode::kMinu:
+            result = static_cast<int32_t>((urs1 < urs2) ? urs1 : urs2);
+            break;
+        case Opcode::kMaxu:
+            result = static_cast<int32_t>((urs1 < urs2) ? urs2 : urs1);
+            break;
+        case Opcode::kCzeroEqz:
+            result = (rs2 == 0) ? 0 : rs1;
+            break;
+        case Opcode::kCzeroNez:
+            result = (rs2 != 0) ? 0 : rs1;
+            break;
+        case Opcode::kFlw:
+            if (!checkAddress(address, 4)) {
+                return false;
+            }
+            std::memcpy(&f[inst.rd], &memory[address], 4);
+            ++m_statistics.loads;
+            writes_rd = false;
+            break;
+        case Opcode::kFsw:
+            if (!checkAddress(address, 4)) {
+                return false;
+            }
+            std::memcpy(&memory[address], &f[inst.rs2], 4);
+            ++m_statistics.stores;
+            writes_rd = false;
+            break;
+        case Opcode::kFaddS:
+            f[inst.rd] = f[inst.rs1] + f[inst.rs2];
+            writes_rd = false;
+            break;
+        case Opcode::kFsubS:
+            f[inst.rd] = f[inst.rs1] - f[inst.rs2];
+            writes_rd = false;
+            break;
+        case Opcode::kFmulS:
+            f[inst.rd] = f[inst.rs1] * f[inst.rs2];
+            writes_rd = false;
+            break;
+        case Opcode::kFdivS:
+            f[inst.rd] = f[inst.rs1] / f[inst.rs2];
+            writes_rd = false;
+            break;
+        case Opcode::kFsqrtS:
+            f[inst.rd] = std::sqrt(f[inst.rs1]);
+            writes_rd = false;
+            break;
+        case Opcode::kFminS:
+            f[inst.rd] = std::fmin(f[inst.rs1], f[inst.rs2]);
+            writes_rd = false;
+            break;
+        case Opcode::kFmaxS:
+            f[inst.rd] = std::fmax(f[inst.rs1], f[inst.rs2]);
+            writes_rd = false;
+            break;
+        case Opcode::kFsgnjS:
+        case Opcode::kFsgnjnS:
+        case Opcode::kFsgnjxS: {
+            const uint32_t magnitude = bitsOf(f[inst.rs1]) & 0x7fffffffu;
+            uint32_t sign = bitsOf(f[inst.rs2]) & 0x80000000u;
+            if (inst.op == Opcode::kFsgnjnS) {
+                sign ^= 0x80000000u;
+            } else if (inst.op == Opcode::kFsgnjxS) {
+                sign ^= bitsOf(f[inst.rs1]) & 0x80000000u;
+            }
+            f[inst.rd] = floatOf(magnitude | sign);
+            writes_rd = false;
+            break;
+        }
+        case Opcode::kFcvtWS:
+            result = toInt32(f[inst.rs1], imm != 0);
+            break;
+        case Opcode::kFcvtWuS:
+            result = static_cast<int32_t>(toUint32(f[inst.rs1], imm != 0));
+            break;
+        case Opcode::kFcvtSW:
+            f[inst.rd] = static_cast<float>(rs1);
+            writes_rd = false;
+            break;
+        case Opcode::kFcvtSWu:
+            f[inst.rd] = static_cast<float>(urs1);
+            writes_rd = false;
+            break;
+        case Opcode::kFmvXW:
+            result = static_cast<int32_t>(bitsOf(f[inst.rs1]));
+            break;
+        case Opcode::kFmvWX:
+            f[inst.rd] = floatOf(urs1);
+            writes_rd = false;
+            break;
+        case Opcode::kFeqS:
+            result = f[inst.rs1] == f[inst.rs2];
+            break;
+        case Opcode::kFltS:
+            result = f[inst.rs1] < f[inst.rs2];
+            break;
+        case Opcode::kFleS:
+            result = f[inst.rs1] <= f[inst.rs2];
+            break;
+        case Opcode::kNumOpcodes:
+            return fault("illegal instruction");
+        }
+
+        if (writes_rd && inst.rd != 0) {
+            x[inst.rd] = result;
+        }
+        m_pc = next_pc;
+    }
+    return true;
+}
+
+void Simulator::dumpStatistics(std::FILE *p_file) const {
+    std::fprintf(p_file,
+                 "|---------------------------------------------------|\n"
+                 "|  retired instructions: %-26" PRIu64 " |\n"
+                 "|  loads:                %-26" PRIu64 " |\n"
+                 "|  stores:               %-26" PRIu64 " |\n"
+                 "|  taken branches:       %-26" PRIu64 " |\n"
+                 "|  runtime calls:        %-26" PRIu64 " |\n"
+                 "|---------------------------------------------------|\n",
+                 m_statistics.retired_instructions, m_statistics.loads,
+                 m_statistics.stores, m_statistics.taken_branches,
+                 m_statistics.host_calls);
+}
@@ -0,0 +1,50 @@
+#include "util/Arena.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+Arena &Arena::ast() {
+  static Arena arena;
+  return arena;
+}
+
+void *Arena::allocateInNewBlock(const std::size_t p_size,
+                                const std::size_t p_align) {
+  // A large object gets a block of its own so that the rest of the current
+  // block isn't wasted.
+  const std::size_t size = p_size + p_align - 1;
+  const bool is_large = size > kBlockSize / 4;
+  const std::size_t block_size = is_large ? size : kBlockSize;
+  char *block = static_cast<char *>(std::malloc(block_size));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  m_blocks.push_back(block);
+  ++m_stats.num_blocks;
+  m_stats.num_reserved_bytes += block_size;
+
+  const auto address = reinterpret_cast<std::uintptr_t>(block);
+  const auto aligned = (address + p_align - 1) & ~(p_align - 1);
+  if (!is_large) {
+    m_current = reinterpret_cast<char *>(aligned + p_size);
+    m_end = block + block_size;
+  }
+  return reinterpret_cast<void *>(aligned);
+}
+
+char *Arena::copy(const char *p_text, const std::size_t p_length) {
+  auto *text = static_cast<char *>(allocate(p_length + 1, 1));
+  std::memcpy(text, p_text, p_length);
+  text[p_length] = '\0';
+  return text;
+}
+
+void Arena::release() {
+  for (char *block : m_blocks) {
+    std::free(block);
+  }
+  m_blocks.clear();
+  m_current = nullptr;
+  m_end = nullptr;
+}
@@ -0,0 +1,28 @@
+#include "util/LineIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+LineIndex &LineIndex::source() {
+  static LineIndex index;
+  return index;
+}
+
+void LineIndex::scan(const char *const p_text, const std::size_t p_length) {
+  // memchr() compares a word or a vector register of bytes at a time, which
+  // beats testing the characters one by one.
+  const char *const end = p_text + p_length;
+  for (const char *newline = p_text;
+       (newline = static_cast<const char *>(
+            std::memchr(newline, '\n', end - newline))) != nullptr;) {
+    ++newline;
+    m_line_starts.push_back(m_scanned_length + (newline - p_text));
+  }
+  m_scanned_length += p_length;
+}
+
+uint32_t LineIndex::getLine(const uint32_t p_offset) const {
+  return std::upper_bound(m_line_starts.begin(), m_line_starts.end(),
+                          p_offset) -
+         m_line_starts.begin();
+}
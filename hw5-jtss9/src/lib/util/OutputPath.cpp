@@ -0,0 +1,17 @@
+#include "util/OutputPath.hpp"
+
+std::string getOutputPath(const std::string &p_source_path,
+                          const std::string &p_save_path,
+                          const char *const p_extension) {
+  const std::string::size_type slash_pos = p_source_path.rfind('/');
+  const std::string::size_type name_pos =
+      slash_pos == std::string::npos ? 0 : slash_pos + 1;
+  std::string name = p_source_path.substr(name_pos);
+  // A dot leading the name, as in `.p`, doesn't start an extension.
+  const std::string::size_type dot_pos = name.rfind('.');
+  if (dot_pos != std::string::npos && dot_pos > 0) {
+    name.erase(dot_pos);
+  }
+  return (p_save_path.empty() ? std::string{"."} : p_save_path) + "/" + name +
+         p_extension;
+}
@@ -0,0 +1,67 @@
+#include "util/SourceFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceFile &SourceFile::current() {
+  static SourceFile source;
+  return source;
+}
+
+bool SourceFile::open(const char *const p_path, std::string &p_error) {
+  close();
+  const int fd = ::open(p_path, O_RDONLY);
+  if (fd < 0) {
+    p_error = std::strerror(errno);
+    return false;
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    p_error = std::strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  const auto length = static_cast<std::size_t>(status.st_size);
+  const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const std::size_t mapped_length =
+      (length + kNumSentinels + page_size - 1) / page_size * page_size;
+
+  // Zeroed pages are reserved for the text and the sentinels, and the file
+  // is mapped over the beginning of them; the rest of its last page reads as
+  // zeros as well.
+  void *data = ::mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data != MAP_FAILED && length > 0 &&
+      ::mmap(data, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             fd, 0) == MAP_FAILED) {
+    const int error = errno;
+    ::munmap(data, mapped_length);
+    errno = error;
+    data = MAP_FAILED;
+  }
+  if (data == MAP_FAILED) {
+    p_error = std::strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  ::close(fd);
+
+  m_data = static_cast<char *>(data);
+  m_length = length;
+  m_mapped_length = mapped_length;
+  return true;
+}
+
+void SourceFile::close() {
+  if (m_data) {
+    ::munmap(m_data, m_mapped_length);
+  }
+  m_data = nullptr;
+  m_length = 0;
+  m_mapped_length = 0;
+}
@@ -0,0 +1,26 @@
+#include "util/StringInterner.hpp"
+
+#include <string>
+
+StringInterner &StringInterner::identifiers() {
+  static StringInterner interner;
+  return interner;
+}
+
+IdentifierId StringInterner::intern(const char *p_text,
+                                    const std::size_t p_length) {
+  std::string name(p_text, p_length);
+  auto it = m_ids.find(&name);
+  if (it != m_ids.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<IdentifierId>(m_names.size());
+  m_names.push_back(std::move(name));
+  m_ids.emplace(&m_names.back(), id);
+  return id;
+}
+
+IdentifierId StringInterner::find(const std::string &p_name) const {
+  auto it = m_ids.find(&p_name);
+  return it == m_ids.end() ? kNoId : it->second;
+}
@@ -0,0 +1,432 @@
+#include "vm/Bytecode.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr OperandFormat kOperandFormats[] = {
+#define BYTECODE_OPCODE_FORMAT(name, format) OperandFormat::format,
+    BYTECODE_OPCODES(BYTECODE_OPCODE_FORMAT)
+#undef BYTECODE_OPCODE_FORMAT
+};
+
+constexpr const char *kOpcodeNames[] = {
+#define BYTECODE_OPCODE_NAME(name, format) #name,
+    BYTECODE_OPCODES(BYTECODE_OPCODE_NAME)
+#undef BYTECODE_OPCODE_NAME
+};
+
+constexpr char kMagic[] = {'P', 'B', 'C'};
+constexpr uint8_t kVersion = 1;
+
+void writeUnsigned(std::vector<uint8_t> &p_bytes, uint32_t p_value) {
+    do {
+        uint8_t byte = p_value & 0x7f;
+        p_value >>= 7;
+        if (p_value != 0) {
+            byte |= 0x80;
+        }
+        p_bytes.push_back(byte);
+    } while (p_value != 0);
+}
+
+void writeSigned(std::vector<uint8_t> &p_bytes, const int32_t p_value) {
+    // Zigzag: small magnitudes take few bytes regardless of the sign.
+    writeUnsigned(p_bytes, (static_cast<uint32_t>(p_value) << 1) ^
+                               static_cast<uint32_t>(p_value >> 31));
+}
+
+void writeString(std::vector<uint8_t> &p_bytes, const std::string &p_string) {
+    writeUnsigned(p_bytes, static_cast<uint32_t>(p_string.size()));
+    p_bytes.insert(p_bytes.end(), p_string.begin(), p_string.end());
+}
+
+/// @brief Reads what `serialize()` writes; any read past the end makes
+/// `failed()` true and returns 0.
+class ByteReader {
+  private:
+    const std::vector<uint8_t> &m_bytes;
+    size_t m_position = 0;
+    bool m_failed = false;
+
+  public:
+    ByteReader(const std::vector<uint8_t> &p_bytes, const size_t p_position)
+        : m_bytes(p_bytes), m_position(p_position) {}
+
+    bool failed() const { return m_failed; }
+    bool atEnd() const { return m_position == m_bytes.size(); }
+
+    uint8_t readByte() {
+        if (m_position >= m_bytes.size()) {
+            m_failed = true;
+            return 0;
+        }
+        return m_bytes[m_position++];
+    }
+
+    uint32_t readUnsigned() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    int32_t readSigned() {
+        const uint32_t value = readUnsigned();
+        return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    std::string readString() {
+        const uint32_t length = readUnsigned();
+        if (m_bytes.size() - m_position < length) {
+            m_failed = true;
+            return "";
+        }
+        std::string string(m_bytes.begin() + m_position,
+                           m_bytes.begin() + m_position + length);
+        m_position += length;
+        return string;
+    }
+
+    /// @brief Reads a count of items that take at least a byte each, so that
+    /// a corrupted count can't make the caller allocate much.
+    uint32_t readCount() {
+        const uint32_t count = readUnsigned();
+        if (count > m_bytes.size() - m_position) {
+            m_failed = true;
+            return 0;
+        }
+        return count;
+    }
+};
+
+} // namespace
+
+OperandFormat getOperandFormat(const BytecodeOp p_op) {
+    return kOperandFormats[static_cast<size_t>(p_op)];
+}
+
+const char *getOpcodeName(const BytecodeOp p_op) {
+    return kOpcodeNames[static_cast<size_t>(p_op)];
+}
+
+uint32_t BytecodeModule::getLine(const uint32_t p_pc) const {
+    auto it = std::upper_bound(
+        lines.begin(), lines.end(), p_pc,
+        [](const uint32_t pc, const LineEntry &entry) { return pc < entry.pc; });
+    return it == lines.begin() ? 0 : std::prev(it)->line;
+}
+
+bool BytecodeModule::verify(std::string &p_error) const {
+    if (main_function >= functions.size() ||
+        functions[main_function].num_parameters != 0) {
+        p_error = "invalid main function";
+        return false;
+    }
+
+    for (const auto &function : functions) {
+        auto fail = [&](const uint32_t p_pc, const char *p_message) {
+            p_error = "function " + function.name + ": " +
+                      getOpcodeName(code[p_pc].op) + " at " +
+                      std::to_string(p_pc) + ": " + p_message;
+            return false;
+        };
+
+        const uint32_t end = function.entry + function.length;
+        if (function.length == 0 || end > code.size() ||
+            end < function.entry ||
+            function.num_parameters > function.frame_size) {
+            p_error = "function " + function.name + ": invalid layout";
+            return false;
+        }
+        // Execution must never fall off the end of a function.
+        const BytecodeOp last = code[end - 1].op;
+        if (last != BytecodeOp::kJump && last != BytecodeOp::kReturn &&
+            last != BytecodeOp::kReturnVoid) {
+            return fail(end - 1, "missing terminator");
+        }
+
+        auto is_register = [&](const uint32_t p_register) {
+            return p_register < function.frame_size;
+        };
+        auto is_target = [&](const uint32_t p_pc, const int32_t p_offset) {
+            const int64_t target = static_cast<int64_t>(p_pc) + 1 + p_offset;
+            return target >= function.entry && target < end;
+        };
+
+        for (uint32_t pc = function.entry; pc < end; ++pc) {
+            const BytecodeInstruction &instruction = code[pc];
+            const uint32_t a = instruction.a;
+            const uint32_t b = instruction.b;
+            const uint32_t c = instruction.c;
+            bool is_valid = true;
+            switch (getOperandFormat(instruction.op)) {
+            case OperandFormat::kNone:
+                break;
+            case OperandFormat::kA:
+                is_valid = is_register(a);
+                break;
+            case OperandFormat::kAB:
+                is_valid = is_register(a) && is_register(b);
+                break;
+            case OperandFormat::kABC:
+                is_valid = is_register(a) && is_register(b) && is_register(c);
+                break;
+            case OperandFormat::kABImm:
+                is_valid = is_register(a) && is_register(b);
+                break;
+            case OperandFormat::kAImm:
+                is_valid = is_register(a);
+                break;
+            case OperandFormat::kAConst:
+                is_valid = is_register(a) && instruction.bx() < constants.size();
+                break;
+            case OperandFormat::kAGlobal:
+                is_valid = is_register(a) && instruction.bx() < num_globals;
+                break;
+            case OperandFormat::kImmGlobal:
+                is_valid = instruction.bx() < num_globals;
+                break;
+            case OperandFormat::kLocalIndexed:
+                is_valid = is_register(a) && is_register(b) && is_register(c);
+                break;
+            case OperandFormat::kGlobalIndexed:
+                is_valid = is_register(a) && b < num_globals && is_register(c);
+                break;
+            case OperandFormat::kCopy:
+                is_valid = a + c <= function.frame_size &&
+                           b + c <= function.frame_size;
+                break;
+            case OperandFormat::kGlobalCopy:
+                is_valid = a + c <= function.frame_size && b + c <= num_globals;
+                break;
+            case OperandFormat::kCopyIndexed:
+            case OperandFormat::kGlobalCopyIndexed: {
+                if (pc + 1 == end || code[pc + 1].op != BytecodeOp::kExtra) {
+                    return fail(pc, "missing the count");
+                }
+                const bool is_global = getOperandFormat(instruction.op) ==
+                                       OperandFormat::kGlobalCopyIndexed;
+                is_valid = static_cast<uint64_t>(a) + code[pc + 1].bx() <=
+                               function.frame_size &&
+                           (is_global ? b < num_globals : is_register(b)) &&
+                           is_register(c);
+                // Skip the count.
+                ++pc;
+                break;
+            }
+            case OperandFormat::kExtra:
+                return fail(pc, "stray operand");
+            case OperandFormat::kJump:
+                is_valid = is_target(pc, instruction.sbx());
+                break;
+            case OperandFormat::kAJump:
+                is_valid = is_register(a) && is_target(pc, instruction.sbx());
+                break;
+            case OperandFormat::kABJump:
+                is_valid = is_register(a) && is_register(b) &&
+                           is_target(pc, instruction.sc());
+                break;
+            case OperandFormat::kAImmJump:
+                is_valid = is_register(a) && is_target(pc, instruction.sc());
+                break;
+            case OperandFormat::kCall:
+                is_valid = b < functions.size() &&
+                           a + functions[b].num_parameters <=
+                               function.frame_size;
+                break;
+            }
+            if (!is_valid) {
+                return fail(pc, "operand out of range");
+            }
+        }
+    }
+    return true;
+}
+
+void BytecodeModule::serialize(std::vector<uint8_t> &p_bytes) const {
+    p_bytes.insert(p_bytes.end(), std::begin(kMagic), std::end(kMagic));
+    p_bytes.push_back(kVersion);
+    writeUnsigned(p_bytes, num_globals);
+    writeUnsigned(p_bytes, main_function);
+
+    writeUnsigned(p_bytes, static_cast<uint32_t>(constants.size()));
+    for (const auto &constant : constants) {
+        p_bytes.push_back(static_cast<uint8_t>(constant.kind));
+        switch (constant.kind) {
+        case Constant::Kind::kInteger:
+            writeSigned(p_bytes, constant.integer);
+            break;
+        case Constant::Kind::kReal: {
+            uint32_t bits;
+            std::memcpy(&bits, &constant.real, sizeof(bits));
+            for (int i = 0; i < 4; ++i) {
+                p_bytes.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+            }
+            break;
+        }
+        case Constant::Kind::kString:
+            writeString(p_bytes, constant.string);
+            break;
+        }
+    }
+
+    writeUnsigned(p_bytes, static_cast<uint32_t>(functions.size()));
+    for (const auto &function : functions) {
+        writeString(p_bytes, function.name);
+        writeUnsigned(p_bytes, function.num_parameters);
+        writeUnsigned(p_bytes, function.frame_size);
+        writeUnsigned(p_bytes, function.entry);
+        writeUnsigned(p_bytes, function.length);
+    }
+
+    writeUnsigned(p_bytes, static_cast<uint32_t>(code.size()));
+    for (const auto &instruction : code) {
+        writeUnsigned(p_bytes, static_cast<uint32_t>(instruction.op));
+        writeUnsigned(p_bytes, instruction.a);
+        writeUnsigned(p_bytes, instruction.b);
+        writeUnsigned(p_bytes, instruction.c);
+    }
+
+    // The line table is delta-encoded.
+    writeUnsigned(p_bytes, static_cast<uint32_t>(lines.size()));
+    LineEntry previous{0, 0};
+    for (const auto &entry : lines) {
+        writeUnsigned(p_bytes, entry.pc - previous.pc);
+        writeSigned(p_bytes, static_cast<int32_t>(entry.line - previous.line));
+        previous = entry;
+    }
+}
+
+bool BytecodeModule::deserialize(const std::vector<uint8_t> &p_bytes,
+                                 BytecodeModule &p_module,
+                                 std::string &p_error) {
+    if (p_bytes.size() < sizeof(kMagic) + 1 ||
+        !std::equal(std::begin(kMagic), std::end(kMagic), p_bytes.begin())) {
+        p_error = "not a bytecode file";
+        return false;
+    }
+    if (p_bytes[sizeof(kMagic)] != kVersion) {
+        p_error = "unsupported bytecode version " +
+                  std::to_string(p_bytes[sizeof(kMagic)]);
+        return false;
+    }
+
+    ByteReader reader(p_bytes, sizeof(kMagic) + 1);
+    BytecodeModule module;
+    module.num_globals = reader.readUnsigned();
+    module.main_function = reader.readUnsigned();
+
+    module.constants.resize(reader.readCount());
+    for (auto &constant : module.constants) {
+        const uint8_t kind = reader.readByte();
+        constant.kind = static_cast<Constant::Kind>(kind);
+        switch (constant.kind) {
+        case Constant::Kind::kInteger:
+            constant.integer = reader.readSigned();
+            break;
+        case Constant::Kind::kReal: {
+            uint32_t bits = 0;
+            for (int i = 0; i < 4; ++i) {
+                bits |= static_cast<uint32_t>(reader.readByte()) << (8 * i);
+            }
+            std::memcpy(&constant.real, &bits, sizeof(bits));
+            break;
+        }
+        case Constant::Kind::kString:
+            constant.string = reader.readString();
+            break;
+        default:
+            p_error = "invalid constant kind " + std::to_string(kind);
+            return false;
+        }
+    }
+
+    module.functions.resize(reader.readCount());
+    for (auto &function : module.functions) {
+        function.name = reader.readString();
+        const uint32_t num_parameters = reader.readUnsigned();
+        const uint32_t frame_size = reader.readUnsigned();
+        if (num_parameters > UINT16_MAX || frame_size > UINT16_MAX) {
+            p_error = "function " + function.name + ": frame too large";
+            return false;
+        }
+        function.num_parameters = static_cast<uint16_t>(num_parameters);
+        function.frame_size = static_cast<uint16_t>(frame_size);
+        function.entry = reader.readUnsigned();
+        function.length = reader.readUnsigned();
+    }
+
+    module.code.resize(reader.readCount());
+    for (auto &instruction : module.code) {
+        const uint32_t op = reader.readUnsigned();
+        const uint32_t a = reader.readUnsigned();
+        const uint32_t b = reader.readUnsigned();
+        const uint32_t c = reader.readUnsigned();
+        if (op >= kNumBytecodeOps || a > UINT16_MAX || b > UINT16_MAX ||
+            c > UINT16_MAX) {
+            p_error = "invalid instruction";
+            return false;
+        }
+        instruction = BytecodeInstruction::make(static_cast<BytecodeOp>(op), a, b, c);
+    }
+
+    module.lines.resize(reader.readCount());
+    LineEntry previous{0, 0};
+    for (auto &entry : module.lines) {
+        entry.pc = previous.pc + reader.readUnsigned();
+        entry.line = previous.line + reader.readSigned();
+        previous = entry;
+    }
+
+    if (reader.failed() || !reader.atEnd()) {
+        p_error = "truncated or corrupted bytecode file";
+        return false;
+    }
+    if (!module.verify(p_error)) {
+        return false;
+    }
+    p_module = std::move(module);
+    return true;
+}
+
+bool BytecodeModule::save(const std::string &p_path) const {
+    std::vector<uint8_t> bytes;
+    serialize(bytes);
+    FILE *file = fopen(p_path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool succeeded =
+        fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && succeeded;
+}
+
+bool BytecodeModule::load(const std::string &p_path, BytecodeModule &p_module,
+                          std::string &p_error) {
+    FILE *file = fopen(p_path.c_str(), "rb");
+    if (!file) {
+        p_error = "failed to open " + p_path;
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) != 0) {
+        bytes.insert(bytes.end(), buffer, buffer + size);
+    }
+    fclose(file);
+    return deserialize(bytes, p_module, p_error);
+}
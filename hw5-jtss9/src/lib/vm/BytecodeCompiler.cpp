@@ -0,0 +1,919 @@
+#include "vm/BytecodeCompiler.hpp"
+
+#include "AST/TypeContext.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace {
+
+/// @return The number of registers (or globals) taken by a `p_type`.
+uint32_t getStorageSize(const PType &p_type) {
+    uint32_t size = 1;
+    for (const auto dim : p_type.getDimensions()) {
+        size *= static_cast<uint32_t>(dim);
+    }
+    return size;
+}
+
+bool fitsInt16(const int64_t p_value) {
+    return p_value >= INT16_MIN && p_value <= INT16_MAX;
+}
+
+/// @return The type both operands are converted to before the operation.
+const PType &getOperandType(const BinaryOperatorNode &p_bin_op) {
+    const auto *left_type = p_bin_op.getLeftOperand().getInferredType();
+    const auto *right_type = p_bin_op.getRightOperand().getInferredType();
+    if (left_type->isReal() || right_type->isReal()) {
+        return *TypeContext::types().getType(
+            PType::PrimitiveTypeEnum::kRealType);
+    }
+    return *left_type;
+}
+
+/// @return The opcode with an immediate right operand, or `p_op` if there's
+/// none. The immediate may be the left operand if `p_is_swapped`.
+BytecodeOp getImmediateForm(const BytecodeOp p_op, const bool p_is_swapped) {
+    switch (p_op) {
+    case BytecodeOp::kAddInt:
+        return BytecodeOp::kAddIntImm;
+    case BytecodeOp::kMulInt:
+        return BytecodeOp::kMulIntImm;
+    case BytecodeOp::kLessInt:
+        return p_is_swapped ? BytecodeOp::kGreaterIntImm : BytecodeOp::kLessIntImm;
+    case BytecodeOp::kLessEqualInt:
+        return p_is_swapped ? BytecodeOp::kGreaterEqualIntImm
+                            : BytecodeOp::kLessEqualIntImm;
+    case BytecodeOp::kEqualInt:
+        return BytecodeOp::kEqualIntImm;
+    case BytecodeOp::kNotEqualInt:
+        return BytecodeOp::kNotEqualIntImm;
+    default:
+        return p_op;
+    }
+}
+
+/// @return The conditional jump taken when the comparison `p_op` is false,
+/// or `p_op` if there's none.
+BytecodeOp getNegatedJump(const BytecodeOp p_op) {
+    switch (p_op) {
+    case BytecodeOp::kLessInt:
+        return BytecodeOp::kJumpIfNotLess;
+    case BytecodeOp::kLessEqualInt:
+        return BytecodeOp::kJumpIfNotLessEqual;
+    case BytecodeOp::kEqualInt:
+        return BytecodeOp::kJumpIfNotEqual;
+    case BytecodeOp::kNotEqualInt:
+        return BytecodeOp::kJumpIfEqual;
+    case BytecodeOp::kLessIntImm:
+        return BytecodeOp::kJumpIfNotLessImm;
+    case BytecodeOp::kLessEqualIntImm:
+        return BytecodeOp::kJumpIfNotLessEqualImm;
+    case BytecodeOp::kGreaterIntImm:
+        return BytecodeOp::kJumpIfNotGreaterImm;
+    case BytecodeOp::kGreaterEqualIntImm:
+        return BytecodeOp::kJumpIfNotGreaterEqualImm;
+    case BytecodeOp::kEqualIntImm:
+        return BytecodeOp::kJumpIfNotEqualImm;
+    case BytecodeOp::kNotEqualIntImm:
+        return BytecodeOp::kJumpIfEqualImm;
+    default:
+        return p_op;
+    }
+}
+
+bool isLabelOperandInC(const BytecodeOp p_op) {
+    const OperandFormat format = getOperandFormat(p_op);
+    return format == OperandFormat::kABJump ||
+           format == OperandFormat::kAImmJump;
+}
+
+} // namespace
+
+BytecodeCompiler::BytecodeCompiler(
+    std::unordered_map<SemanticAnalyzer::AstNodeAddr, SymbolManager::Table>
+        &&p_symbol_table_of_scoping_nodes)
+    : m_symbol_table_of_scoping_nodes(
+          std::move(p_symbol_table_of_scoping_nodes)) {}
+
+void BytecodeCompiler::fail(const std::string &p_message) {
+    // Keep the first error; the rest are likely caused by it.
+    if (m_error.empty()) {
+        m_error = p_message;
+    }
+}
+
+void BytecodeCompiler::emit(const BytecodeInstruction &p_instruction) {
+    m_code.push_back(p_instruction);
+    // No variable lives at or above `m_num_locals` while it's in scope.
+    m_writes_temp.push_back(p_instruction.a >= m_num_locals);
+}
+
+BytecodeCompiler::Label BytecodeCompiler::newLabel() {
+    m_label_positions.push_back(UINT32_MAX);
+    return static_cast<Label>(m_label_positions.size() - 1);
+}
+
+void BytecodeCompiler::bind(const Label p_label) {
+    m_label_positions[p_label] = static_cast<uint32_t>(m_code.size());
+}
+
+void BytecodeCompiler::emitJump(const BytecodeOp p_op, const Label p_label,
+                                const uint16_t p_a) {
+    emit(BytecodeInstruction::makeBx(p_op, p_a, p_label));
+}
+
+void BytecodeCompiler::markLine(const AstNode &p_node) {
+    const uint32_t pc = static_cast<uint32_t>(m_code.size());
+    const uint32_t line = p_node.getLocation().getLine();
+    if (!m_lines.empty() && m_lines.back().pc == pc) {
+        m_lines.back().line = line;
+    } else if (m_lines.empty() || m_lines.back().line != line) {
+        m_lines.push_back(BytecodeModule::LineEntry{pc, line});
+    }
+}
+
+void BytecodeCompiler::beginFunction() {
+    m_code.clear();
+    m_writes_temp.clear();
+    m_label_positions.clear();
+    m_lines.clear();
+    m_num_locals = 0;
+    m_next_register = 0;
+    m_frame_size = 0;
+}
+
+void BytecodeCompiler::endFunction(const std::string &p_name,
+                                   const uint32_t p_num_parameters) {
+    fuseSuperinstructions();
+
+    for (size_t pc = 0; pc < m_code.size(); ++pc) {
+        BytecodeInstruction &instruction = m_code[pc];
+        const OperandFormat format = getOperandFormat(instruction.op);
+        const bool is_short = isLabelOperandInC(instruction.op);
+        if (!is_short && format != OperandFormat::kJump &&
+            format != OperandFormat::kAJump) {
+            continue;
+        }
+        const Label label = is_short ? instruction.c : instruction.bx();
+        const int32_t offset = static_cast<int32_t>(m_label_positions[label]) -
+                               static_cast<int32_t>(pc + 1);
+        if (is_short) {
+            assert(fitsInt16(offset) && "Superinstruction jumps too far");
+            instruction.c = static_cast<uint16_t>(offset);
+        } else {
+            instruction = BytecodeInstruction::makeBx(instruction.op, instruction.a,
+                                              static_cast<uint32_t>(offset));
+        }
+    }
+
+    BytecodeModule::Function function;
+    function.name = p_name;
+    function.num_parameters = static_cast<uint16_t>(p_num_parameters);
+    // The return value is passed in the first register.
+    function.frame_size =
+        static_cast<uint16_t>(std::min<uint32_t>(
+            std::max<uint32_t>(m_frame_size, 1), UINT16_MAX));
+    function.entry = static_cast<uint32_t>(m_module.code.size());
+    function.length = static_cast<uint32_t>(m_code.size());
+    m_module.functions.push_back(function);
+
+    m_module.code.insert(m_module.code.end(), m_code.begin(), m_code.end());
+    for (const auto &entry : m_lines) {
+        m_module.lines.push_back(
+            BytecodeModule::LineEntry{function.entry + entry.pc, entry.line});
+    }
+}
+
+void BytecodeCompiler::fuseSuperinstructions() {
+    const size_t num_instructions = m_code.size();
+    std::vector<bool> is_target(num_instructions + 1, false);
+    for (const auto position : m_label_positions) {
+        is_target[position] = true;
+    }
+
+    std::vector<BytecodeInstruction> code;
+    std::vector<bool> writes_temp;
+    /// The index in `m_code` of the first instruction each one is formed of.
+    std::vector<uint32_t> origins;
+    std::vector<uint32_t> new_positions(num_instructions + 1);
+
+    // The sequences fused; `t` is a temporary:
+    //   kLoadInt t, k; <op> d, x, t           -> <op>Imm d, x, k
+    //   <compare> t, x, y; kJumpIfFalse t, L  -> kJumpIfNot<compare> x, y, L
+    //   kLoadGlobal t, g; kAddIntImm u, t, k; kStoreGlobal u, g
+    //                                         -> kIncGlobal k, g
+    auto fuse_tail = [&]() {
+        const size_t size = code.size();
+        if (size < 2 || is_target[origins[size - 1]]) {
+            return false;
+        }
+        const BytecodeInstruction &previous = code[size - 2];
+        const BytecodeInstruction &last = code[size - 1];
+        BytecodeInstruction fused = last;
+        bool fused_writes_temp = false;
+        size_t length = 2;
+
+        if (previous.op == BytecodeOp::kLoadInt && writes_temp[size - 2] &&
+            fitsInt16(previous.sbx()) &&
+            getOperandFormat(last.op) == OperandFormat::kABC) {
+            const uint16_t temp = previous.a;
+            const int32_t imm = previous.sbx();
+            const bool is_swapped = last.b == temp;
+            if ((last.b == temp) == (last.c == temp)) {
+                return false;
+            }
+            const uint16_t other = is_swapped ? last.c : last.b;
+            if (last.op == BytecodeOp::kSubInt && !is_swapped &&
+                fitsInt16(-static_cast<int64_t>(imm))) {
+                fused = BytecodeInstruction::make(BytecodeOp::kAddIntImm, last.a, other,
+                                          static_cast<uint16_t>(-imm));
+            } else if (getImmediateForm(last.op, is_swapped) != last.op) {
+                fused = BytecodeInstruction::make(getImmediateForm(last.op, is_swapped),
+                                          last.a, other,
+                                          static_cast<uint16_t>(imm));
+            } else {
+                return false;
+            }
+            fused_writes_temp = writes_temp[size - 1];
+        } else if (last.op == BytecodeOp::kJumpIfFalse && writes_temp[size - 2] &&
+                   previous.a == last.a &&
+                   getNegatedJump(previous.op) != previous.op) {
+            const Label label = last.bx();
+            // Fusing only shrinks the code, so the distance never grows by
+            // more than the jump moving back by one.
+            const int64_t distance =
+                static_cast<int64_t>(m_label_positions[label]) -
+                (static_cast<int64_t>(origins[size - 1]) + 1);
+            if (label > UINT16_MAX || !fitsInt16(std::abs(distance) + 1)) {
+                return false;
+            }
+            fused = BytecodeInstruction::make(getNegatedJump(previous.op), previous.b,
+                                      previous.c, static_cast<uint16_t>(label));
+        } else if (size >= 3 && last.op == BytecodeOp::kStoreGlobal &&
+                   previous.op == BytecodeOp::kAddIntImm &&
+                   code[size - 3].op == BytecodeOp::kLoadGlobal &&
+                   !is_target[origins[size - 2]] && writes_temp[size - 3] &&
+                   writes_temp[size - 2] && previous.b == code[size - 3].a &&
+                   last.a == previous.a && last.bx() == code[size - 3].bx()) {
+            fused = BytecodeInstruction::makeBx(BytecodeOp::kIncGlobal, previous.c,
+                                        last.bx());
+            length = 3;
+        } else {
+            return false;
+        }
+
+        const uint32_t origin = origins[size - length];
+        code.resize(size - length);
+        writes_temp.resize(size - length);
+        origins.resize(size - length);
+        code.push_back(fused);
+        writes_temp.push_back(fused_writes_temp);
+        origins.push_back(origin);
+        return true;
+    };
+
+    for (size_t i = 0; i < num_instructions; ++i) {
+        new_positions[i] = static_cast<uint32_t>(code.size());
+        code.push_back(m_code[i]);
+        writes_temp.push_back(m_writes_temp[i]);
+        origins.push_back(static_cast<uint32_t>(i));
+        // A fused instruction may be fused again, e.g., a comparison with a
+        // constant and then with the branch on it.
+        while (fuse_tail()) {
+        }
+    }
+    new_positions[num_instructions] = static_cast<uint32_t>(code.size());
+
+    for (auto &position : m_label_positions) {
+        position = new_positions[position];
+    }
+    std::vector<BytecodeModule::LineEntry> lines;
+    for (const auto &entry : m_lines) {
+        const uint32_t pc = new_positions[entry.pc];
+        if (!lines.empty() && lines.back().pc == pc) {
+            lines.back().line = entry.line;
+        } else {
+            lines.push_back(BytecodeModule::LineEntry{pc, entry.line});
+        }
+    }
+    m_lines = std::move(lines);
+    m_code = std::move(code);
+    m_writes_temp = std::move(writes_temp);
+}
+
+uint16_t BytecodeCompiler::allocateRegisters(const uint32_t p_count) {
+    const uint32_t first = m_next_register;
+    if (first + p_count > UINT16_MAX) {
+        fail("too many registers (variables) in a function");
+        return 0;
+    }
+    m_next_register += p_count;
+    m_frame_size = std::max(m_frame_size, m_next_register);
+    return static_cast<uint16_t>(first);
+}
+
+uint16_t BytecodeCompiler::getResultRegister() {
+    return m_dst != kAnyRegister ? static_cast<uint16_t>(m_dst)
+                                 : allocateRegisters(1);
+}
+
+uint32_t BytecodeCompiler::addConstant(
+    const BytecodeModule::Constant &p_constant) {
+    std::string key(1, static_cast<char>(p_constant.kind));
+    if (p_constant.kind == BytecodeModule::Constant::Kind::kReal) {
+        key.append(reinterpret_cast<const char *>(&p_constant.real),
+                   sizeof(p_constant.real));
+    } else {
+        key += p_constant.string;
+    }
+
+    auto it = m_constant_indices.find(key);
+    if (it == m_constant_indices.end()) {
+        it = m_constant_indices
+                 .emplace(std::move(key),
+                          static_cast<uint32_t>(m_module.constants.size()))
+                 .first;
+        m_module.constants.push_back(p_constant);
+    }
+    return it->second;
+}
+
+void BytecodeCompiler::emitConstant(const uint16_t p_dst,
+                                    const Constant &p_constant) {
+    const PType &type = *p_constant.getTypePtr();
+    BytecodeModule::Constant constant;
+    if (type.isPrimitiveInteger()) {
+        emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadInt, p_dst,
+                                 static_cast<uint32_t>(p_constant.integer())));
+        return;
+    }
+    if (type.isPrimitiveBool()) {
+        emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadInt, p_dst,
+                                 p_constant.boolean() ? 1 : 0));
+        return;
+    }
+    if (type.isPrimitiveReal()) {
+        constant.kind = BytecodeModule::Constant::Kind::kReal;
+        constant.real = static_cast<float>(p_constant.real());
+    } else {
+        constant.kind = BytecodeModule::Constant::Kind::kString;
+        constant.string = p_constant.string();
+    }
+    emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadConst, p_dst, addConstant(constant)));
+}
+
+uint16_t BytecodeCompiler::compileExpression(ExpressionNode &p_expr,
+                                             const int32_t p_dst) {
+    const int32_t saved_dst = m_dst;
+    m_dst = p_dst;
+    p_expr.accept(*this);
+    m_dst = saved_dst;
+    return m_result;
+}
+
+uint16_t BytecodeCompiler::compileCoerced(ExpressionNode &p_expr,
+                                          const PType &p_type,
+                                          const int32_t p_dst) {
+    if (!p_expr.getInferredType()->isInteger() || !p_type.isReal()) {
+        return compileExpression(p_expr, p_dst);
+    }
+    const uint32_t mark = m_next_register;
+    const uint16_t value = compileExpression(p_expr);
+    m_next_register = mark;
+    const uint16_t result = p_dst != kAnyRegister
+                                ? static_cast<uint16_t>(p_dst)
+                                : allocateRegisters(1);
+    emit(BytecodeInstruction::make(BytecodeOp::kIntToReal, result, value));
+    return result;
+}
+
+bool BytecodeCompiler::getConstantOffset(
+    const VariableReferenceNode &p_variable_ref, const PType &p_type,
+    uint32_t &p_offset) const {
+    const auto &indices = p_variable_ref.getIndices();
+    const auto &dims = p_type.getDimensions();
+    uint32_t offset = 0;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        int64_t index = 0;
+        if (i < indices.size()) {
+            const auto *constant =
+                dynamic_cast<const ConstantValueNode *>(indices[i].get());
+            if (!constant) {
+                return false;
+            }
+            index = constant->getConstantPtr()->integer();
+            if (index < 0 || index >= static_cast<int64_t>(dims[i])) {
+                return false;
+            }
+        }
+        offset = offset * static_cast<uint32_t>(dims[i]) +
+                 static_cast<uint32_t>(index);
+    }
+    p_offset = offset;
+    return true;
+}
+
+uint16_t BytecodeCompiler::compileElementOffset(
+    VariableReferenceNode &p_variable_ref, const PType &p_type) {
+    const auto &indices = p_variable_ref.getIndices();
+    const auto &dims = p_type.getDimensions();
+    const uint32_t start = m_next_register;
+
+    // Row-major: ((i0 * d1 + i1) * d2 + i2) ...; the partial offset stays in
+    // the register at `start`.
+    auto multiply = [&](const uint16_t p_offset, const uint64_t p_factor) {
+        const uint16_t factor = allocateRegisters(1);
+        emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadInt, factor,
+                                 static_cast<uint32_t>(p_factor)));
+        m_next_register = start;
+        const uint16_t product = allocateRegisters(1);
+        emit(BytecodeInstruction::make(BytecodeOp::kMulInt, product, p_offset, factor));
+        return product;
+    };
+
+    uint16_t offset = compileExpression(*indices[0]);
+    for (size_t i = 1; i < indices.size(); ++i) {
+        offset = multiply(offset, dims[i]);
+        const uint16_t index = compileExpression(*indices[i]);
+        emit(BytecodeInstruction::make(BytecodeOp::kAddInt, offset, offset, index));
+        m_next_register = start + 1;
+    }
+    // A partial reference designates a sub-array.
+    uint64_t stride = 1;
+    for (size_t i = indices.size(); i < dims.size(); ++i) {
+        stride *= dims[i];
+    }
+    if (stride != 1) {
+        offset = multiply(offset, stride);
+    }
+    return offset;
+}
+
+void BytecodeCompiler::compileStore(
+    VariableReferenceNode &p_variable_ref,
+    const std::function<uint16_t(int32_t)> &p_compile_value) {
+    const SymbolEntry *entry = p_variable_ref.getSymbolEntry();
+    const Location &location = m_locations.at(entry);
+    const PType &type = *entry->getTypePtr();
+
+    uint32_t offset = 0;
+    if (p_variable_ref.getIndices().empty() ||
+        getConstantOffset(p_variable_ref, type, offset)) {
+        if (!location.is_global) {
+            // Evaluate right into the variable.
+            p_compile_value(static_cast<int32_t>(location.index + offset));
+            return;
+        }
+        const uint16_t value = p_compile_value(kAnyRegister);
+        emit(BytecodeInstruction::makeBx(BytecodeOp::kStoreGlobal, value,
+                                 location.index + offset));
+        return;
+    }
+
+    const uint16_t index = compileElementOffset(p_variable_ref, type);
+    const uint16_t value = p_compile_value(kAnyRegister);
+    emit(BytecodeInstruction::make(location.is_global ? BytecodeOp::kStoreGlobalIndexed
+                                              : BytecodeOp::kStoreIndexed,
+                           value, static_cast<uint16_t>(location.index),
+                           index));
+}
+
+void BytecodeCompiler::emitArrayCopy(VariableReferenceNode &p_variable_ref,
+                                     const uint16_t p_dst,
+                                     const uint32_t p_count) {
+    const SymbolEntry *entry = p_variable_ref.getSymbolEntry();
+    const Location &location = m_locations.at(entry);
+    const PType &type = *entry->getTypePtr();
+
+    uint32_t offset = 0;
+    if (p_variable_ref.getIndices().empty() ||
+        getConstantOffset(p_variable_ref, type, offset)) {
+        emit(BytecodeInstruction::make(
+            location.is_global ? BytecodeOp::kCopyGlobal : BytecodeOp::kCopy, p_dst,
+            static_cast<uint16_t>(location.index + offset),
+            static_cast<uint16_t>(p_count)));
+        return;
+    }
+
+    const uint16_t index = compileElementOffset(p_variable_ref, type);
+    emit(BytecodeInstruction::make(location.is_global ? BytecodeOp::kCopyGlobalIndexed
+                                              : BytecodeOp::kCopyIndexed,
+                           p_dst, static_cast<uint16_t>(location.index),
+                           index));
+    emit(BytecodeInstruction::makeBx(BytecodeOp::kExtra, 0, p_count));
+}
+
+void BytecodeCompiler::visit(ProgramNode &p_program) {
+    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(*this); };
+    for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(),
+             visit_ast_node);
+    for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(),
+             visit_ast_node);
+
+    beginFunction();
+    m_return_type = p_program.getTypePtr();
+    markLine(p_program);
+    for (const auto *constant : m_global_constants) {
+        const SymbolEntry *entry = constant->getSymbolEntry();
+        const uint16_t value = allocateRegisters(1);
+        emitConstant(value, *constant->getConstantPtr());
+        emit(BytecodeInstruction::makeBx(BytecodeOp::kStoreGlobal, value,
+                                 m_locations.at(entry).index));
+        m_next_register = m_num_locals;
+    }
+
+    const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+
+    emit(BytecodeInstruction::make(BytecodeOp::kReturnVoid));
+    endFunction(p_program.getName(), 0);
+    m_module.main_function =
+        static_cast<uint32_t>(m_module.functions.size() - 1);
+
+    std::string error;
+    if (!hasError() && !m_module.verify(error)) {
+        fail("invalid bytecode: " + error);
+    }
+}
+
+void BytecodeCompiler::visit(DeclNode &p_decl) {
+    p_decl.visitChildNodes(*this);
+}
+
+void BytecodeCompiler::visit(VariableNode &p_variable) {
+    const SymbolEntry *entry = p_variable.getSymbolEntry();
+    const uint32_t size = getStorageSize(*p_variable.getTypePtr());
+    const Constant *constant = p_variable.getConstantPtr();
+
+    if (entry->getLevel() == 0) {
+        m_locations[entry] = Location{true, m_module.num_globals};
+        m_module.num_globals += size;
+        // The indexed forms address globals in 16 bits.
+        if (m_module.num_globals > UINT16_MAX) {
+            fail("too many global variables");
+        }
+        if (constant) {
+            m_global_constants.push_back(&p_variable);
+        }
+        return;
+    }
+
+    // Locals are declared before any statement of their scope, so no
+    // temporaries are live.
+    const uint16_t index = allocateRegisters(size);
+    m_num_locals = m_next_register;
+    m_locations[entry] = Location{false, index};
+    if (constant) {
+        emitConstant(index, *constant);
+    }
+}
+
+void BytecodeCompiler::visit(ConstantValueNode &p_constant_value) {
+    m_result = getResultRegister();
+    emitConstant(m_result, *p_constant_value.getConstantPtr());
+}
+
+void BytecodeCompiler::visit(FunctionNode &p_function) {
+    const SymbolEntry *function_entry = p_function.getSymbolEntry();
+
+    if (p_function.getBody()) {
+        // Assigned before the body is compiled for recursive calls.
+        m_function_indices[function_entry] =
+            static_cast<uint32_t>(m_module.functions.size());
+        beginFunction();
+        m_return_type = p_function.getTypePtr();
+        markLine(p_function);
+
+        // The caller places the arguments in the first registers; arrays are
+        // copied in whole, so they're passed by value.
+        for (const auto &parameter : p_function.getParameters()) {
+            for (const auto &variable : parameter->getVariables()) {
+                const SymbolEntry *entry = variable->getSymbolEntry();
+                m_locations[entry] = Location{
+                    false,
+                    allocateRegisters(getStorageSize(*variable->getTypePtr()))};
+            }
+        }
+        const uint32_t num_parameters = m_next_register;
+        m_num_locals = m_next_register;
+
+        p_function.visitBodyChildNodes(*this);
+
+        if (m_return_type->isVoid()) {
+            emit(BytecodeInstruction::make(BytecodeOp::kReturnVoid));
+        } else {
+            // Falling off the end of a function returns 0.
+            const uint16_t value = allocateRegisters(1);
+            emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadInt, value, 0));
+            emit(BytecodeInstruction::make(BytecodeOp::kReturn, value));
+        }
+        endFunction(p_function.getName(), num_parameters);
+    }
+}
+
+void BytecodeCompiler::visit(CompoundStatementNode &p_compound_statement) {
+    const uint32_t num_locals = m_num_locals;
+
+    p_compound_statement.visitChildNodes(*this);
+
+    // The registers of the locals are reused by the following statements.
+    m_num_locals = num_locals;
+    m_next_register = num_locals;
+}
+
+void BytecodeCompiler::visit(PrintNode &p_print) {
+    markLine(p_print);
+    ExpressionNode &target = p_print.getTarget();
+    const uint16_t value = compileExpression(target);
+
+    const PType &type = *target.getInferredType();
+    if (type.isReal()) {
+        emit(BytecodeInstruction::make(BytecodeOp::kPrintReal, value));
+    } else if (type.isString()) {
+        emit(BytecodeInstruction::make(BytecodeOp::kPrintString, value));
+    } else {
+        // `boolean`s are printed as 0 or 1.
+        emit(BytecodeInstruction::make(BytecodeOp::kPrintInt, value));
+    }
+    m_next_register = m_num_locals;
+}
+
+void BytecodeCompiler::visit(BinaryOperatorNode &p_bin_op) {
+    auto &left = const_cast<ExpressionNode &>(p_bin_op.getLeftOperand());
+    auto &right = const_cast<ExpressionNode &>(p_bin_op.getRightOperand());
+    const PType &operand_type = getOperandType(p_bin_op);
+    const bool is_real = operand_type.isReal();
+
+    const uint32_t mark = m_next_register;
+    const uint16_t lhs = compileCoerced(left, operand_type);
+    const uint16_t rhs = compileCoerced(right, operand_type);
+    m_next_register = mark;
+    m_result = getResultRegister();
+
+    BytecodeOp op = BytecodeOp::kAddInt;
+    bool is_swapped = false;
+    switch (p_bin_op.getOp()) {
+    case Operator::kPlusOp:
+        op = p_bin_op.getInferredType()->isString()
+                 ? BytecodeOp::kConcat
+                 : (is_real ? BytecodeOp::kAddReal : BytecodeOp::kAddInt);
+        break;
+    case Operator::kMinusOp:
+        op = is_real ? BytecodeOp::kSubReal : BytecodeOp::kSubInt;
+        break;
+    case Operator::kMultiplyOp:
+        op = is_real ? BytecodeOp::kMulReal : BytecodeOp::kMulInt;
+        break;
+    case Operator::kDivideOp:
+        op = is_real ? BytecodeOp::kDivReal : BytecodeOp::kDivInt;
+        break;
+    case Operator::kModOp:
+        op = BytecodeOp::kModInt;
+        break;
+    case Operator::kGreaterOp:
+        is_swapped = true;
+        // fall through
+    case Operator::kLessOp:
+        op = is_real ? BytecodeOp::kLessReal : BytecodeOp::kLessInt;
+        break;
+    case Operator::kGreaterOrEqualOp:
+        is_swapped = true;
+        // fall through
+    case Operator::kLessOrEqualOp:
+        op = is_real ? BytecodeOp::kLessEqualReal : BytecodeOp::kLessEqualInt;
+        break;
+    case Operator::kEqualOp:
+        op = is_real ? BytecodeOp::kEqualReal : BytecodeOp::kEqualInt;
+        break;
+    case Operator::kNotEqualOp:
+        op = is_real ? BytecodeOp::kNotEqualReal : BytecodeOp::kNotEqualInt;
+        break;
+    case Operator::kAndOp:
+        op = BytecodeOp::kAnd;
+        break;
+    case Operator::kOrOp:
+        op = BytecodeOp::kOr;
+        break;
+    default:
+        assert(false && "Unsupported binary operator");
+    }
+    emit(BytecodeInstruction::make(op, m_result, is_swapped ? rhs : lhs,
+                           is_swapped ? lhs : rhs));
+}
+
+void BytecodeCompiler::visit(UnaryOperatorNode &p_un_op) {
+    auto &operand = const_cast<ExpressionNode &>(p_un_op.getOperand());
+    const uint32_t mark = m_next_register;
+    const uint16_t value = compileExpression(operand);
+    m_next_register = mark;
+    m_result = getResultRegister();
+
+    switch (p_un_op.getOp()) {
+    case Operator::kNegOp:
+        emit(BytecodeInstruction::make(p_un_op.getInferredType()->isReal()
+                                   ? BytecodeOp::kNegReal
+                                   : BytecodeOp::kNegInt,
+                               m_result, value));
+        break;
+    case Operator::kNotOp:
+        emit(BytecodeInstruction::make(BytecodeOp::kNot, m_result, value));
+        break;
+    default:
+        assert(false && "Unsupported unary operator");
+    }
+}
+
+void BytecodeCompiler::visit(FunctionInvocationNode &p_func_invocation) {
+    const SymbolEntry *entry = p_func_invocation.getSymbolEntry();
+    auto it = m_function_indices.find(entry);
+    if (it == m_function_indices.end()) {
+        fail("invoking a function that is declared but never defined");
+        m_result = getResultRegister();
+        return;
+    }
+    std::vector<const PType *> parameter_types;
+    for (const auto &parameter : *entry->getAttribute().parameters()) {
+        for (const auto &variable : parameter->getVariables()) {
+            parameter_types.push_back(variable->getTypePtr());
+        }
+    }
+
+    // The arguments are evaluated into consecutive registers, which become
+    // the first registers of the callee.
+    const uint32_t base = m_next_register;
+    const auto &arguments = p_func_invocation.getArguments();
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const PType &type = *parameter_types[i];
+        const uint32_t size = getStorageSize(type);
+        const uint16_t slot = allocateRegisters(size);
+        if (type.isScalar()) {
+            compileCoerced(*arguments[i], type, slot);
+        } else {
+            auto *array = dynamic_cast<VariableReferenceNode *>(arguments[i].get());
+            assert(array && "An array argument must be a variable reference");
+            emitArrayCopy(*array, slot, size);
+        }
+        m_next_register = slot + size;
+    }
+    emit(BytecodeInstruction::make(BytecodeOp::kCall, static_cast<uint16_t>(base),
+                           static_cast<uint16_t>(it->second)));
+
+    // The callee returns the value in its first register.
+    m_next_register = base;
+    const uint16_t result = allocateRegisters(1);
+    if (m_dst != kAnyRegister) {
+        emit(BytecodeInstruction::make(BytecodeOp::kMove, static_cast<uint16_t>(m_dst),
+                               result));
+        m_next_register = base;
+        m_result = static_cast<uint16_t>(m_dst);
+    } else {
+        m_result = result;
+    }
+}
+
+void BytecodeCompiler::visit(VariableReferenceNode &p_variable_ref) {
+    const SymbolEntry *entry = p_variable_ref.getSymbolEntry();
+    const Location &location = m_locations.at(entry);
+    const PType &type = *entry->getTypePtr();
+
+    uint32_t offset = 0;
+    if (p_variable_ref.getIndices().empty() ||
+        getConstantOffset(p_variable_ref, type, offset)) {
+        if (location.is_global) {
+            m_result = getResultRegister();
+            emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadGlobal, m_result,
+                                     location.index + offset));
+            return;
+        }
+        // Read the variable in place unless it's asked elsewhere.
+        const uint16_t index = static_cast<uint16_t>(location.index + offset);
+        if (m_dst != kAnyRegister && m_dst != index) {
+            emit(BytecodeInstruction::make(BytecodeOp::kMove, static_cast<uint16_t>(m_dst),
+                                   index));
+            m_result = static_cast<uint16_t>(m_dst);
+        } else {
+            m_result = index;
+        }
+        return;
+    }
+
+    const uint32_t mark = m_next_register;
+    const uint16_t index = compileElementOffset(p_variable_ref, type);
+    m_next_register = mark;
+    m_result = getResultRegister();
+    emit(BytecodeInstruction::make(location.is_global ? BytecodeOp::kLoadGlobalIndexed
+                                              : BytecodeOp::kLoadIndexed,
+                           m_result, static_cast<uint16_t>(location.index),
+                           index));
+}
+
+void BytecodeCompiler::visit(AssignmentNode &p_assignment) {
+    markLine(p_assignment);
+    VariableReferenceNode &lvalue = p_assignment.getLvalue();
+    const PType &type = *lvalue.getInferredType();
+    compileStore(lvalue, [&](const int32_t p_dst) {
+        return compileCoerced(p_assignment.getExpr(), type, p_dst);
+    });
+    m_next_register = m_num_locals;
+}
+
+void BytecodeCompiler::visit(ReadNode &p_read) {
+    markLine(p_read);
+    auto &target = const_cast<VariableReferenceNode &>(p_read.getTarget());
+    const BytecodeOp op = target.getInferredType()->isReal() ? BytecodeOp::kReadReal
+                                                         : BytecodeOp::kReadInt;
+    compileStore(target, [&](const int32_t p_dst) {
+        const uint16_t value = p_dst != kAnyRegister
+                                   ? static_cast<uint16_t>(p_dst)
+                                   : allocateRegisters(1);
+        emit(BytecodeInstruction::make(op, value));
+        return value;
+    });
+    m_next_register = m_num_locals;
+}
+
+void BytecodeCompiler::visit(IfNode &p_if) {
+    markLine(p_if);
+    const Label else_label = newLabel();
+    const uint16_t condition = compileExpression(*p_if.m_condition);
+    emitJump(BytecodeOp::kJumpIfFalse, else_label, condition);
+    m_next_register = m_num_locals;
+
+    p_if.m_body->accept(*this);
+    if (p_if.m_else_body) {
+        const Label end_label = newLabel();
+        emitJump(BytecodeOp::kJump, end_label);
+        bind(else_label);
+        p_if.m_else_body->accept(*this);
+        bind(end_label);
+    } else {
+        bind(else_label);
+    }
+}
+
+void BytecodeCompiler::visit(WhileNode &p_while) {
+    const Label condition_label = newLabel();
+    const Label exit_label = newLabel();
+    bind(condition_label);
+    markLine(p_while);
+    const uint16_t condition = compileExpression(*p_while.m_condition);
+    emitJump(BytecodeOp::kJumpIfFalse, exit_label, condition);
+    m_next_register = m_num_locals;
+
+    p_while.m_body->accept(*this);
+    emitJump(BytecodeOp::kJump, condition_label);
+    bind(exit_label);
+}
+
+void BytecodeCompiler::visit(ForNode &p_for) {
+    const uint32_t num_locals = m_num_locals;
+
+    p_for.m_loop_var_decl->accept(*this);
+    p_for.m_init_stmt->accept(*this);
+
+    const SymbolEntry *entry =
+        p_for.m_loop_var_decl->getVariables()[0]->getSymbolEntry();
+    const uint16_t loop_var =
+        static_cast<uint16_t>(m_locations.at(entry).index);
+    const Label condition_label = newLabel();
+    const Label exit_label = newLabel();
+    bind(condition_label);
+    markLine(p_for);
+    // Fused into kJumpIfNotLessImm and kAddIntImm.
+    uint16_t temp = allocateRegisters(1);
+    emit(BytecodeInstruction::makeBx(
+        BytecodeOp::kLoadInt, temp,
+        static_cast<uint32_t>(
+            p_for.getUpperBound().getConstantPtr()->integer())));
+    emit(BytecodeInstruction::make(BytecodeOp::kLessInt, temp, loop_var, temp));
+    emitJump(BytecodeOp::kJumpIfFalse, exit_label, temp);
+    m_next_register = m_num_locals;
+
+    p_for.m_body->accept(*this);
+
+    markLine(p_for);
+    temp = allocateRegisters(1);
+    emit(BytecodeInstruction::makeBx(BytecodeOp::kLoadInt, temp, 1));
+    emit(BytecodeInstruction::make(BytecodeOp::kAddInt, loop_var, loop_var, temp));
+    m_next_register = m_num_locals;
+    emitJump(BytecodeOp::kJump, condition_label);
+    bind(exit_label);
+
+    m_num_locals = num_locals;
+    m_next_register = num_locals;
+}
+
+void BytecodeCompiler::visit(ReturnNode &p_return) {
+    markLine(p_return);
+    auto &value = const_cast<ExpressionNode &>(p_return.getReturnValue());
+    emit(BytecodeInstruction::make(BytecodeOp::kReturn,
+                           compileCoerced(value, *m_return_type)));
+    m_next_register = m_num_locals;
+}
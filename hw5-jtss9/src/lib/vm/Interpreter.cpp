@@ -0,0 +1,470 @@
+#include "vm/Interpreter.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__)
+#define VM_THREADED_DISPATCH 1
+#endif
+
+namespace {
+
+// Signed overflow wraps around as on RISC-V.
+int32_t wrapAdd(const int32_t p_lhs, const int32_t p_rhs) {
+    return static_cast<int32_t>(static_cast<uint32_t>(p_lhs) +
+                                static_cast<uint32_t>(p_rhs));
+}
+
+int32_t wrapSub(const int32_t p_lhs, const int32_t p_rhs) {
+    return static_cast<int32_t>(static_cast<uint32_t>(p_lhs) -
+                                static_cast<uint32_t>(p_rhs));
+}
+
+int32_t wrapMul(const int32_t p_lhs, const int32_t p_rhs) {
+    return static_cast<int32_t>(static_cast<uint32_t>(p_lhs) *
+                                static_cast<uint32_t>(p_rhs));
+}
+
+int32_t divide(const int32_t p_lhs, const int32_t p_rhs) {
+    if (p_rhs == 0) {
+        return -1;
+    }
+    if (p_rhs == -1) {
+        return wrapSub(0, p_lhs);
+    }
+    return p_lhs / p_rhs;
+}
+
+int32_t modulo(const int32_t p_lhs, const int32_t p_rhs) {
+    if (p_rhs == 0) {
+        return p_lhs;
+    }
+    if (p_rhs == -1) {
+        return 0;
+    }
+    return p_lhs % p_rhs;
+}
+
+int32_t readInt() {
+    int value = 0;
+    if (scanf("%d", &value) != 1) {
+        value = 0;
+    }
+    return value;
+}
+
+float readReal() {
+    float value = 0;
+    if (scanf("%f", &value) != 1) {
+        value = 0;
+    }
+    return value;
+}
+
+} // namespace
+
+Interpreter::Interpreter(const BytecodeModule &p_module) : m_module(p_module) {
+    for (const auto &constant : m_module.constants) {
+        Value value;
+        switch (constant.kind) {
+        case BytecodeModule::Constant::Kind::kInteger:
+            value.integer = constant.integer;
+            break;
+        case BytecodeModule::Constant::Kind::kReal:
+            value.real = constant.real;
+            break;
+        case BytecodeModule::Constant::Kind::kString:
+            value.string = constant.string.c_str();
+            break;
+        }
+        m_constants.push_back(value);
+    }
+}
+
+bool Interpreter::fail(const BytecodeInstruction *p_pc, const char *p_message) {
+    const uint32_t pc = static_cast<uint32_t>(p_pc - m_module.code.data());
+    m_error = "line " + std::to_string(m_module.getLine(pc)) + ": " + p_message;
+    fflush(stdout);
+    return false;
+}
+
+bool Interpreter::run() {
+    m_globals.assign(m_module.num_globals, Value{});
+    m_stack.assign(kStackSize, Value{});
+    m_string_pool.clear();
+
+    const BytecodeInstruction *const code = m_module.code.data();
+    const BytecodeModule::Function *const functions =
+        m_module.functions.data();
+    const Value *const constants = m_constants.data();
+    Value *const globals = m_globals.data();
+    const int64_t num_globals = static_cast<int64_t>(m_globals.size());
+    Value *const stack_end = m_stack.data() + m_stack.size();
+    std::vector<Frame> frames;
+
+    const BytecodeModule::Function *function =
+        &functions[m_module.main_function];
+    Value *base = m_stack.data();
+    int64_t frame_size = function->frame_size;
+    const BytecodeInstruction *pc = code + function->entry;
+
+#define R(x) base[x]
+
+#ifdef VM_THREADED_DISPATCH
+    static const void *const kHandlers[] = {
+#define VM_HANDLER_ADDRESS(name, format) &&handle_##name,
+        BYTECODE_OPCODES(VM_HANDLER_ADDRESS)
+#undef VM_HANDLER_ADDRESS
+    };
+#define VM_CASE(name) handle_##name:
+#define VM_DISPATCH() goto *kHandlers[static_cast<size_t>(pc->op)]
+#define VM_BEGIN() VM_DISPATCH();
+#define VM_END()
+#else
+#define VM_CASE(name) case BytecodeOp::name:
+#define VM_DISPATCH() continue
+#define VM_BEGIN()                                                             \
+    for (;;) {                                                                 \
+        switch (pc->op) {
+#define VM_END()                                                               \
+    }                                                                          \
+    }
+#endif
+#define VM_NEXT()                                                              \
+    {                                                                          \
+        ++pc;                                                                  \
+        VM_DISPATCH();                                                         \
+    }
+#define VM_JUMP(offset)                                                        \
+    {                                                                          \
+        pc += 1 + (offset);                                                    \
+        VM_DISPATCH();                                                         \
+    }
+#define VM_BRANCH(condition, offset)                                           \
+    {                                                                          \
+        pc += 1 + ((condition) ? (offset) : 0);                                \
+        VM_DISPATCH();                                                         \
+    }
+
+    VM_BEGIN()
+
+    VM_CASE(kMove) {
+        R(pc->a) = R(pc->b);
+        VM_NEXT();
+    }
+    VM_CASE(kLoadInt) {
+        R(pc->a).integer = pc->sbx();
+        VM_NEXT();
+    }
+    VM_CASE(kLoadConst) {
+        R(pc->a) = constants[pc->bx()];
+        VM_NEXT();
+    }
+    VM_CASE(kLoadGlobal) {
+        R(pc->a) = globals[pc->bx()];
+        VM_NEXT();
+    }
+    VM_CASE(kStoreGlobal) {
+        globals[pc->bx()] = R(pc->a);
+        VM_NEXT();
+    }
+    VM_CASE(kLoadIndexed) {
+        const int64_t index = int64_t{pc->b} + R(pc->c).integer;
+        if (index < 0 || index >= frame_size) {
+            return fail(pc, "array index out of range");
+        }
+        R(pc->a) = base[index];
+        VM_NEXT();
+    }
+    VM_CASE(kStoreIndexed) {
+        const int64_t index = int64_t{pc->b} + R(pc->c).integer;
+        if (index < 0 || index >= frame_size) {
+            return fail(pc, "array index out of range");
+        }
+        base[index] = R(pc->a);
+        VM_NEXT();
+    }
+    VM_CASE(kLoadGlobalIndexed) {
+        const int64_t index = int64_t{pc->b} + R(pc->c).integer;
+        if (index < 0 || index >= num_globals) {
+            return fail(pc, "array index out of range");
+        }
+        R(pc->a) = globals[index];
+        VM_NEXT();
+    }
+    VM_CASE(kStoreGlobalIndexed) {
+        const int64_t index = int64_t{pc->b} + R(pc->c).integer;
+        if (index < 0 || index >= num_globals) {
+            return fail(pc, "array index out of range");
+        }
+        globals[index] = R(pc->a);
+        VM_NEXT();
+    }
+    VM_CASE(kCopy) {
+        std::memmove(&R(pc->a), &R(pc->b), pc->c * sizeof(Value));
+        VM_NEXT();
+    }
+    VM_CASE(kCopyGlobal) {
+        std::memcpy(&R(pc->a), &globals[pc->b], pc->c * sizeof(Value));
+        VM_NEXT();
+    }
+    VM_CASE(kCopyIndexed) {
+        const int64_t start = int64_t{pc->b} + R(pc->c).integer;
+        const uint32_t count = pc[1].bx();
+        if (start < 0 || start + count > frame_size) {
+            return fail(pc, "array index out of range");
+        }
+        std::memmove(&R(pc->a), &base[start], count * sizeof(Value));
+        pc += 2;
+        VM_DISPATCH();
+    }
+    VM_CASE(kCopyGlobalIndexed) {
+        const int64_t start = int64_t{pc->b} + R(pc->c).integer;
+        const uint32_t count = pc[1].bx();
+        if (start < 0 || start + count > num_globals) {
+            return fail(pc, "array index out of range");
+        }
+        std::memcpy(&R(pc->a), &globals[start], count * sizeof(Value));
+        pc += 2;
+        VM_DISPATCH();
+    }
+    VM_CASE(kExtra) {
+        // Only reached by a jump; consumed by the instruction before it.
+        VM_NEXT();
+    }
+    VM_CASE(kAddInt) {
+        R(pc->a).integer = wrapAdd(R(pc->b).integer, R(pc->c).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kSubInt) {
+        R(pc->a).integer = wrapSub(R(pc->b).integer, R(pc->c).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kMulInt) {
+        R(pc->a).integer = wrapMul(R(pc->b).integer, R(pc->c).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kDivInt) {
+        R(pc->a).integer = divide(R(pc->b).integer, R(pc->c).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kModInt) {
+        R(pc->a).integer = modulo(R(pc->b).integer, R(pc->c).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kNegInt) {
+        R(pc->a).integer = wrapSub(0, R(pc->b).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kAddReal) {
+        R(pc->a).real = R(pc->b).real + R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kSubReal) {
+        R(pc->a).real = R(pc->b).real - R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kMulReal) {
+        R(pc->a).real = R(pc->b).real * R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kDivReal) {
+        R(pc->a).real = R(pc->b).real / R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kNegReal) {
+        R(pc->a).real = -R(pc->b).real;
+        VM_NEXT();
+    }
+    VM_CASE(kIntToReal) {
+        R(pc->a).real = static_cast<float>(R(pc->b).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kLessInt) {
+        R(pc->a).integer = R(pc->b).integer < R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kLessEqualInt) {
+        R(pc->a).integer = R(pc->b).integer <= R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kEqualInt) {
+        R(pc->a).integer = R(pc->b).integer == R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kNotEqualInt) {
+        R(pc->a).integer = R(pc->b).integer != R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kLessReal) {
+        R(pc->a).integer = R(pc->b).real < R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kLessEqualReal) {
+        R(pc->a).integer = R(pc->b).real <= R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kEqualReal) {
+        R(pc->a).integer = R(pc->b).real == R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kNotEqualReal) {
+        R(pc->a).integer = R(pc->b).real != R(pc->c).real;
+        VM_NEXT();
+    }
+    VM_CASE(kAnd) {
+        R(pc->a).integer = R(pc->b).integer & R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kOr) {
+        R(pc->a).integer = R(pc->b).integer | R(pc->c).integer;
+        VM_NEXT();
+    }
+    VM_CASE(kNot) {
+        R(pc->a).integer = R(pc->b).integer ^ 1;
+        VM_NEXT();
+    }
+    VM_CASE(kConcat) {
+        m_string_pool.emplace_back(R(pc->b).string);
+        m_string_pool.back() += R(pc->c).string;
+        R(pc->a).string = m_string_pool.back().c_str();
+        VM_NEXT();
+    }
+    VM_CASE(kJump) { VM_JUMP(pc->sbx()); }
+    VM_CASE(kJumpIfFalse) { VM_BRANCH(R(pc->a).integer == 0, pc->sbx()); }
+    VM_CASE(kCall) {
+        const BytecodeModule::Function *callee = &functions[pc->b];
+        Value *const callee_base = base + pc->a;
+        if (callee_base + callee->frame_size > stack_end) {
+            return fail(pc, "stack overflow");
+        }
+        frames.push_back(Frame{pc + 1, base, function});
+        base = callee_base;
+        function = callee;
+        frame_size = callee->frame_size;
+        pc = code + callee->entry;
+        VM_DISPATCH();
+    }
+    VM_CASE(kReturn) {
+        // The first register of the callee is the result of the caller.
+        R(0) = R(pc->a);
+        goto return_to_caller;
+    }
+    VM_CASE(kReturnVoid)
+    return_to_caller : {
+        if (frames.empty()) {
+            fflush(stdout);
+            return true;
+        }
+        const Frame &frame = frames.back();
+        pc = frame.return_pc;
+        base = frame.base;
+        function = frame.function;
+        frame_size = function->frame_size;
+        frames.pop_back();
+        VM_DISPATCH();
+    }
+    VM_CASE(kPrintInt) {
+        printf("%d\n", R(pc->a).integer);
+        VM_NEXT();
+    }
+    VM_CASE(kPrintReal) {
+        printf("%f\n", R(pc->a).real);
+        VM_NEXT();
+    }
+    VM_CASE(kPrintString) {
+        printf("%s\n", R(pc->a).string);
+        VM_NEXT();
+    }
+    VM_CASE(kReadInt) {
+        R(pc->a).integer = readInt();
+        VM_NEXT();
+    }
+    VM_CASE(kReadReal) {
+        R(pc->a).real = readReal();
+        VM_NEXT();
+    }
+    VM_CASE(kAddIntImm) {
+        R(pc->a).integer = wrapAdd(R(pc->b).integer, pc->sc());
+        VM_NEXT();
+    }
+    VM_CASE(kMulIntImm) {
+        R(pc->a).integer = wrapMul(R(pc->b).integer, pc->sc());
+        VM_NEXT();
+    }
+    VM_CASE(kLessIntImm) {
+        R(pc->a).integer = R(pc->b).integer < pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kLessEqualIntImm) {
+        R(pc->a).integer = R(pc->b).integer <= pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kGreaterIntImm) {
+        R(pc->a).integer = R(pc->b).integer > pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kGreaterEqualIntImm) {
+        R(pc->a).integer = R(pc->b).integer >= pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kEqualIntImm) {
+        R(pc->a).integer = R(pc->b).integer == pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kNotEqualIntImm) {
+        R(pc->a).integer = R(pc->b).integer != pc->sc();
+        VM_NEXT();
+    }
+    VM_CASE(kJumpIfNotLess) {
+        VM_BRANCH(!(R(pc->a).integer < R(pc->b).integer), pc->sc());
+    }
+    VM_CASE(kJumpIfNotLessEqual) {
+        VM_BRANCH(!(R(pc->a).integer <= R(pc->b).integer), pc->sc());
+    }
+    VM_CASE(kJumpIfNotEqual) {
+        VM_BRANCH(R(pc->a).integer != R(pc->b).integer, pc->sc());
+    }
+    VM_CASE(kJumpIfEqual) {
+        VM_BRANCH(R(pc->a).integer == R(pc->b).integer, pc->sc());
+    }
+    VM_CASE(kJumpIfNotLessImm) {
+        VM_BRANCH(!(R(pc->a).integer < pc->sb()), pc->sc());
+    }
+    VM_CASE(kJumpIfNotLessEqualImm) {
+        VM_BRANCH(!(R(pc->a).integer <= pc->sb()), pc->sc());
+    }
+    VM_CASE(kJumpIfNotGreaterImm) {
+        VM_BRANCH(!(R(pc->a).integer > pc->sb()), pc->sc());
+    }
+    VM_CASE(kJumpIfNotGreaterEqualImm) {
+        VM_BRANCH(!(R(pc->a).integer >= pc->sb()), pc->sc());
+    }
+    VM_CASE(kJumpIfNotEqualImm) {
+        VM_BRANCH(R(pc->a).integer != pc->sb(), pc->sc());
+    }
+    VM_CASE(kJumpIfEqualImm) {
+        VM_BRANCH(R(pc->a).integer == pc->sb(), pc->sc());
+    }
+    VM_CASE(kIncGlobal) {
+        Value &global = globals[pc->bx()];
+        global.integer = wrapAdd(global.integer, pc->sa());
+        VM_NEXT();
+    }
+
+    VM_END()
+
+#undef R
+#undef VM_CASE
+#undef VM_DISPATCH
+#undef VM_BEGIN
+#undef VM_END
+#undef VM_NEXT
+#undef VM_JUMP
+#undef VM_BRANCH
+
+    return false;
+}
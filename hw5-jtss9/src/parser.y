@@ -3,6 +3,7 @@
 #include "AST/CompoundStatement.hpp"
 #include "AST/ConstantValue.hpp"
 #include "AST/FunctionInvocation.hpp"
+#include "AST/TypeContext.hpp"
 #include "AST/UnaryOperator.hpp"
 #include "AST/VariableReference.hpp"
 #include "AST/assignment.hpp"
@@ -20,31 +21,37 @@
 #include "AST/while.hpp"
 
 #include "codegen/CodeGenerator.hpp"
+#include "codegen/CSourceGenerator.hpp"
+#include "codegen/LlvmIrGenerator.hpp"
+#include "codegen/Profile.hpp"
+#include "jit/JitCompiler.hpp"
 #include "sema/SemanticAnalyzer.hpp"
+#include "sim/Assembler.hpp"
+#include "sim/Simulator.hpp"
+#include "util/Arena.hpp"
+#include "util/LineIndex.hpp"
+#include "util/OutputPath.hpp"
+#include "util/SourceFile.hpp"
+#include "vm/BytecodeCompiler.hpp"
+#include "vm/Interpreter.hpp"
 
 #include "AST/constant.hpp"
 #include "AST/operator.hpp"
 
 #include "AST/AstDumper.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-
-#define YYLTYPE yyltype
-
-typedef struct YYLTYPE {
-    uint32_t first_line;
-    uint32_t first_column;
-    uint32_t last_line;
-    uint32_t last_column;
-} yyltype;
+#include <fstream>
+#include <sstream>
+#include <string>
 
 extern int32_t line_num;    /* declared in scanner.l */
 extern char current_line[]; /* declared in scanner.l */
 extern uint32_t opt_dmp;    /* declared in scanner.l */
-extern FILE *yyin;          /* declared by lex */
 extern char *yytext;        /* declared by lex */
 
 static AstNode *root;
@@ -52,6 +59,7 @@ static AstNode *root;
 extern "C" int yylex(void);
 static void yyerror(const char *msg);
 extern int yylex_destroy(void);
+extern struct yy_buffer_state *yy_scan_buffer(char *base, size_t size);
 %}
 
 // This guarantees that headers do not conflict when included together.
@@ -60,10 +68,17 @@ extern int yylex_destroy(void);
 %code requires {
     #include "AST/utils.hpp"
     #include "AST/PType.hpp"
+    #include "util/Arena.hpp"
 
     #include <vector>
     #include <memory>
 
+    // The location of a symbol is the offset of its first character.
+    #define YYLTYPE Location
+    #define YYLTYPE_IS_DECLARED 1
+    #define YYLLOC_DEFAULT(Current, Rhs, N) \
+        (Current) = YYRHSLOC(Rhs, (N) ? 1 : 0)
+
     class AstNode;
     class DeclNode;
     class ConstantValueNode;
@@ -75,7 +90,7 @@ extern int yylex_destroy(void);
     /* For yylval */
 %union {
     /* basic semantic value */
-    char *identifier;
+    IdentifierId identifier;
     uint32_t integer;
     double real;
     char *string;
@@ -84,19 +99,19 @@ extern int yylex_destroy(void);
     int32_t sign;
 
     AstNode *node;
-    PType *type_ptr;
+    const PType *type_ptr;
     DeclNode *decl_ptr;
     CompoundStatementNode *compound_stmt_ptr;
     ConstantValueNode *constant_value_node_ptr;
     FunctionNode *func_ptr;
     ExpressionNode *expr_ptr;
 
-    std::vector<std::unique_ptr<DeclNode>> *decls_ptr;
+    AstVector<std::unique_ptr<DeclNode>> *decls_ptr;
     std::vector<IdInfo> *ids_ptr;
     std::vector<uint64_t> *dimensions_ptr;
-    std::vector<std::unique_ptr<FunctionNode>> *funcs_ptr;
-    std::vector<std::unique_ptr<AstNode>> *nodes_ptr;
-    std::vector<std::unique_ptr<ExpressionNode>> *exprs_ptr;
+    AstVector<std::unique_ptr<FunctionNode>> *funcs_ptr;
+    AstVector<std::unique_ptr<AstNode>> *nodes_ptr;
+    AstVector<std::unique_ptr<ExpressionNode>> *exprs_ptr;
 };
 
 %type <identifier> ProgramName ID FunctionName
@@ -162,11 +177,11 @@ Program:
     DeclarationList FunctionList CompoundStatement
     /* End of ProgramBody */
     END {
-        root = new ProgramNode(@1.first_line, @1.first_column,
-                               $1, new PType(PType::PrimitiveTypeEnum::kVoidType),
+        root = new ProgramNode(@1, $1,
+                               TypeContext::types().getType(
+                                   PType::PrimitiveTypeEnum::kVoidType),
                                *$3, *$4, $5);
 
-        free($1);
         delete $3;
         delete $4;
     }
@@ -178,7 +193,7 @@ ProgramName:
 
 DeclarationList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = new AstVector<std::unique_ptr<DeclNode>>();
     }
     |
     Declarations
@@ -186,7 +201,7 @@ DeclarationList:
 
 Declarations:
     Declaration {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = new AstVector<std::unique_ptr<DeclNode>>();
         $$->emplace_back($1);
     }
     |
@@ -198,7 +213,7 @@ Declarations:
 
 FunctionList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<FunctionNode>>();
+        $$ = new AstVector<std::unique_ptr<FunctionNode>>();
     }
     |
     Functions
@@ -206,7 +221,7 @@ FunctionList:
 
 Functions:
     Function {
-        $$ = new std::vector<std::unique_ptr<FunctionNode>>();
+        $$ = new AstVector<std::unique_ptr<FunctionNode>>();
         $$->emplace_back($1);
     }
     |
@@ -224,8 +239,7 @@ Function:
 
 FunctionDeclaration:
     FunctionName L_PARENTHESIS FormalArgList R_PARENTHESIS ReturnType SEMICOLON {
-        $$ = new FunctionNode(@1.first_line, @1.first_column, $1, *$3, $5, nullptr);
-        free($1);
+        $$ = new FunctionNode(@1, $1, *$3, $5, nullptr);
         delete $3;
     }
 ;
@@ -234,8 +248,7 @@ FunctionDefinition:
     FunctionName L_PARENTHESIS FormalArgList R_PARENTHESIS ReturnType
     CompoundStatement
     END {
-        $$ = new FunctionNode(@1.first_line, @1.first_column, $1, *$3, $5, $6);
-        free($1);
+        $$ = new FunctionNode(@1, $1, *$3, $5, $6);
         delete $3;
     }
 ;
@@ -246,7 +259,7 @@ FunctionName:
 
 FormalArgList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = new AstVector<std::unique_ptr<DeclNode>>();
     }
     |
     FormalArgs
@@ -254,7 +267,7 @@ FormalArgList:
 
 FormalArgs:
     FormalArg {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = new AstVector<std::unique_ptr<DeclNode>>();
         $$->emplace_back($1);
     }
     |
@@ -266,7 +279,7 @@ FormalArgs:
 
 FormalArg:
     IdList COLON Type {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $1, $3);
+        $$ = new DeclNode(@1, $1, $3);
         delete $1;
     }
 ;
@@ -274,13 +287,11 @@ FormalArg:
 IdList:
     ID {
         $$ = new std::vector<IdInfo>();
-        $$->emplace_back(@1.first_line, @1.first_column, $1);
-        free($1);
+        $$->emplace_back(@1, $1);
     }
     |
     IdList COMMA ID {
-        $1->emplace_back(@3.first_line, @3.first_column, $3);
-        free($3);
+        $1->emplace_back(@3, $3);
         $$ = $1;
     }
 ;
@@ -291,7 +302,7 @@ ReturnType:
     }
     |
     Epsilon {
-        $$ = new PType(PType::PrimitiveTypeEnum::kVoidType);
+        $$ = TypeContext::types().getType(PType::PrimitiveTypeEnum::kVoidType);
     }
 ;
 
@@ -301,12 +312,12 @@ ReturnType:
 
 Declaration:
     VAR IdList COLON Type SEMICOLON {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $2, $4);
+        $$ = new DeclNode(@1, $2, $4);
         delete $2;
     }
     |
     VAR IdList COLON LiteralConstant SEMICOLON {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $2, $4);
+        $$ = new DeclNode(@1, $2, $4);
         delete $2;
     }
 ;
@@ -317,22 +328,30 @@ Type:
     ArrType
 ;
 
-    /* no need to release PType object since it'll be assigned to the shared_ptr */
+    /* the types are owned by the TypeContext */
 ScalarType:
-    INTEGER { $$ = new PType(PType::PrimitiveTypeEnum::kIntegerType); }
+    INTEGER {
+        $$ = TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType);
+    }
     |
-    REAL { $$ = new PType(PType::PrimitiveTypeEnum::kRealType); }
+    REAL {
+        $$ = TypeContext::types().getType(PType::PrimitiveTypeEnum::kRealType);
+    }
     |
-    STRING { $$ = new PType(PType::PrimitiveTypeEnum::kStringType); }
+    STRING {
+        $$ = TypeContext::types().getType(PType::PrimitiveTypeEnum::kStringType);
+    }
     |
-    BOOLEAN { $$ = new PType(PType::PrimitiveTypeEnum::kBoolType); }
+    BOOLEAN {
+        $$ = TypeContext::types().getType(PType::PrimitiveTypeEnum::kBoolType);
+    }
 ;
 
 ArrType:
     ArrDecl ScalarType {
-        $2->setDimensions(*$1);
+        $$ = TypeContext::types().getType($2->getPrimitiveType(),
+                                          std::move(*$1));
         delete $1;
-        $$ = $2;
     }
 ;
 
@@ -352,24 +371,22 @@ LiteralConstant:
         Constant::ConstantValue value;
         value.integer = static_cast<int64_t>($1) * static_cast<int64_t>($2);
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-				PType::PrimitiveTypeEnum::kIntegerType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
         auto * const pos = ($1 == 1) ? &@2 : &@1;
         // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(pos->first_line, pos->first_column, constant);
+        $$ = new ConstantValueNode(*pos, constant);
     }
     |
     NegOrNot REAL_LITERAL {
         Constant::ConstantValue value;
         value.real = static_cast<double>($1) * static_cast<double>($2);
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kRealType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kRealType),
             value);
         auto * const pos = ($1 == 1) ? &@2 : &@1;
         // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(pos->first_line, pos->first_column, constant);
+        $$ = new ConstantValueNode(*pos, constant);
     }
     |
     StringAndBoolean
@@ -390,30 +407,27 @@ StringAndBoolean:
         Constant::ConstantValue value;
         value.string = $1;
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kStringType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kStringType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = new ConstantValueNode(@1, constant);
     }
     |
     TRUE {
         Constant::ConstantValue value;
         value.boolean = $1;
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kBoolType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kBoolType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = new ConstantValueNode(@1, constant);
     }
     |
     FALSE {
         Constant::ConstantValue value;
         value.boolean = $1;
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kBoolType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kBoolType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = new ConstantValueNode(@1, constant);
     }
 ;
 
@@ -422,22 +436,20 @@ IntegerAndReal:
         Constant::ConstantValue value;
         value.integer = static_cast<int64_t>($1);
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-				PType::PrimitiveTypeEnum::kIntegerType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
         // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = new ConstantValueNode(@1, constant);
     }
     |
     REAL_LITERAL {
         Constant::ConstantValue value;
         value.real = static_cast<double>($1);
         auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kRealType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kRealType),
             value);
         // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = new ConstantValueNode(@1, constant);
     }
 ;
 
@@ -468,8 +480,7 @@ CompoundStatement:
     DeclarationList
     StatementList
     END {
-        $$ = new CompoundStatementNode(@1.first_line, @1.first_column,
-                                       *$2, *$3);
+        $$ = new CompoundStatementNode(@1, *$2, *$3);
         delete $2;
         delete $3;
     }
@@ -477,31 +488,29 @@ CompoundStatement:
 
 Simple:
     VariableReference ASSIGN Expression SEMICOLON {
-        $$ = new AssignmentNode(@2.first_line, @2.first_column,
-                                dynamic_cast<VariableReferenceNode *>($1), $3);
+        $$ = new AssignmentNode(@2, dynamic_cast<VariableReferenceNode *>($1),
+                                $3);
     }
     |
     PRINT Expression SEMICOLON {
-        $$ = new PrintNode(@1.first_line, @1.first_column, $2);
+        $$ = new PrintNode(@1, $2);
     }
     |
     READ VariableReference SEMICOLON {
-        $$ = new ReadNode(@1.first_line, @1.first_column,
-                          dynamic_cast<VariableReferenceNode *>($2));
+        $$ = new ReadNode(@1, dynamic_cast<VariableReferenceNode *>($2));
     }
 ;
 
 VariableReference:
     ID ArrRefList {
-        $$ = new VariableReferenceNode(@1.first_line, @1.first_column, $1, *$2);
-        free($1);
+        $$ = new VariableReferenceNode(@1, $1, *$2);
         delete $2;
     }
 ;
 
 ArrRefList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = new AstVector<std::unique_ptr<ExpressionNode>>();
     }
     |
     ArrRefs
@@ -509,7 +518,7 @@ ArrRefList:
 
 ArrRefs:
     L_BRACKET Expression R_BRACKET {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = new AstVector<std::unique_ptr<ExpressionNode>>();
         $$->emplace_back($2);
     }
     |
@@ -524,7 +533,7 @@ Condition:
     CompoundStatement
     ElseOrNot
     END IF {
-        $$ = new IfNode(@1.first_line, @1.first_column, $2, $4, $5);
+        $$ = new IfNode(@1, $2, $4, $5);
     }
 ;
 
@@ -543,7 +552,7 @@ While:
     WHILE Expression DO
     CompoundStatement
     END DO {
-        $$ = new WhileNode(@1.first_line, @1.first_column, $2, $4);
+        $$ = new WhileNode(@1, $2, $4);
     }
 ;
 
@@ -556,41 +565,36 @@ For:
         ConstantValueNode *constant_value_node;
 
         // DeclNode
-        auto *ids = new std::vector<IdInfo>{IdInfo(@2.first_line, @2.first_column,
-                                                   $2)};
-        auto *type = new PType(PType::PrimitiveTypeEnum::kIntegerType);
-        auto *var_decl = new DeclNode(@2.first_line, @2.first_column, ids, type);
+        auto *ids = new std::vector<IdInfo>{IdInfo(@2, $2)};
+        const auto *type =
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType);
+        auto *var_decl = new DeclNode(@2, ids, type);
 
         // AssignmentNode
-        auto *var_ref = new VariableReferenceNode(@2.first_line, @2.first_column, $2);
+        auto *var_ref = new VariableReferenceNode(@2, $2);
         value.integer = static_cast<int64_t>($4);
         constant = new Constant(
-            std::make_shared<PType>(PType::PrimitiveTypeEnum::kIntegerType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
-        constant_value_node = new ConstantValueNode(@4.first_line, @4.first_column,
-                                                    constant);
-        auto *assignment = new AssignmentNode(@3.first_line, @3.first_column,
-                                              var_ref, constant_value_node);
+        constant_value_node = new ConstantValueNode(@4, constant);
+        auto *assignment = new AssignmentNode(@3, var_ref, constant_value_node);
 
         // ExpressionNode
         value.integer = static_cast<int64_t>($6);
         constant = new Constant(
-            std::make_shared<PType>(PType::PrimitiveTypeEnum::kIntegerType),
+            TypeContext::types().getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
-        constant_value_node = new ConstantValueNode(@6.first_line, @6.first_column,
-                                                    constant);
+        constant_value_node = new ConstantValueNode(@6, constant);
 
-        $$ = new ForNode(@1.first_line, @1.first_column,
-                         var_decl, assignment, constant_value_node,
+        $$ = new ForNode(@1, var_decl, assignment, constant_value_node,
                          $8);
-        free($2);
         delete ids;
     }
 ;
 
 Return:
     RETURN Expression SEMICOLON {
-        $$ = new ReturnNode(@1.first_line, @1.first_column, $2);
+        $$ = new ReturnNode(@1, $2);
     }
 ;
 
@@ -602,15 +606,14 @@ FunctionCall:
 
 FunctionInvocation:
     ID L_PARENTHESIS ExpressionList R_PARENTHESIS {
-        $$ = new FunctionInvocationNode(@1.first_line, @1.first_column, $1, *$3);
-        free($1);
+        $$ = new FunctionInvocationNode(@1, $1, *$3);
         delete $3;
     }
 ;
 
 ExpressionList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = new AstVector<std::unique_ptr<ExpressionNode>>();
     }
     |
     Expressions
@@ -618,7 +621,7 @@ ExpressionList:
 
 Expressions:
     Expression {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = new AstVector<std::unique_ptr<ExpressionNode>>();
         $$->emplace_back($1);
     }
     |
@@ -630,7 +633,7 @@ Expressions:
 
 StatementList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<AstNode>>();
+        $$ = new AstVector<std::unique_ptr<AstNode>>();
     }
     |
     Statements
@@ -638,7 +641,7 @@ StatementList:
 
 Statements:
     Statement {
-        $$ = new std::vector<std::unique_ptr<AstNode>>();
+        $$ = new AstVector<std::unique_ptr<AstNode>>();
         $$->emplace_back($1);
     }
     |
@@ -654,78 +657,63 @@ Expression:
     }
     |
     MINUS Expression %prec UNARY_MINUS {
-        $$ = new UnaryOperatorNode(@1.first_line, @1.first_column,
-                                   Operator::kNegOp, $2);
+        $$ = new UnaryOperatorNode(@1, Operator::kNegOp, $2);
     }
     |
     Expression MULTIPLY Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kMultiplyOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kMultiplyOp, $1, $3);
     }
     |
     Expression DIVIDE Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kDivideOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kDivideOp, $1, $3);
     }
     |
     Expression MOD Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kModOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kModOp, $1, $3);
     }
     |
     Expression PLUS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kPlusOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kPlusOp, $1, $3);
     }
     |
     Expression MINUS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kMinusOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kMinusOp, $1, $3);
     }
     |
     Expression LESS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kLessOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kLessOp, $1, $3);
     }
     |
     Expression LESS_OR_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kLessOrEqualOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kLessOrEqualOp, $1, $3);
     }
     |
     Expression GREATER Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kGreaterOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kGreaterOp, $1, $3);
     }
     |
     Expression GREATER_OR_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kGreaterOrEqualOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kGreaterOrEqualOp, $1, $3);
     }
     |
     Expression EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kEqualOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kEqualOp, $1, $3);
     }
     |
     Expression NOT_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kNotEqualOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kNotEqualOp, $1, $3);
     }
     |
     NOT Expression {
-        $$ = new UnaryOperatorNode(@1.first_line, @1.first_column,
-                                   Operator::kNotOp, $2);
+        $$ = new UnaryOperatorNode(@1, Operator::kNotOp, $2);
     }
     |
     Expression AND Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kAndOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kAndOp, $1, $3);
     }
     |
     Expression OR Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kOrOp, $1, $3);
+        $$ = new BinaryOperatorNode(@2, Operator::kOrOp, $1, $3);
     }
     |
     IntegerAndReal
@@ -761,42 +749,335 @@ void yyerror(const char *msg) {
     exit(-1);
 }
 
+/// @brief Assembles the generated code and runs it on the built-in RV32IMF
+/// simulator. The statistics are printed to stderr so that stdout only
+/// contains the output of the program.
+static int runInSimulator(const std::string &asm_path) {
+    std::ifstream asm_file(asm_path);
+    if (!asm_file) {
+        fprintf(stderr, "Failed to open %s\n", asm_path.c_str());
+        return -1;
+    }
+    std::stringstream source;
+    source << asm_file.rdbuf();
+
+    Program program;
+    Assembler assembler(asm_path);
+    if (!assembler.assemble(source.str(), program)) {
+        fprintf(stderr, "%s\n", assembler.getError().c_str());
+        return -1;
+    }
+
+    Simulator simulator(program);
+    const bool succeeded = simulator.run();
+    fflush(stdout);
+    if (!succeeded) {
+        fprintf(stderr, "Simulation aborted at %s\n",
+                simulator.getError().c_str());
+    }
+    simulator.dumpStatistics(stderr);
+    return succeeded ? 0 : -1;
+}
+
+/// @brief Runs a bytecode module on the built-in interpreter.
+static int runInInterpreter(const BytecodeModule &module) {
+    Interpreter interpreter(module);
+    if (!interpreter.run()) {
+        fprintf(stderr, "VM aborted at %s\n", interpreter.getError().c_str());
+        return -1;
+    }
+    return 0;
+}
+
+/// @brief Frees the AST with the arena it's allocated in.
+///
+/// The nodes aren't destroyed: what they own, down to their lists of
+/// children and the strings they cache, is in the arena as well, so freeing
+/// its blocks is all there is to it.
+static void releaseAst(const bool p_dump_stats) {
+    root = nullptr;
+
+    Arena &arena = Arena::ast();
+    if (p_dump_stats) {
+        const Arena::Stats &stats = arena.getStats();
+        fprintf(stderr,
+                "AST arena: %zu allocations, %zu bytes in %zu blocks "
+                "(%zu bytes reserved)\n",
+                stats.num_allocations, stats.num_allocated_bytes,
+                stats.num_blocks, stats.num_reserved_bytes);
+    }
+    arena.release();
+}
+
+using PassClock = std::chrono::steady_clock;
+
+/// @brief Reports the wall time a pass has taken since `p_start` if
+/// `--time-passes` is given.
+static void reportPassTime(const bool p_enabled, const char *const p_pass,
+                           const PassClock::time_point p_start) {
+    if (!p_enabled) {
+        return;
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        PassClock::now() - p_start;
+    fprintf(stderr, "%-20s %10.3f ms\n", p_pass, elapsed.count());
+}
+
+static bool isBytecodeFile(const std::string &file_name) {
+    const std::string extension = ".pbc";
+    return file_name.size() > extension.size() &&
+           file_name.compare(file_name.size() - extension.size(),
+                             extension.size(), extension) == 0;
+}
+
 int main(int argc, const char *argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <filename> --save-path [save path]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <filename> [--dump-ast] "
+                        "[--save-path <save path>] [--emit=riscv|llvm|c|bytecode] "
+                        "[--run] [--jit] [--vm] "
+                        "[--profile-generate[=<profile>]] "
+                        "[--profile-use=<profile>] "
+                        "[--march=rv32imf[_zicond][_zbb]] [--remarks] "
+                        "[--cache-size=<bytes>] [--alloc-stats] "
+                        "[--time-passes]\n",
+                argv[0]);
+        exit(-1);
+    }
+
+    bool opt_dump_ast = false;
+    bool opt_run = false;
+    bool opt_jit = false;
+    bool opt_vm = false;
+    bool opt_profile_generate = false;
+    std::string profile_generate_path;
+    std::string profile_use_path;
+    bool has_zicond = false;
+    bool has_zbb = false;
+    bool opt_remarks = false;
+    bool opt_alloc_stats = false;
+    bool opt_time_passes = false;
+    uint32_t cache_size = 32768;
+    const char *save_path = "";
+    std::string emit_target = "riscv";
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--dump-ast") == 0) {
+            opt_dump_ast = true;
+        } else if (strcmp(argv[i], "--save-path") == 0 && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (strncmp(argv[i], "--emit=", 7) == 0) {
+            emit_target = argv[i] + 7;
+            if (emit_target != "riscv" && emit_target != "llvm" &&
+                emit_target != "c" && emit_target != "bytecode") {
+                fprintf(stderr, "Unknown target: %s\n", emit_target.c_str());
+                exit(-1);
+            }
+        } else if (strcmp(argv[i], "--run") == 0) {
+            opt_run = true;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            opt_jit = true;
+        } else if (strcmp(argv[i], "--vm") == 0) {
+            opt_vm = true;
+        } else if (strcmp(argv[i], "--profile-generate") == 0) {
+            opt_profile_generate = true;
+        } else if (strncmp(argv[i], "--profile-generate=", 19) == 0) {
+            opt_profile_generate = true;
+            profile_generate_path = argv[i] + 19;
+        } else if (strncmp(argv[i], "--profile-use=", 14) == 0) {
+            profile_use_path = argv[i] + 14;
+        } else if (strncmp(argv[i], "--march=", 8) == 0) {
+            // Only the extensions the code generator can use matter.
+            const std::string march = argv[i] + 8;
+            if (march.compare(0, 4, "rv32") != 0) {
+                fprintf(stderr, "Unsupported architecture: %s\n",
+                        march.c_str());
+                exit(-1);
+            }
+            has_zicond = march.find("_zicond") != std::string::npos;
+            has_zbb = march.find("_zbb") != std::string::npos;
+        } else if (strcmp(argv[i], "--remarks") == 0) {
+            opt_remarks = true;
+        } else if (strncmp(argv[i], "--cache-size=", 13) == 0) {
+            char *end = nullptr;
+            const unsigned long size = strtoul(argv[i] + 13, &end, 10);
+            if (*end != '\0' || size == 0 || size > UINT32_MAX) {
+                fprintf(stderr, "Invalid cache size: %s\n", argv[i] + 13);
+                exit(-1);
+            }
+            cache_size = static_cast<uint32_t>(size);
+        } else if (strcmp(argv[i], "--alloc-stats") == 0) {
+            opt_alloc_stats = true;
+        } else if (strcmp(argv[i], "--time-passes") == 0) {
+            opt_time_passes = true;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            exit(-1);
+        }
+    }
+
+    if (opt_run && emit_target != "riscv") {
+        fprintf(stderr, "--run only runs RISC-V code\n");
         exit(-1);
     }
+    if ((opt_profile_generate || !profile_use_path.empty()) &&
+        (emit_target != "riscv" || opt_jit || opt_vm)) {
+        fprintf(stderr, "Profiles only apply to RISC-V code\n");
+        exit(-1);
+    }
+    if (opt_profile_generate && profile_generate_path.empty()) {
+        profile_generate_path = getOutputPath(argv[1], save_path, ".prof");
+    }
+
+    // A compiled program is run right away without the front end.
+    if (isBytecodeFile(argv[1])) {
+        BytecodeModule module;
+        std::string error;
+        if (!BytecodeModule::load(argv[1], module, error)) {
+            fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+            return -1;
+        }
+        return runInInterpreter(module);
+    }
 
-    yyin = fopen(argv[1], "r");
-    if (yyin == NULL) {
-        perror("fopen() failed");
+    // The scanner reads the mapped file in place instead of through `yyin`.
+    SourceFile &source = SourceFile::current();
+    std::string source_error;
+    if (!source.open(argv[1], source_error)) {
+        fprintf(stderr, "%s: %s\n", argv[1], source_error.c_str());
         exit(-1);
     }
+    LineIndex::source().scan(source.getText(), source.getLength());
+    yy_scan_buffer(source.getBuffer(), source.getBufferSize());
 
+    PassClock::time_point pass_start = PassClock::now();
     yyparse();
+    reportPassTime(opt_time_passes, "parsing", pass_start);
 
-    if (argc >= 3 && strcmp(argv[2], "--dump-ast") == 0) {
+    if (opt_dump_ast) {
+        pass_start = PassClock::now();
         AstDumper ast_dumper;
-        root->accept(ast_dumper);
+        ast_dumper.dispatch(*root);
+        reportPassTime(opt_time_passes, "AST dump", pass_start);
     }
 
+    pass_start = PassClock::now();
     SemanticAnalyzer sema_analyzer(opt_dmp);
-    root->accept(sema_analyzer);
-
-    CodeGenerator code_generator(
-        argv[1], (argc == 4) ? argv[3] : "",
-        std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
-    root->accept(code_generator);
-
-    if (!sema_analyzer.hasError()) {
+    sema_analyzer.dispatch(*root);
+    reportPassTime(opt_time_passes, "semantic analysis", pass_start);
+
+    if (opt_jit) {
+        int exit_code = -1;
+        if (!sema_analyzer.hasError()) {
+            JitCompiler jit_compiler(
+                std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+            root->accept(jit_compiler);
+            if (jit_compiler.run()) {
+                exit_code = 0;
+            } else {
+                fprintf(stderr, "JIT failed: %s\n",
+                        jit_compiler.getError().c_str());
+            }
+        }
+        releaseAst(opt_alloc_stats);
+        yylex_destroy();
+        source.close();
+        return exit_code;
+    }
+
+    if (opt_vm) {
+        int exit_code = -1;
+        if (!sema_analyzer.hasError()) {
+            BytecodeCompiler bytecode_compiler(
+                std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+            root->accept(bytecode_compiler);
+            if (bytecode_compiler.hasError()) {
+                fprintf(stderr, "Bytecode compilation failed: %s\n",
+                        bytecode_compiler.getError().c_str());
+            } else {
+                exit_code = runInInterpreter(bytecode_compiler.getModule());
+            }
+        }
+        releaseAst(opt_alloc_stats);
+        yylex_destroy();
+        source.close();
+        return exit_code;
+    }
+
+    std::string asm_path;
+    if (emit_target == "llvm") {
+        if (!sema_analyzer.hasError()) {
+            LlvmIrGenerator llvm_ir_generator(
+                argv[1], save_path,
+                std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+            root->accept(llvm_ir_generator);
+        }
+    } else if (emit_target == "c") {
+        if (!sema_analyzer.hasError()) {
+            CSourceGenerator c_source_generator(
+                argv[1], save_path,
+                std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+            root->accept(c_source_generator);
+        }
+    } else if (emit_target == "bytecode") {
+        if (!sema_analyzer.hasError()) {
+            BytecodeCompiler bytecode_compiler(
+                std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+            root->accept(bytecode_compiler);
+            const std::string bytecode_path = getOutputPath(argv[1], save_path, ".pbc");
+            if (bytecode_compiler.hasError()) {
+                fprintf(stderr, "Bytecode compilation failed: %s\n",
+                        bytecode_compiler.getError().c_str());
+            } else if (!bytecode_compiler.getModule().save(bytecode_path)) {
+                fprintf(stderr, "Failed to write %s\n", bytecode_path.c_str());
+            }
+        }
+    } else if (!sema_analyzer.hasError()) {
+        // The scope closes the output file before it's read back by `--run`.
+        // The symbols of a program with errors may be unbound, so it isn't
+        // generated.
+        CodeGenerator code_generator(
+            argv[1], save_path,
+            std::move(sema_analyzer.acquireSymbolTableOfScopingNodes()));
+        code_generator.setExtensions(has_zicond, has_zbb);
+        code_generator.setRemarks(opt_remarks);
+        code_generator.setCacheSize(cache_size);
+        ProfileLayout profile_layout;
+        ProfileData profile;
+        if (opt_profile_generate || !profile_use_path.empty()) {
+            root->accept(profile_layout);
+        }
+        if (opt_profile_generate) {
+            code_generator.instrumentProfile(profile_layout,
+                                             profile_generate_path);
+        }
+        if (!profile_use_path.empty()) {
+            std::string error;
+            if (profile.load(profile_use_path, profile_layout, error)) {
+                code_generator.useProfile(profile_layout, profile);
+            } else {
+                fprintf(stderr, "warning: %s; the profile is ignored\n",
+                        error.c_str());
+            }
+        }
+        pass_start = PassClock::now();
+        code_generator.dispatch(*root);
+        reportPassTime(opt_time_passes, "code generation", pass_start);
+        asm_path = code_generator.getOutputFilePath();
+    }
+
+    int exit_code = 0;
+    if (opt_run) {
+        exit_code = sema_analyzer.hasError() ? -1 : runInSimulator(asm_path);
+    } else if (!sema_analyzer.hasError()) {
         printf("\n"
                "|---------------------------------------------------|\n"
                "|  There is no syntactic error and semantic error!  |\n"
                "|---------------------------------------------------|\n");
     }
 
-    delete root;
-    fclose(yyin);
+    pass_start = PassClock::now();
+    releaseAst(opt_alloc_stats);
+    reportPassTime(opt_time_passes, "AST teardown", pass_start);
     yylex_destroy();
-    return 0;
+    source.close();
+    return exit_code;
 }
@@ -27,3 +27,15 @@ void printString(char *value)
 {
     printf("%s\n", value);
 }
+
+/* Called at exit by programs built with `--profile-generate`. */
+void dumpProfile(unsigned *counters, int count, unsigned checksum, char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return;
+    fprintf(file, "P profile 1\nchecksum %08x\ncounters %d\n", checksum, count);
+    for (int i = 0; i < count; ++i)
+        fprintf(file, "%u\n", counters[i]);
+    fclose(file);
+}
@@ -29,15 +29,17 @@ class TestCase:
     type: CaseType
     score: float
     name: str
+    expects_error: bool = False
 
 
 class Grader:
     """
-    case_id: TestCase(case_type, score, case_name)
-        case_id     Used by the "--case_id" flag to run only one test case
-        case_type   The diff of CaseType.HIDDEN is not shown
-        score       The max score of the test case
-        case_name   The name of the file in "test_cases" and "sample_solutions"
+    case_id: TestCase(case_type, score, case_name[, expects_error])
+        case_id         Used by the "--case_id" flag to run only one test case
+        case_type       The diff of CaseType.HIDDEN is not shown
+        score           The max score of the test case
+        case_name       The name of the file in "test_cases" and "sample_solutions"
+        expects_error   The program has errors, so the diagnostics of the compiler are diffed instead of its output
     """
     CASES: Dict[str, TestCase] = {
         "1": TestCase(CaseType.OPEN, 5.0, "01_variable_constant"),
@@ -80,13 +82,26 @@ class Grader:
         "h18": TestCase(CaseType.HIDDEN, 1.5, "h18_bonus_string"),
         "h19": TestCase(CaseType.HIDDEN, 1.5, "h19_bonus_real_1"),
         "h20": TestCase(CaseType.HIDDEN, 1.5, "h20_bonus_real_2"),
+        "r1": TestCase(CaseType.OPEN, 0.0, "r01_redeclared_variable", expects_error=True),
+        "r2": TestCase(CaseType.OPEN, 0.0, "r02_if_conversion"),
+        "r3": TestCase(CaseType.OPEN, 0.0, "r03_switch_lowering"),
+        "r4": TestCase(CaseType.OPEN, 0.0, "r04_loop_fusion"),
+        "r5": TestCase(CaseType.OPEN, 0.0, "r05_loop_interchange"),
+        "r6": TestCase(CaseType.OPEN, 0.0, "r06_loop_tiling"),
+        "r7": TestCase(CaseType.OPEN, 0.0, "r07_long_source", expects_error=True),
+        "r8": TestCase(CaseType.OPEN, 0.0, "r08_shadowed_unswitching"),
+        "r9": TestCase(CaseType.OPEN, 0.0, "r09_if_conversion_call"),
+        "r10": TestCase(CaseType.OPEN, 0.0, "r10_global_arrays"),
         # Uncomment next line to add a new test case:
         # "my1": TestCase(CaseType.OPEN, 0.0, "my_test_case_1"),
     }
 
-    def __init__(self, executable: Path, io_file_path: Path) -> None:
+    def __init__(self, executable: Path, io_file_path: Path, simulate: bool = False, jit: bool = False, vm: bool = False) -> None:
         self.executable: Path = executable
         self.io_file_path = io_file_path
+        self.simulate: bool = simulate
+        self.jit: bool = jit
+        self.vm: bool = vm
         self.cases_to_run: list[TestCase] = list(self.CASES.values())
         self.diff_result: str = ""
         self.case_dir: Path = DIR / "test_cases"
@@ -161,6 +176,29 @@ class Grader:
         if not case_path.exists():
             return TestStatus.SKIP
 
+        if case.expects_error:
+            # Only compile; the program must be rejected with the expected diagnostics.
+            error_command: List[str] = [str(self.executable), str(case_path), "--save-path", str(self.asm_dir)]
+            error_stdout: bytes
+            error_stderr: bytes
+            _, error_stdout, error_stderr = self.execute_process(error_command)
+            with output_path.open("wb") as file:
+                file.write(error_stdout)
+                file.write(error_stderr)
+            return self.diff_test_case(case, output_path, solution_path)
+
+        if self.simulate or self.jit or self.vm:
+            # Compile and run on the built-in simulator (or natively by the JIT, or by the bytecode interpreter); the output of the program goes to stdout.
+            simulate_command: List[str] = [str(self.executable), str(case_path), "--save-path", str(self.asm_dir), "--jit" if self.jit else "--vm" if self.vm else "--run"]
+            run_stdout: bytes
+            run_stderr: bytes
+            _, run_stdout, run_stderr = self.execute_process(simulate_command, b"123")
+            with compiler_output_path.open("wb") as file:
+                file.write(run_stderr)
+            with output_path.open("wb") as file:
+                file.write(run_stdout)
+            return self.diff_test_case(case, output_path, solution_path)
+
         # Compile to risc-v
         compile_command: List[str] = [str(self.executable), str(case_path), "--save-path", str(self.asm_dir)]
         compile_stdout: bytes
@@ -188,7 +226,10 @@ class Grader:
             file.write(run_stdout)
             file.write(run_stderr)
 
-        # Diff
+        return self.diff_test_case(case, output_path, solution_path)
+
+    def diff_test_case(self, case: TestCase, output_path: Path, solution_path: Path) -> TestStatus:
+        """Outputs the diff between the result and the solution."""
         diff_command: List[str] = ["diff", "-Z", "-u", str(output_path), str(solution_path), f"--label=your output:({output_path})", f"--label=answer:({solution_path})"]
         diff_exit_code: int
         diff_stdout: bytes
@@ -263,9 +304,12 @@ def main() -> int:
     parser.add_argument("--executable", help="executable to grade", type=Path, default=DIR.parent / "src" / "compiler")
     parser.add_argument("--io_file", help="IO file for io function", type=Path, default=DIR.parent / "test" / "io.c")
     parser.add_argument("--case_id", help="test case's ID", type=str)
+    parser.add_argument("--simulate", help="run on the compiler's built-in simulator instead of spike", action="store_true")
+    parser.add_argument("--vm", help="run on the compiler's bytecode interpreter instead of spike", action="store_true")
+    parser.add_argument("--jit", help="run natively with the compiler's x86-64 JIT instead of spike", action="store_true")
     args = parser.parse_args()
 
-    grader = Grader(args.executable, args.io_file)
+    grader = Grader(args.executable, args.io_file, args.simulate, args.jit, args.vm)
     if args.case_id is not None:
         grader.set_case_id_to_run(args.case_id)
     return grader.run()
@@ -0,0 +1,26 @@
+//&S-
+//&T-
+//&D-
+
+redeclared;
+
+// A redeclared name isn't bound to a symbol, so the program must only be
+// diagnosed, not generated.
+var a: integer;
+var a: real;
+
+sum(n: integer): integer
+begin
+    var total: integer;
+    var total: boolean;
+    total := n + a;
+    return total;
+end
+end
+
+begin
+    a := 1;
+    print a;
+    print sum(a);
+end
+end
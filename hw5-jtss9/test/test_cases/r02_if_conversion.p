@@ -0,0 +1,81 @@
+//&S-
+//&T-
+//&D-
+
+ifconversion;
+
+var a: array 5 of integer;
+var i, x, lo, hi, big: integer;
+
+begin
+    for i := 0 to 5 do
+    begin
+        a[i] := i * 10 + 1;
+    end
+    end do
+
+    // An element at a variable index mustn't be read when its guard fails,
+    // even far outside of the array.
+    big := 100000000;
+    if big < 5 then
+    begin
+        x := a[big];
+    end
+    else
+    begin
+        x := -1;
+    end
+    end if
+    print x;
+
+    for i := 3 to 8 do
+    begin
+        if i < 5 then
+        begin
+            x := a[i];
+        end
+        else
+        begin
+            x := 0;
+        end
+        end if
+        print x;
+    end
+    end do
+
+    // Constants, scalars and elements at constant indices are selected
+    // without branches.
+    lo := 4;
+    hi := 9;
+    if lo > hi then
+    begin
+        x := lo;
+    end
+    else
+    begin
+        x := hi;
+    end
+    end if
+    print x;
+    if lo < hi then
+    begin
+        x := a[4];
+    end
+    else
+    begin
+        x := a[0];
+    end
+    end if
+    print x;
+    if lo = hi then
+    begin
+        x := 7;
+    end
+    else
+    begin
+        x := lo;
+    end
+    end if
+    print x;
+end
+end
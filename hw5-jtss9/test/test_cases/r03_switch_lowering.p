@@ -0,0 +1,123 @@
+//&S-
+//&T-
+//&D-
+
+switchlowering;
+
+var i, x: integer;
+
+// The cases are dense, so a jump table picks one.
+dense(n: integer): integer
+begin
+    var r: integer;
+    if n = 1 then
+    begin
+        r := 10;
+    end
+    else
+    begin
+        if n = 2 then
+        begin
+            r := 20;
+        end
+        else
+        begin
+            if n = 3 then
+            begin
+                r := 30;
+            end
+            else
+            begin
+                if n = 5 then
+                begin
+                    r := 50;
+                end
+                else
+                begin
+                    if n = 6 then
+                    begin
+                        r := 60;
+                    end
+                    else
+                    begin
+                        r := 0;
+                    end
+                    end if
+                end
+                end if
+            end
+            end if
+        end
+        end if
+    end
+    end if
+    return r;
+end
+end
+
+// The cases are sparse, so a binary search finds one.
+sparse(n: integer): integer
+begin
+    var r: integer;
+    if n = -1000 then
+    begin
+        r := 1;
+    end
+    else
+    begin
+        if n = 7 then
+        begin
+            r := 2;
+        end
+        else
+        begin
+            if n = 300 then
+            begin
+                r := 3;
+            end
+            else
+            begin
+                if n = 4096 then
+                begin
+                    r := 4;
+                end
+                else
+                begin
+                    if n = 100000 then
+                    begin
+                        r := 5;
+                    end
+                    else
+                    begin
+                        r := 0;
+                    end
+                    end if
+                end
+                end if
+            end
+            end if
+        end
+        end if
+    end
+    end if
+    return r;
+end
+end
+
+begin
+    for i := 0 to 8 do
+    begin
+        print dense(i);
+    end
+    end do
+    print sparse(-1000);
+    print sparse(-999);
+    print sparse(7);
+    print sparse(8);
+    print sparse(300);
+    print sparse(4096);
+    print sparse(100000);
+    print sparse(99999);
+    print sparse(0);
+end
+end
@@ -0,0 +1,49 @@
+//&S-
+//&T-
+//&D-
+
+loopfusion;
+
+var a, b: array 8 of integer;
+var c: array 9 of integer;
+var d: array 8 of integer;
+var i, sum: integer;
+
+begin
+    // The second loop reads what the first one writes in the same
+    // iteration, so the two are fused.
+    for i := 0 to 8 do
+    begin
+        a[i] := i * i;
+    end
+    end do
+    for i := 0 to 8 do
+    begin
+        b[i] := a[i] + 1;
+    end
+    end do
+
+    // The second loop reads what the first one writes an iteration later,
+    // so fusing them would read the elements before they're written.
+    c[8] := 100;
+    for i := 0 to 8 do
+    begin
+        c[i] := i * 3;
+    end
+    end do
+    for i := 0 to 8 do
+    begin
+        d[i] := c[i + 1];
+    end
+    end do
+
+    sum := 0;
+    for i := 0 to 8 do
+    begin
+        print b[i];
+        sum := sum + d[i];
+    end
+    end do
+    print sum;
+end
+end
@@ -0,0 +1,50 @@
+//&S-
+//&T-
+//&D-
+
+loopinterchange;
+
+var m: array 5 of array 5 of integer;
+var i, j, sum: integer;
+
+begin
+    // The inner loop walks down a column, so the two loops are swapped to
+    // walk along the rows.
+    for j := 0 to 5 do
+    begin
+        for i := 0 to 5 do
+        begin
+            m[i][j] := i * 10 + j;
+        end
+        end do
+    end
+    end do
+
+    // Each element depends on the one up and to the right of it, which is
+    // written in an earlier iteration of the outer loop but a later one of
+    // the inner loop; swapping the loops would read it before it's written.
+    for j := 0 to 4 do
+    begin
+        for i := 1 to 5 do
+        begin
+            m[i][j] := m[i - 1][j + 1] + 100;
+        end
+        end do
+    end
+    end do
+
+    sum := 0;
+    for i := 0 to 5 do
+    begin
+        for j := 0 to 5 do
+        begin
+            sum := sum * 3 + m[i][j];
+            sum := sum - sum / 1000000 * 1000000;
+        end
+        end do
+        print m[i][0];
+    end
+    end do
+    print sum;
+end
+end
@@ -0,0 +1,51 @@
+//&S-
+//&T-
+//&D-
+
+looptiling;
+
+// The two arrays take 50400 bytes, more than the cache holds.
+var a: array 90 of array 70 of integer;
+var b: array 70 of array 90 of integer;
+var i, j, sum: integer;
+
+begin
+    for i := 0 to 90 do
+    begin
+        for j := 0 to 70 do
+        begin
+            a[i][j] := i * 100 + j;
+        end
+        end do
+    end
+    end do
+    sum := 0;
+
+    // The transpose walks down the columns of `b`, so it's tiled; the trip
+    // counts aren't multiples of the tile size.
+    for i := 0 to 90 do
+    begin
+        for j := 0 to 70 do
+        begin
+            b[j][i] := a[i][j] + 1;
+        end
+        end do
+    end
+    end do
+
+    for j := 0 to 70 do
+    begin
+        for i := 0 to 90 do
+        begin
+            sum := sum * 7 + b[j][i];
+            sum := sum - sum / 1000003 * 1000003;
+        end
+        end do
+    end
+    end do
+    print b[0][0];
+    print b[69][89];
+    print b[31][47];
+    print sum;
+end
+end
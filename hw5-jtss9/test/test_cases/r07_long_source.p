@@ -0,0 +1,234 @@
+//&S-
+//&T-
+//&D-
+
+longsource;
+
+// The errors are reported past the lines the line index starts out with,
+// so it has to grow to find them.
+
+var total: integer;
+
+begin
+    total := 0;
+    total := total + 0;
+    if total > 0 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 1;
+    total := total + 2;
+    if total > 40 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 3;
+    total := total + 4;
+    if total > 80 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 5;
+    total := total + 6;
+    if total > 120 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 7;
+    total := total + 8;
+    if total > 160 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 9;
+    total := total + 10;
+    if total > 200 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 11;
+    total := total + 12;
+    if total > 240 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 13;
+    total := total + 14;
+    if total > 280 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 15;
+    total := total + 16;
+    if total > 320 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 17;
+    total := total + 18;
+    if total > 360 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 19;
+    total := total + 20;
+    if total > 400 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 21;
+    total := total + 22;
+    if total > 440 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 23;
+    total := total + 24;
+    if total > 480 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 25;
+    total := total + 26;
+    if total > 520 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 27;
+    total := total + 28;
+    if total > 560 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 29;
+    /* A comment over many lines
+       moves the lines after it too.
+ */
+    total := total + 30;
+    if total > 600 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 31;
+    total := total + 32;
+    if total > 640 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 33;
+    total := total + 34;
+    if total > 680 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 35;
+    total := total + 36;
+    if total > 720 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 37;
+    total := total + 38;
+    if total > 760 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 39;
+    total := total + 40;
+    if total > 800 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 41;
+    total := total + 42;
+    if total > 840 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 43;
+    total := total + 44;
+    if total > 880 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 45;
+    total := total + 46;
+    if total > 920 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 47;
+    total := total + 48;
+    if total > 960 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 49;
+    total := total + 50;
+    if total > 1000 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 51;
+    total := total + 52;
+    if total > 1040 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 53;
+    total := total + 54;
+    if total > 1080 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 55;
+    total := total + 56;
+    if total > 1120 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 57;
+    total := total + 58;
+    if total > 1160 then
+    begin
+        total := total - 1;
+    end
+    end if
+    total := total + 59;
+    begin
+        var total: real;
+        var total: boolean;
+        print total;
+    end
+    print total + undeclared;
+end
+end
@@ -0,0 +1,34 @@
+//&S-
+//&T-
+//&D-
+
+shadow;
+
+var flag, i, sum: integer;
+
+begin
+    flag := 1;
+    sum := 0;
+    // The `flag` declared in the loop is another variable, so the one the
+    // condition reads stays the same in every iteration.
+    for i := 0 to 10 do
+    begin
+        begin
+            var flag: integer;
+            flag := i;
+            sum := sum + flag;
+        end
+        if flag = 1 then
+        begin
+            sum := sum + 100;
+        end
+        else
+        begin
+            sum := sum - 1;
+        end
+        end if
+    end
+    end do
+    print sum;
+end
+end
@@ -0,0 +1,43 @@
+//&S-
+//&T-
+//&D-
+
+ifconversioncall;
+
+var a: array 3 of integer;
+var i: integer;
+
+// Moves the element the assignments below store to.
+next(): integer
+begin
+    i := i + 1;
+    return i;
+end
+end
+
+begin
+    i := 0;
+    // The element is the one `i` refers to after the condition is evaluated.
+    if next() > 0 then
+    begin
+        a[i] := 7;
+    end
+    else
+    begin
+        a[i] := 9;
+    end
+    end if
+    if next() < 0 then
+    begin
+        a[i] := 7;
+    end
+    else
+    begin
+        a[i] := 9;
+    end
+    end if
+    print a[0];
+    print a[1];
+    print a[2];
+end
+end
@@ -0,0 +1,59 @@
+//&S-
+//&T-
+//&D-
+
+globalarrays;
+
+var before: integer;
+var m: array 3 of array 4 of integer;
+var v: array 5 of integer;
+var after: integer;
+
+// Reads an array passed from a global the same way as one passed from a
+// local.
+total(a: array 3 of array 4 of integer): integer
+begin
+    var i, j, sum: integer;
+    sum := 0;
+    for i := 0 to 3 do
+    begin
+        for j := 0 to 4 do
+        begin
+            sum := sum + a[i][j];
+        end
+        end do
+    end
+    end do
+    return sum;
+end
+end
+
+begin
+    var i, j: integer;
+    before := 11;
+    after := 22;
+    // Every element has its own word, so writing the last ones leaves the
+    // variables declared around the arrays alone.
+    for i := 0 to 3 do
+    begin
+        for j := 0 to 4 do
+        begin
+            m[i][j] := i * 4 + j;
+        end
+        end do
+    end
+    end do
+    for i := 0 to 5 do
+    begin
+        v[i] := 100 + i;
+    end
+    end do
+    print before;
+    print after;
+    print m[0][0];
+    print m[2][3];
+    print m[1][2];
+    print v[4];
+    print total(m);
+end
+end